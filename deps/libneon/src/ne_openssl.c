@@ -487,7 +487,164 @@ void EVP_PKEY_up_ref(EVP_PKEY *pkey)
 {
     CRYPTO_add(&pkey->references,1,CRYPTO_LOCK_EVP_PKEY);
 }
+static int SSL_SESSION_up_ref(SSL_SESSION *sess)
+{
+    CRYPTO_add(&sess->references,1,CRYPTO_LOCK_SSL_SESSION);
+    return 1;
+}
+#endif
+
+/* With TLS 1.3, the session of a fresh handshake can't be resumed
+ * before the server sends a ticket for it. */
+static int session_resumable(const SSL_SESSION *sess)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    return sess != NULL && SSL_SESSION_is_resumable(sess);
+#else
+    return sess != NULL;
 #endif
+}
+
+#define NE_SSL_SCACHE_SIZE (64)
+
+/* Shared TLS sessions, by scope and server. Once full, the oldest
+ * entry makes room for new ones. */
+struct ne_ssl_session_cache_s {
+    pthread_mutex_t lock;
+    struct {
+        char *key;
+        SSL_SESSION *sess;
+    } entries[NE_SSL_SCACHE_SIZE];
+    unsigned int next; /* next entry to replace */
+};
+
+ne_ssl_session_cache *ne_ssl_session_cache_create(void)
+{
+    ne_ssl_session_cache *cache = ne_calloc(sizeof *cache);
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+void ne_ssl_session_cache_destroy(ne_ssl_session_cache *cache)
+{
+    int n;
+
+    for (n = 0; n < NE_SSL_SCACHE_SIZE; n++) {
+        if (cache->entries[n].key) {
+            ne_free(cache->entries[n].key);
+            SSL_SESSION_free(cache->entries[n].sess);
+        }
+    }
+    pthread_mutex_destroy(&cache->lock);
+    ne_free(cache);
+}
+
+static int scache_find(ne_ssl_session_cache *cache, const char *key)
+{
+    int n;
+
+    for (n = 0; n < NE_SSL_SCACHE_SIZE; n++) {
+        if (cache->entries[n].key && strcmp(cache->entries[n].key, key) == 0)
+            return n;
+    }
+    return -1;
+}
+
+/* Returns a new reference to the cached session, or NULL. */
+static SSL_SESSION *scache_fetch(ne_ssl_session_cache *cache, const char *key)
+{
+    SSL_SESSION *sess = NULL;
+    int n;
+
+    pthread_mutex_lock(&cache->lock);
+    n = scache_find(cache, key);
+    if (n >= 0) {
+        sess = cache->entries[n].sess;
+        SSL_SESSION_up_ref(sess);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return sess;
+}
+
+static void scache_store(ne_ssl_session_cache *cache, const char *key,
+                         SSL_SESSION *sess)
+{
+    int n;
+
+    if (!session_resumable(sess))
+        return;
+
+    SSL_SESSION_up_ref(sess);
+
+    pthread_mutex_lock(&cache->lock);
+    n = scache_find(cache, key);
+    if (n < 0) {
+        n = cache->next++ % NE_SSL_SCACHE_SIZE;
+        if (cache->entries[n].key) {
+            ne_free(cache->entries[n].key);
+            SSL_SESSION_free(cache->entries[n].sess);
+        }
+        cache->entries[n].key = ne_strdup(key);
+    } else {
+        SSL_SESSION_free(cache->entries[n].sess);
+    }
+    cache->entries[n].sess = sess;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static void scache_remove(ne_ssl_session_cache *cache, const char *key)
+{
+    int n;
+
+    pthread_mutex_lock(&cache->lock);
+    n = scache_find(cache, key);
+    if (n >= 0) {
+        ne_free(cache->entries[n].key);
+        SSL_SESSION_free(cache->entries[n].sess);
+        cache->entries[n].key = NULL;
+        cache->entries[n].sess = NULL;
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/* Called by OpenSSL for every new session, which is how TLS 1.3
+ * tickets arriving after the handshake are caught. */
+static int new_session_callback(SSL *ssl, SSL_SESSION *newsess)
+{
+    ne_session *const sess = SSL_get_app_data(ssl);
+    ne_ssl_context *const ctx = sess->ssl_context;
+
+    if (ctx->sess)
+        SSL_SESSION_free(ctx->sess);
+    ctx->sess = newsess; /* keeping the reference */
+
+    if (ctx->scache)
+        scache_store(ctx->scache, ctx->scache_key, newsess);
+
+    return 1;
+}
+
+void ne_ssl_set_session_cache(ne_session *sess, ne_ssl_session_cache *cache,
+                              const char *scope)
+{
+    ne_ssl_context *const ctx = sess->ssl_context;
+    char port[20];
+
+    if (ctx == NULL)
+        return;
+
+    if (ctx->scache_key) {
+        ne_free(ctx->scache_key);
+        ctx->scache_key = NULL;
+    }
+
+    ctx->scache = cache;
+    if (cache) {
+        ne_snprintf(port, sizeof port, "%u", sess->server.port);
+        ctx->scache_key = ne_concat(scope ? scope : "", "|",
+                                    sess->server.hostname, ":", port, NULL);
+    }
+}
 
 /* Duplicate a client certificate, which must be in the decrypted state. */
 static ne_ssl_client_cert *dup_client_cert(const ne_ssl_client_cert *cc)
@@ -600,6 +757,10 @@ ne_ssl_context *ne_ssl_context_create(int mode)
         /* enable workarounds for buggy SSL server implementations */
         SSL_CTX_set_options(ctx->ctx, SSL_OP_ALL);
         SSL_CTX_set_verify(ctx->ctx, SSL_VERIFY_PEER, verify_callback);
+        /* sessions are kept in ctx->sess and the shared cache */
+        SSL_CTX_set_session_cache_mode(ctx->ctx, SSL_SESS_CACHE_CLIENT
+                                       | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx->ctx, new_session_callback);
     } else if (mode == NE_SSL_CTX_SERVER) {
         ctx->ctx = SSL_CTX_new(SSLv23_client_method());
         SSL_CTX_set_session_cache_mode(ctx->ctx, SSL_SESS_CACHE_CLIENT);
@@ -668,6 +829,8 @@ void ne_ssl_context_destroy(ne_ssl_context *ctx)
     SSL_CTX_free(ctx->ctx);
     if (ctx->sess)
         SSL_SESSION_free(ctx->sess);
+    if (ctx->scache_key)
+        ne_free(ctx->scache_key);
     ne_free(ctx);
 }
 
@@ -707,12 +870,24 @@ int ne__negotiate_ssl(ne_session *sess)
     sess->ssl_cc_requested = 0;
     ctx->failures = 0;
 
+    /* resume a TLS session negotiated by another session */
+    if (ctx->scache && !session_resumable(ctx->sess)) {
+        SSL_SESSION *shared = scache_fetch(ctx->scache, ctx->scache_key);
+        if (shared) {
+            if (ctx->sess)
+                SSL_SESSION_free(ctx->sess);
+            ctx->sess = shared;
+        }
+    }
+
     if (ne_sock_connect_ssl(sess->socket, ctx, sess)) {
 	if (ctx->sess) {
 	    /* remove cached session. */
 	    SSL_SESSION_free(ctx->sess);
 	    ctx->sess = NULL;
 	}
+        if (ctx->scache)
+            scache_remove(ctx->scache, ctx->scache_key);
         if (sess->ssl_cc_requested) {
             ne_set_error(sess, _("SSL handshake failed, "
                                  "client certificate was requested: %s"),
@@ -782,6 +957,9 @@ int ne__negotiate_ssl(ne_session *sess)
 	ctx->sess = SSL_get1_session(ssl);
     }
 
+    if (ctx->scache)
+        scache_store(ctx->scache, ctx->scache_key, ctx->sess);
+
     return NE_OK;
 }
 
@@ -42,6 +42,8 @@ struct ne_ssl_context_s {
     const char *hostname; /* for SNI */
     int failures; /* bitmask of exposed failure bits. */
     short added_chain;
+    ne_ssl_session_cache *scache; /* shared TLS sessions, if any */
+    char *scache_key;
 };
 
 typedef SSL *ne_ssl_socket;
@@ -277,6 +277,14 @@ void ne_ssl_trust_default_ca(ne_session *sess);
  * return 0 if success */
 int ne_ssl_truse_add_ca_path(ne_session* sess, const char* path);
 
+/* Resume TLS sessions through the shared 'cache', or stop doing so if
+ * 'cache' is NULL. Only sessions with the same 'scope' resume each
+ * other's TLS sessions: it must tell apart every setting which a
+ * resumed TLS session would bypass, such as the certificate checks
+ * and the client identity. 'cache' must outlive 'sess'. */
+void ne_ssl_set_session_cache(ne_session *sess, ne_ssl_session_cache *cache,
+                              const char *scope);
+
 /* Callback used to load a client certificate on demand.  If dncount
  * is > 0, the 'dnames' array dnames[0] through dnames[dncount-1]
  * gives the list of CA names which the server indicated were
@@ -207,6 +207,19 @@ void ne_ssl_context_set_flag(ne_ssl_context *ctx, int flag, int value);
 /* Destroy an SSL context. */
 void ne_ssl_context_destroy(ne_ssl_context *ctx);
 
+/* Cache of TLS sessions which can be shared between sessions used from
+ * different threads: a new connection resumes the TLS session last
+ * negotiated with the same server, under the same scope, by any of
+ * them, rather than doing a full handshake. See
+ * ne_ssl_set_session_cache. */
+typedef struct ne_ssl_session_cache_s ne_ssl_session_cache;
+
+ne_ssl_session_cache *ne_ssl_session_cache_create(void);
+
+/* Destroy a TLS session cache, which must not be used by any session
+ * any more. */
+void ne_ssl_session_cache_destroy(ne_ssl_session_cache *cache);
+
 NE_END_DECLS
 
 #endif
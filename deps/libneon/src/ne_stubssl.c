@@ -82,6 +82,17 @@ void ne_ssl_clicert_free(ne_ssl_client_cert *ccert) {}
 
 void ne_ssl_trust_default_ca(ne_session *sess) {}
 
+ne_ssl_session_cache *ne_ssl_session_cache_create(void)
+{
+    return NULL;
+}
+
+void ne_ssl_session_cache_destroy(ne_ssl_session_cache *cache) {}
+
+void ne_ssl_set_session_cache(ne_session *sess, ne_ssl_session_cache *cache,
+                              const char *scope)
+{}
+
 ne_ssl_context *ne_ssl_context_create(int mode)
 {
     return NULL;
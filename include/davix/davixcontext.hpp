@@ -45,6 +45,7 @@ struct ContextExplorer;
 class HookList;
 class HttpRequest;
 class DavPosix;
+class RequestParams;
 
 
 
@@ -110,9 +111,59 @@ public:
     /// get session caching status
     bool getSessionCaching() const;
 
-    /// clear both redirect and session cache
+    /// clear both redirect and session cache, the known server capabilities,
+    /// cached file blocks and stat results
     void clearCache();
 
+    /// set the memory budget of the block cache used by DavPosix reads and
+    /// DavFile reads and downloads, shared by all files of this context.
+    /// Disabled (0) by default, unless DAVIX_BLOCK_CACHE_SIZE is set.
+    /// @param bytes budget in bytes, 0 disables the cache
+    void setBlockCacheSize(dav_size_t bytes);
+
+    /// get the memory budget of the block cache
+    dav_size_t getBlockCacheSize() const;
+
+    /// set the directory and size limit of the on-disk block cache, used
+    /// below the in-memory one, and shared by every process of the user
+    /// using the same directory. The directory is created private (0700),
+    /// an existing one owned by another user, or writable by group or
+    /// others, disables the cache. Cached blocks are never served once
+    /// the remote file changes, stale ones are evicted over time.
+    /// Disabled by default, unless DAVIX_DISK_CACHE_DIR is set.
+    /// @param directory cache directory, empty to disable the cache
+    /// @param bytes size limit in bytes
+    void setDiskCache(const std::string & directory, dav_size_t bytes);
+
+    /// get the directory of the on-disk block cache
+    std::string getDiskCacheDirectory() const;
+
+    /// set how long stat results are cached, in seconds, 0 disables the
+    /// cache. Entries are also filled from directory listings, and dropped
+    /// when the resource is modified through this context.
+    /// Disabled by default, unless DAVIX_STAT_CACHE_TTL is set.
+    /// @param ttl time-to-live of stat results
+    /// @param negative_ttl time-to-live of "file not found" results
+    void setStatCacheTTL(int ttl, int negative_ttl);
+
+    /// get the time-to-live of cached stat results, in seconds
+    int getStatCacheTTL() const;
+
+    /// open n connections to the server of uri ahead of a workload, and keep
+    /// them in the session pool, where its first parallel requests find them
+    /// ready, authenticated and past the TLS handshake.
+    /// Each connection is opened by a HEAD request on uri, following
+    /// redirections. The session pool keeps at most 64 idle connections per
+    /// server, for 60 seconds, unless DAVIX_SESSION_POOL_MAX_IDLE_PER_HOST or
+    /// DAVIX_SESSION_POOL_IDLE_TTL say otherwise. Requires session caching
+    /// and keep-alive. Safe to call from an executeRequestAsync callback.
+    /// @param uri resource of the server to connect to
+    /// @param n number of connections
+    /// @param params request options, credentials included, can be NULL
+    /// @param err DavixError error report, set when no connection could be opened
+    /// @return number of connections opened, -1 if none could be
+    int prewarm(const Uri & uri, int n, const RequestParams* params, DavixError** err);
+
 private:
     // internal context
     ContextInternal* _intern;
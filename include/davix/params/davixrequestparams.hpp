@@ -251,6 +251,14 @@ public:
     /// get maximun number of key entries return by S3 list object request
     unsigned long getS3MaxKey() const;
 
+    /// set the number of concurrent requests used to list a bucket in
+    /// S3ListingMode::Flat, each covering a range of the keyspace.
+    /// Entries are still returned in key order. Default: 1, sequential
+    void setS3ListingParallelism(const unsigned int parallelism);
+
+    /// get the number of concurrent requests used for a flat S3 bucket listing
+    unsigned int getS3ListingParallelism() const;
+
     /// add the CA certificate in the directory 'path' as trusted certificate
     void addCertificateAuthorityPath(const std::string & path);
 
@@ -388,6 +396,18 @@ public:
     /// get the keep alive value of this request params
     bool getKeepAlive() const;
 
+    /// use HTTP/2 with the libcurl backend, disabled by default.
+    /// It is negotiated through ALPN on HTTPS connections, plain HTTP
+    /// stays on HTTP/1.1. Concurrent requests to the same endpoint are
+    /// then multiplexed over a single connection.
+    /// Without it, the libcurl backend pins requests to HTTP/1.1, rather
+    /// than leaving the choice to the libcurl default.
+    /// Ignored by the neon backend.
+    void setHttp2(const bool http2_flag);
+
+    /// get the HTTP/2 mode of this request params
+    bool getHttp2() const;
+
 
     /// Add a custom header line that has to be included in the requests
     ///  @param key key of the header
@@ -431,6 +451,70 @@ public:
     /// perform in case it receives 202-Accepted on a GET request
     /// @param delay the delay in seconds
     void setAcceptedRetryDelay(int delay);
+
+    /// get the upload size above which S3 and Swift uploads are split
+    /// into a multi-part upload, 512 MB by default
+    dav_size_t getMultipartUploadThreshold() const;
+
+    /// set the upload size above which S3 and Swift uploads are split
+    /// into a multi-part upload
+    /// @param threshold size in bytes
+    void setMultipartUploadThreshold(dav_size_t threshold);
+
+    /// get the size of each part of a multi-part upload, or of each
+    /// block of an Azure upload, 0 means the protocol default
+    dav_size_t getMultipartUploadPartSize() const;
+
+    /// set the size of each part of a multi-part upload, or of each
+    /// block of an Azure upload, 0 means the protocol default. The size
+    /// may be adjusted to respect the protocol limits on parts
+    /// @param part_size size in bytes
+    void setMultipartUploadPartSize(dav_size_t part_size);
+
+    /// get the maximum number of parts of a multi-part upload
+    /// which are uploaded concurrently, 4 by default
+    unsigned int getMultipartUploadParallelism() const;
+
+    /// set the maximum number of parts of a multi-part upload
+    /// which are uploaded concurrently
+    /// @param nparts number of parts in flight, 1 for sequential uploads
+    void setMultipartUploadParallelism(unsigned int nparts);
+
+    /// get the number of concurrent byte-range streams used when
+    /// downloading a whole object, 1 (single stream) by default
+    unsigned int getSegmentedDownloadStreams() const;
+
+    /// download whole objects as byte-range segments over up to
+    /// nstreams concurrent connections. Only used for objects larger than
+    /// two segments, on servers announcing byte-range support.
+    /// @param nstreams number of streams, 1 disables segmented downloads
+    void setSegmentedDownloadStreams(unsigned int nstreams);
+
+    /// get the size of each segment of a segmented download
+    dav_size_t getSegmentedDownloadSegmentSize() const;
+
+    /// set the size of each segment of a segmented download,
+    /// 64 MB by default
+    /// @param segment_size size in bytes
+    void setSegmentedDownloadSegmentSize(dav_size_t segment_size);
+
+    /// get the maximum number of range requests kept in flight ahead of
+    /// sequential POSIX reads, 8 by default
+    unsigned int getReadAheadMaxInFlight() const;
+
+    /// set the maximum number of range requests kept in flight ahead of
+    /// sequential POSIX reads. The window starts small and grows up to this
+    /// value while it improves throughput.
+    /// @param nrequests number of requests, 0 disables read-ahead
+    void setReadAheadMaxInFlight(unsigned int nrequests);
+
+    /// get the size of each read-ahead range request
+    dav_size_t getReadAheadBlockSize() const;
+
+    /// set the size of each read-ahead range request, 2 MB by default.
+    /// Files no larger than one block are read with a single request.
+    /// @param block_size size in bytes
+    void setReadAheadBlockSize(dav_size_t block_size);
 private:
 
    // dptr
@@ -23,6 +23,8 @@
 #define DAVIX_HTTPREQUEST_H
 
 #include <vector>
+#include <functional>
+#include <future>
 #include <unistd.h>
 #include <utils/davix_types.hpp>
 #include <utils/davix_uri.hpp>
@@ -63,6 +65,13 @@ typedef dav_ssize_t (*HttpBodyProvider)(void *userdata,
 class NEONRequest;
 class HttpCacheToken;
 class ContentProvider;
+class HttpRequest;
+
+/// Completion callback for asynchronous requests
+/// Called once from a background thread when the request is over.
+/// err is NULL on success, otherwise it describes the failure and is
+/// released after the callback returns.
+typedef std::function<void (HttpRequest & req, DavixError* err)> RequestCompletionCallback;
 
 namespace RequestFlag{
     ///
@@ -147,6 +156,31 @@ public:
     /// @snippet example_code_snippets.cpp HttpRequest::executeRequest
     int executeRequest(DavixError** err);
 
+    ///   @brief execute this request completely, in the background
+    ///
+    ///   the request is queued on the I/O executor of its Davix::Context
+    ///   and this call returns immediately; callback is fired once the
+    ///   request is over. The request must not be modified or destroyed
+    ///   before the callback has been invoked.
+    ///
+    ///   @warning each request occupies a thread of the executor until its
+    ///   callback returns, requests are not multiplexed over a single one.
+    ///   A Davix::Context runs at most max(16, 2 x CPU cores) of them at a
+    ///   time, or the number set by the DAVIX_EXECUTOR_THREADS environment
+    ///   variable; more requests wait in queue for a thread to be free.
+    ///   @param callback completion callback
+    ///
+    void executeRequestAsync(const RequestCompletionCallback & callback);
+
+    ///   @brief execute this request completely, in the background
+    ///
+    ///   same as above, with the same limit on concurrent requests; the
+    ///   returned future holds the HTTP status code of the answer, or throws
+    ///   a Davix::DavixException on failure.
+    ///   @return future status code
+    ///
+    std::future<int> executeRequestAsync();
+
     ///
     ///  set the content of the request from a string
     ///  an empty string set no request content
@@ -74,6 +74,11 @@ std::string getStringToSign(const std::string &verb, const Uri &url, const Heade
 Uri signURI(const Credentials& creds, const std::string &verb, const Uri &url, const HeaderVec &headers, const time_t signDuration);
 Uri signURIFixedTimeout(const Credentials& creds, const std::string &verb, const Uri &url, const HeaderVec &headers, const time_t signDuration);
 
+// sign many URLs at once, with the same expiration time, parsing the
+// private key only once
+std::vector<Uri> signURIs(const Credentials& creds, const std::string &verb, const std::vector<Uri> &urls, const HeaderVec &headers, const time_t signDuration);
+std::vector<Uri> signURIsFixedTimeout(const Credentials& creds, const std::string &verb, const std::vector<Uri> &urls, const HeaderVec &headers, const time_t expirationTime);
+
 Uri getListingURI(const Uri & original_url, const RequestParams & params);
 
 std::string extract_bucket(const Uri & uri);
@@ -29,8 +29,14 @@ namespace Davix{
 namespace S3{
 
 Uri signURIv4(const RequestParams & params, const std::string & method, const Uri & url, const HeaderVec headers, const time_t expirationTime);
+// sign as of the given time, instead of now
+Uri signURIv4(const RequestParams & params, const std::string & method, const Uri & url, const HeaderVec headers, const time_t expirationTime, const time_t signingTime);
 Uri signURI(const RequestParams & params, const std::string & method, const Uri & url, HeaderVec headers, const time_t expirationTime);
 
+// sign many URLs at once, with the same timestamp and signing key
+std::vector<Uri> signURIs(const RequestParams & params, const std::string & method, const std::vector<Uri> & urls, const HeaderVec & headers, const time_t expirationTime);
+std::vector<Uri> signURIs(const RequestParams & params, const std::string & method, const std::vector<Uri> & urls, const HeaderVec & headers, const time_t expirationTime, const time_t signingTime);
+
 void signRequest(const RequestParams & params, const std::string & method, const Uri & url, HeaderVec & headers);
 
 Uri tokenizeRequest(const RequestParams & params, const std::string & method, const Uri & url, HeaderVec & headers, time_t expirationTime);
@@ -0,0 +1,290 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "AddressBook.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+namespace Davix {
+
+// weight of the last sample in the smoothed connect time
+static const double kLatencyWeight = 0.3;
+
+// addresses slower to connect to than this factor of the best one, plus
+// some slack for the noise on a local network, are kept for failover
+static const double kLatencyTolerance = 2.0;
+static const double kLatencySlackUs = 1000.0;
+
+// failed addresses are left aside for 1s, doubling up to a minute
+static const std::chrono::seconds kMinBackoff(1);
+static const std::chrono::seconds kMaxBackoff(60);
+
+static const size_t kMaxEndpoints = 1024;
+
+AddressBook::Address::Address(const std::string &a)
+: address(a), ipv6(a.find(':') != std::string::npos), latency(-1), failures(0) {}
+
+bool AddressBook::isActiveByDefault() {
+  return getenv("DAVIX_DISABLE_ADDRESS_BALANCING") == NULL;
+}
+
+std::chrono::seconds AddressBook::getDefaultTTL() {
+  const char* value = getenv("DAVIX_ADDRESS_CACHE_TTL");
+  if(value != NULL) {
+    long ttl = strtol(value, NULL, 10);
+    if(ttl >= 0) {
+      return std::chrono::seconds(ttl);
+    }
+  }
+
+  return std::chrono::seconds(60);
+}
+
+std::vector<std::string> AddressBook::resolveHost(const std::string &host) {
+  std::vector<std::string> out;
+
+  struct addrinfo hints, *res = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_ADDRCONFIG;
+
+  if(getaddrinfo(host.c_str(), NULL, &hints, &res) != 0) {
+    return out;
+  }
+
+  for(struct addrinfo *ai = res; ai != NULL; ai = ai->ai_next) {
+    char buffer[INET6_ADDRSTRLEN];
+    const void *raw = NULL;
+
+    if(ai->ai_family == AF_INET) {
+      raw = &((struct sockaddr_in*) ai->ai_addr)->sin_addr;
+    }
+    else if(ai->ai_family == AF_INET6) {
+      raw = &((struct sockaddr_in6*) ai->ai_addr)->sin6_addr;
+    }
+
+    if(raw != NULL && inet_ntop(ai->ai_family, raw, buffer, sizeof(buffer)) != NULL &&
+       std::find(out.begin(), out.end(), buffer) == out.end()) {
+      out.push_back(buffer);
+    }
+  }
+
+  freeaddrinfo(res);
+  return out;
+}
+
+AddressBook::AddressBook(bool active, std::chrono::seconds ttl, const Resolver &resolver)
+: _active(active), _ttl(ttl), _resolver(resolver) {}
+
+std::string AddressBook::makeKey(const std::string &host, unsigned int port) {
+  std::ostringstream ss;
+  ss << host << ":" << port;
+  return ss.str();
+}
+
+std::vector<std::string> AddressBook::getAddresses(const std::string &host, unsigned int port) {
+  std::vector<std::string> out;
+  if(!_active) {
+    return out;
+  }
+
+  const std::string key = makeKey(host, port);
+  Clock::time_point now = Clock::now();
+  bool known;
+
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    std::map<std::string, Endpoint>::iterator it = _endpoints.find(key);
+    known = (it != _endpoints.end());
+
+    // expired: keep going with the addresses we have, a single refresh at a
+    // time replaces them
+    if(known && it->second.expiry <= now && !it->second.refreshing) {
+      it->second.refreshing = true;
+
+      std::vector<std::future<void> >::iterator done = std::remove_if(_refreshes.begin(), _refreshes.end(),
+        [](const std::future<void> &f) { return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+      _refreshes.erase(done, _refreshes.end());
+
+      _refreshes.push_back(std::async(std::launch::async, [this, key, host]() {
+        std::vector<std::string> resolved = _resolver(host);
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        update(key, resolved, Clock::now());
+      }));
+    }
+  }
+
+  if(!known) {
+    // no lock held while resolving, which may take a while
+    std::vector<std::string> resolved = _resolver(host);
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    update(key, resolved, now);
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  std::map<std::string, Endpoint>::iterator it = _endpoints.find(key);
+  if(it == _endpoints.end() || it->second.addresses.size() < 2) {
+    return out;
+  }
+
+  Endpoint &endpoint = it->second;
+  const std::vector<Address> &addresses = endpoint.addresses;
+
+  double best = -1;
+  for(size_t i = 0; i < addresses.size(); i++) {
+    if(addresses[i].retryAfter <= now && addresses[i].latency >= 0 && (best < 0 || addresses[i].latency < best)) {
+      best = addresses[i].latency;
+    }
+  }
+
+  // healthy addresses with a connect time close to the best one, or not
+  // measured yet, take turns as first choice
+  std::vector<size_t> candidates, healthy, failed;
+  for(size_t i = 0; i < addresses.size(); i++) {
+    if(addresses[i].retryAfter > now) {
+      failed.push_back(i);
+    }
+    else {
+      healthy.push_back(i);
+      if(best < 0 || addresses[i].latency < 0 || addresses[i].latency <= best * kLatencyTolerance + kLatencySlackUs) {
+        candidates.push_back(i);
+      }
+    }
+  }
+
+  std::stable_sort(healthy.begin(), healthy.end(), [&addresses](size_t a, size_t b) {
+    return std::max(0.0, addresses[a].latency) < std::max(0.0, addresses[b].latency);
+  });
+  std::stable_sort(failed.begin(), failed.end(), [&addresses](size_t a, size_t b) {
+    return addresses[a].retryAfter < addresses[b].retryAfter;
+  });
+
+  std::vector<size_t> order(healthy);
+  order.insert(order.end(), failed.begin(), failed.end());
+
+  size_t first = order[0];
+  if(!candidates.empty()) {
+    first = candidates[endpoint.next++ % candidates.size()];
+  }
+
+  // then alternate address families, so that failing over to the next
+  // address also gets around a broken IPv6 or IPv4 route quickly
+  std::vector<size_t> same, other;
+  for(size_t i = 0; i < order.size(); i++) {
+    if(order[i] != first) {
+      (addresses[order[i]].ipv6 == addresses[first].ipv6 ? same : other).push_back(order[i]);
+    }
+  }
+
+  out.push_back(addresses[first].address);
+  for(size_t i = 0; i < std::max(same.size(), other.size()); i++) {
+    if(i < other.size()) {
+      out.push_back(addresses[other[i]].address);
+    }
+    if(i < same.size()) {
+      out.push_back(addresses[same[i]].address);
+    }
+  }
+
+  return out;
+}
+
+void AddressBook::update(const std::string &key, const std::vector<std::string> &resolved, Clock::time_point now) {
+  if(_endpoints.find(key) == _endpoints.end() && _endpoints.size() >= kMaxEndpoints) {
+    _endpoints.erase(_endpoints.begin());
+  }
+
+  Endpoint &endpoint = _endpoints[key];
+  std::vector<Address> addresses;
+  for(size_t i = 0; i < resolved.size(); i++) {
+    Address address(resolved[i]);
+    for(size_t j = 0; j < endpoint.addresses.size(); j++) {
+      if(endpoint.addresses[j].address == resolved[i]) {
+        address = endpoint.addresses[j];
+      }
+    }
+    addresses.push_back(address);
+  }
+
+  endpoint.addresses.swap(addresses);
+  endpoint.expiry = now + _ttl;
+  endpoint.refreshing = false;
+}
+
+AddressBook::Address* AddressBook::lookup(const std::string &host, unsigned int port, const std::string &address) {
+  std::map<std::string, Endpoint>::iterator it = _endpoints.find(makeKey(host, port));
+  if(it == _endpoints.end()) {
+    return NULL;
+  }
+
+  for(size_t i = 0; i < it->second.addresses.size(); i++) {
+    if(it->second.addresses[i].address == address) {
+      return &it->second.addresses[i];
+    }
+  }
+
+  return NULL;
+}
+
+void AddressBook::reportSuccess(const std::string &host, unsigned int port, const std::string &address,
+  std::chrono::microseconds connectTime) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  Address *entry = lookup(host, port, address);
+  if(entry == NULL) {
+    return;
+  }
+
+  const double sample = connectTime.count();
+  entry->latency = (entry->latency < 0) ? sample : (1 - kLatencyWeight) * entry->latency + kLatencyWeight * sample;
+  entry->failures = 0;
+  entry->retryAfter = Clock::time_point();
+}
+
+void AddressBook::reportFailure(const std::string &host, unsigned int port, const std::string &address) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  Address *entry = lookup(host, port, address);
+  if(entry == NULL) {
+    return;
+  }
+
+  std::chrono::seconds backoff = kMinBackoff * (1 << std::min(entry->failures, 6u));
+  entry->failures++;
+  entry->retryAfter = Clock::now() + std::min(backoff, kMaxBackoff);
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_SOCKET, "Connection to {} ({}:{}) failed, left aside for {}s",
+    address, host, port, std::min(backoff, kMaxBackoff).count());
+}
+
+void AddressBook::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _endpoints.clear();
+}
+
+}
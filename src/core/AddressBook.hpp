@@ -0,0 +1,143 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_ADDRESS_BOOK_HPP
+#define DAVIX_CORE_ADDRESS_BOOK_HPP
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Network addresses of the servers a session factory connects to, along with
+// how well connecting to each of them has been going.
+//
+// Front-ends publishing several A / AAAA records get new connections spread
+// over their addresses, instead of all of them going to whichever address
+// the resolver returns first. Addresses much slower to connect to than the
+// best one are only used for failover, and addresses which failed are left
+// aside for a while, longer after each failure.
+//------------------------------------------------------------------------------
+class AddressBook {
+public:
+  typedef std::function<std::vector<std::string>(const std::string &host)> Resolver;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  AddressBook(bool active, std::chrono::seconds ttl, const Resolver &resolver = &resolveHost);
+
+  //----------------------------------------------------------------------------
+  // Numeric addresses of host, in the order a new connection should try
+  // them: the first one for load balancing, then alternating between IPv6
+  // and IPv4, healthy addresses first. Empty if host has a single address,
+  // can't be resolved, or the address book is inactive.
+  //
+  // Only a host never seen before is resolved by the caller. Once the
+  // addresses of a host expire, they keep being used while they are resolved
+  // again in the background.
+  //----------------------------------------------------------------------------
+  std::vector<std::string> getAddresses(const std::string &host, unsigned int port);
+
+  //----------------------------------------------------------------------------
+  // Record a connection established to address, and the time it took
+  //----------------------------------------------------------------------------
+  void reportSuccess(const std::string &host, unsigned int port, const std::string &address,
+    std::chrono::microseconds connectTime);
+
+  //----------------------------------------------------------------------------
+  // Record a failed connection attempt to address
+  //----------------------------------------------------------------------------
+  void reportFailure(const std::string &host, unsigned int port, const std::string &address);
+
+  //----------------------------------------------------------------------------
+  // Forget everything
+  //----------------------------------------------------------------------------
+  void clear();
+
+  //----------------------------------------------------------------------------
+  // Resolve all the addresses of host through getaddrinfo
+  //----------------------------------------------------------------------------
+  static std::vector<std::string> resolveHost(const std::string &host);
+
+  //----------------------------------------------------------------------------
+  // Whether balancing is active by default, it can be turned off through
+  // DAVIX_DISABLE_ADDRESS_BALANCING
+  //----------------------------------------------------------------------------
+  static bool isActiveByDefault();
+
+  //----------------------------------------------------------------------------
+  // How long resolved addresses are kept, overridable through
+  // DAVIX_ADDRESS_CACHE_TTL (in seconds)
+  //----------------------------------------------------------------------------
+  static std::chrono::seconds getDefaultTTL();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Address {
+    Address(const std::string &a);
+
+    std::string address;
+    bool ipv6;
+    double latency; // smoothed connect time in microseconds, negative if unknown
+    unsigned int failures; // consecutive ones
+    Clock::time_point retryAfter;
+  };
+
+  struct Endpoint {
+    Endpoint() : next(0), refreshing(false) {}
+
+    std::vector<Address> addresses;
+    Clock::time_point expiry;
+    size_t next; // round-robin position
+    bool refreshing;
+  };
+
+  bool _active;
+  std::chrono::seconds _ttl;
+  Resolver _resolver;
+
+  std::mutex _mtx;
+  std::map<std::string, Endpoint> _endpoints;
+
+  // background resolutions, which use everything above: destroyed first,
+  // waits for them
+  std::vector<std::future<void> > _refreshes;
+
+  static std::string makeKey(const std::string &host, unsigned int port);
+
+  // store the resolved addresses of an endpoint, keeping what is known about
+  // those still there, lock must be held
+  void update(const std::string &key, const std::vector<std::string> &resolved, Clock::time_point now);
+
+  // find the address of an endpoint, lock must be held
+  Address* lookup(const std::string &host, unsigned int port, const std::string &address);
+};
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "BlockCache.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <cstdlib>
+
+namespace Davix {
+
+static dav_size_t getEnvSize(const char* name, dav_size_t defaultValue) {
+  const char* value = getenv(name);
+  if(value != NULL) {
+    char* end = NULL;
+    unsigned long long size = strtoull(value, &end, 10);
+    if(end != value) {
+      return size;
+    }
+  }
+
+  return defaultValue;
+}
+
+dav_size_t BlockCache::getDefaultBudget() {
+  return getEnvSize("DAVIX_BLOCK_CACHE_SIZE", 0);
+}
+
+dav_size_t BlockCache::getDefaultBlockSize() {
+  return std::max<dav_size_t>(1, getEnvSize("DAVIX_BLOCK_CACHE_BLOCK_SIZE", 256 * 1024));
+}
+
+BlockCache::BlockCache(dav_size_t budget, dav_size_t blockSize)
+: _budget(budget), _block_size(std::max<dav_size_t>(1, blockSize)), _usage(0), _next_id(0) {}
+
+BlockCache::Block BlockCache::get(const std::string &key, const Loader &loader) {
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  if(_budget == 0) {
+    _stats.misses++;
+    lock.unlock();
+    return loader();
+  }
+
+  std::map<std::string, Entry>::iterator it = _entries.find(key);
+  if(it != _entries.end()) {
+    if(it->second.loading) {
+      _stats.coalesced++;
+    }
+    else {
+      _stats.hits++;
+    }
+
+    _lru.splice(_lru.begin(), _lru, it->second.lru);
+    std::shared_future<Block> block = it->second.block;
+    lock.unlock();
+    return block.get();
+  }
+
+  _stats.misses++;
+
+  std::promise<Block> promise;
+  _lru.push_front(key);
+
+  Entry &entry = _entries[key];
+  entry.block = promise.get_future().share();
+  entry.size = 0;
+  entry.loading = true;
+  entry.id = _next_id++;
+  entry.lru = _lru.begin();
+
+  const size_t id = entry.id;
+  lock.unlock();
+
+  Block block;
+  try {
+    block = loader();
+  }
+  catch(...) {
+    lock.lock();
+    it = _entries.find(key);
+    if(it != _entries.end() && it->second.id == id) {
+      erase(it);
+    }
+    lock.unlock();
+
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  lock.lock();
+  it = _entries.find(key);
+
+  // might have been invalidated in the meantime, don't resurrect it
+  if(it != _entries.end() && it->second.id == id) {
+    it->second.loading = false;
+    it->second.size = block->size();
+    _usage += block->size();
+    evict();
+  }
+  lock.unlock();
+
+  promise.set_value(block);
+  return block;
+}
+
+void BlockCache::erase(std::map<std::string, Entry>::iterator it) {
+  _usage -= it->second.size;
+  _lru.erase(it->second.lru);
+  _entries.erase(it);
+}
+
+void BlockCache::evict() {
+  std::list<std::string>::iterator it = _lru.end();
+  while(_usage > _budget && it != _lru.begin()) {
+    --it;
+
+    std::map<std::string, Entry>::iterator entry = _entries.find(*it);
+    if(entry->second.loading) {
+      continue;
+    }
+
+    // erase() invalidates it, step forward first
+    std::list<std::string>::iterator next = it;
+    ++next;
+    erase(entry);
+    _stats.evictions++;
+    it = next;
+  }
+}
+
+bool BlockCache::containsPrefix(const std::string &prefix) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  std::map<std::string, Entry>::iterator it = _entries.lower_bound(prefix);
+  return it != _entries.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+}
+
+void BlockCache::invalidatePrefix(const std::string &prefix) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  std::map<std::string, Entry>::iterator it = _entries.lower_bound(prefix);
+  while(it != _entries.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+    std::map<std::string, Entry>::iterator next = it;
+    ++next;
+    erase(it);
+    it = next;
+  }
+}
+
+void BlockCache::setBudget(dav_size_t budget) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _budget = budget;
+  evict();
+}
+
+dav_size_t BlockCache::getBudget() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _budget;
+}
+
+bool BlockCache::isEnabled() {
+  return getBudget() > 0;
+}
+
+dav_size_t BlockCache::getBlockSize() const {
+  return _block_size;
+}
+
+dav_size_t BlockCache::getUsage() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _usage;
+}
+
+BlockCache::Stats BlockCache::getStats() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _stats;
+}
+
+}
@@ -0,0 +1,138 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_BLOCK_CACHE_HPP
+#define DAVIX_CORE_BLOCK_CACHE_HPP
+
+#include <utils/davix_types.hpp>
+
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// In-memory cache of fixed-size file blocks, owned by a Context and shared
+// by all of its file descriptors, within a global memory budget. Least
+// recently used blocks are evicted first.
+//
+// Concurrent misses on the same block are coalesced: only the first one
+// loads it, the others wait for the result.
+//------------------------------------------------------------------------------
+class BlockCache {
+public:
+  typedef std::shared_ptr<const std::vector<char> > Block;
+  typedef std::function<Block ()> Loader;
+
+  struct Stats {
+    Stats() : hits(0), misses(0), coalesced(0), evictions(0) {}
+
+    size_t hits;
+    size_t misses;
+    size_t coalesced;
+    size_t evictions;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor, a zero budget disables the cache
+  //----------------------------------------------------------------------------
+  BlockCache(dav_size_t budget, dav_size_t blockSize);
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  BlockCache(const BlockCache& other) = delete;
+  BlockCache& operator=(const BlockCache& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Return the block stored under key, calling loader on a miss. Exceptions
+  // thrown by the loader are propagated to every waiting caller, and
+  // nothing is cached.
+  //----------------------------------------------------------------------------
+  Block get(const std::string &key, const Loader &loader);
+
+  //----------------------------------------------------------------------------
+  // Whether any block is cached under a key starting with prefix
+  //----------------------------------------------------------------------------
+  bool containsPrefix(const std::string &prefix);
+
+  //----------------------------------------------------------------------------
+  // Drop every block cached under a key starting with prefix
+  //----------------------------------------------------------------------------
+  void invalidatePrefix(const std::string &prefix);
+
+  //----------------------------------------------------------------------------
+  // Change the memory budget, evicting blocks as needed
+  //----------------------------------------------------------------------------
+  void setBudget(dav_size_t budget);
+  dav_size_t getBudget();
+
+  bool isEnabled();
+  dav_size_t getBlockSize() const;
+
+  //----------------------------------------------------------------------------
+  // Bytes currently cached
+  //----------------------------------------------------------------------------
+  dav_size_t getUsage();
+
+  Stats getStats();
+
+  //----------------------------------------------------------------------------
+  // Defaults, overridable through DAVIX_BLOCK_CACHE_SIZE and
+  // DAVIX_BLOCK_CACHE_BLOCK_SIZE (in bytes)
+  //----------------------------------------------------------------------------
+  static dav_size_t getDefaultBudget();
+  static dav_size_t getDefaultBlockSize();
+
+private:
+  struct Entry {
+    std::shared_future<Block> block;
+    dav_size_t size;
+    bool loading;
+    size_t id;
+    std::list<std::string>::iterator lru;
+  };
+
+  std::mutex _mtx;
+  std::map<std::string, Entry> _entries;
+  std::list<std::string> _lru; // most recent first
+  dav_size_t _budget;
+  dav_size_t _block_size;
+  dav_size_t _usage;
+  size_t _next_id;
+  Stats _stats;
+
+  // evict least recently used blocks until under budget, lock must be held
+  void evict();
+
+  // lock must be held
+  void erase(std::map<std::string, Entry>::iterator it);
+};
+
+}
+
+#endif
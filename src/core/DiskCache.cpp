@@ -0,0 +1,483 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "DiskCache.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Davix {
+
+namespace {
+
+const uint64_t kIndexMagic = 0x5844495641444944ULL;
+const uint32_t kIndexVersion = 1;
+const uint32_t kIndexSlots = 65536;
+const uint32_t kIndexWays = 16;
+
+const uint32_t kBlockMagic = 0x4b4c4244;
+
+std::atomic<unsigned> tmpCounter(0);
+
+// temporary files of a store cut short, by a crash say, once this old
+const time_t kStaleTmpSeconds = 3600;
+
+}
+
+struct DiskCache::IndexHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t slots;
+  uint64_t clock; // bumped on every access, for LRU
+  uint64_t usage; // bytes used by the block files
+};
+
+struct DiskCache::IndexSlot {
+  uint64_t hash; // 0 when free
+  uint64_t size;
+  uint64_t stamp;
+};
+
+//------------------------------------------------------------------------------
+// Exclusive lock on the index, against other processes. Threads of this
+// process are serialized by _mtx already.
+//------------------------------------------------------------------------------
+class DiskCache::IndexLock {
+public:
+  IndexLock(int fd) : _fd(fd) {
+    while(flock(_fd, LOCK_EX) != 0 && errno == EINTR) {}
+  }
+
+  ~IndexLock() {
+    flock(_fd, LOCK_UN);
+  }
+
+private:
+  int _fd;
+};
+
+// FNV-1a, stable across processes and builds
+static uint64_t hashKey(const std::string &key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for(size_t i = 0; i < key.size(); i++) {
+    hash ^= (unsigned char) key[i];
+    hash *= 1099511628211ULL;
+  }
+  return (hash == 0) ? 1 : hash;
+}
+
+static bool readFull(int fd, void* buf, size_t size, off_t offset) {
+  size_t done = 0;
+  while(done < size) {
+    ssize_t ret = ::pread(fd, (char*) buf + done, size - done, offset + done);
+    if(ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if(ret <= 0) {
+      return false;
+    }
+    done += ret;
+  }
+  return true;
+}
+
+static bool writeFull(int fd, const void* buf, size_t size) {
+  size_t done = 0;
+  while(done < size) {
+    ssize_t ret = ::write(fd, (const char*) buf + done, size - done);
+    if(ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if(ret <= 0) {
+      return false;
+    }
+    done += ret;
+  }
+  return true;
+}
+
+std::string DiskCache::getDefaultDirectory() {
+  const char* value = getenv("DAVIX_DISK_CACHE_DIR");
+  return (value != NULL) ? value : "";
+}
+
+dav_size_t DiskCache::getDefaultBudget() {
+  const char* value = getenv("DAVIX_DISK_CACHE_SIZE");
+  if(value != NULL) {
+    char* end = NULL;
+    unsigned long long size = strtoull(value, &end, 10);
+    if(end != value) {
+      return size;
+    }
+  }
+
+  return 1024ULL * 1024 * 1024;
+}
+
+DiskCache::DiskCache(const std::string &directory, dav_size_t budget)
+: _directory(directory), _budget(budget), _fd(-1), _map(NULL), _header(NULL), _slots(NULL) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  open();
+}
+
+DiskCache::~DiskCache() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  close();
+}
+
+void DiskCache::configure(const std::string &directory, dav_size_t budget) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  close();
+  _directory = directory;
+  _budget = budget;
+  open();
+}
+
+bool DiskCache::open() {
+  if(_directory.empty() || _budget == 0) {
+    return false;
+  }
+
+  // blocks hold request URIs, signatures included, and possibly
+  // authenticated content: keep them private to the user
+  if(mkdir(_directory.c_str(), 0700) != 0 && errno != EEXIST) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CORE, "Unable to create disk cache directory {}: {}", _directory, strerror(errno));
+    return false;
+  }
+
+  struct stat dir_st;
+  if(lstat(_directory.c_str(), &dir_st) != 0 || !S_ISDIR(dir_st.st_mode)) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CORE, "Disk cache directory {} is not a directory, cache disabled", _directory);
+    return false;
+  }
+
+  if(dir_st.st_uid != geteuid() || (dir_st.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CORE, "Disk cache directory {} is not owned by the current user, or is writable by others, cache disabled", _directory);
+    return false;
+  }
+
+  if((dir_st.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CORE, "Disk cache directory {} is readable by other users", _directory);
+  }
+
+  const std::string path = _directory + "/index";
+  _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+  if(_fd < 0) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CORE, "Unable to open disk cache index {}: {}", path, strerror(errno));
+    return false;
+  }
+
+  // an index left behind by an older release may still be world-readable
+  fchmod(_fd, 0600);
+
+  const size_t size = sizeof(IndexHeader) + kIndexSlots * sizeof(IndexSlot);
+  bool reset = false;
+  {
+    IndexLock lock(_fd);
+
+    struct stat st;
+    if(fstat(_fd, &st) == 0 && (size_t) st.st_size != size) {
+      reset = (ftruncate(_fd, size) == 0);
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if(map != MAP_FAILED) {
+      _map = map;
+      _header = static_cast<IndexHeader*>(map);
+      _slots = reinterpret_cast<IndexSlot*>(_header + 1);
+
+      if(reset || _header->magic != kIndexMagic || _header->version != kIndexVersion || _header->slots != kIndexSlots) {
+        // new or incompatible index, blocks it referenced are unaccounted for
+        removeFiles(true);
+
+        memset(map, 0, size);
+        _header->magic = kIndexMagic;
+        _header->version = kIndexVersion;
+        _header->slots = kIndexSlots;
+      }
+      else {
+        removeFiles(false);
+      }
+    }
+  }
+
+  if(_map == NULL) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CORE, "Unable to map disk cache index {}: {}", path, strerror(errno));
+    close();
+    return false;
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CORE, "Disk cache in {}, {} bytes in use", _directory, _header->usage);
+  return true;
+}
+
+// Remove the temporary files of stores which never completed, and with
+// blocks, every block file
+void DiskCache::removeFiles(bool blocks) {
+  DIR* dir = opendir(_directory.c_str());
+  if(dir == NULL) {
+    return;
+  }
+
+  const time_t now = time(NULL);
+  struct dirent* entry;
+  while((entry = readdir(dir)) != NULL) {
+    const std::string path = _directory + "/" + entry->d_name;
+    const size_t len = strlen(entry->d_name);
+
+    // recent temporary files may still be written to
+    struct stat st;
+    if(strstr(entry->d_name, ".blk.tmp.") != NULL) {
+      if(blocks || (lstat(path.c_str(), &st) == 0 && st.st_mtime + kStaleTmpSeconds < now)) {
+        unlink(path.c_str());
+      }
+    }
+    else if(blocks && len > 4 && strcmp(entry->d_name + len - 4, ".blk") == 0) {
+      unlink(path.c_str());
+    }
+  }
+
+  closedir(dir);
+}
+
+void DiskCache::close() {
+  if(_map != NULL) {
+    munmap(_map, sizeof(IndexHeader) + kIndexSlots * sizeof(IndexSlot));
+  }
+
+  if(_fd >= 0) {
+    ::close(_fd);
+  }
+
+  _fd = -1;
+  _map = NULL;
+  _header = NULL;
+  _slots = NULL;
+}
+
+bool DiskCache::isEnabled() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _map != NULL;
+}
+
+std::string DiskCache::getDirectory() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _directory;
+}
+
+dav_size_t DiskCache::getBudget() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _budget;
+}
+
+dav_size_t DiskCache::getUsage() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_map == NULL) {
+    return 0;
+  }
+
+  IndexLock flock(_fd);
+  return _header->usage;
+}
+
+std::string DiskCache::blockPath(const std::string &directory, uint64_t hash) {
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.blk", (unsigned long long) hash);
+  return directory + name;
+}
+
+DiskCache::IndexSlot* DiskCache::getSet(uint64_t hash) {
+  return _slots + (hash % (kIndexSlots / kIndexWays)) * kIndexWays;
+}
+
+DiskCache::IndexSlot* DiskCache::findSlot(uint64_t hash) {
+  IndexSlot* set = getSet(hash);
+  for(uint32_t i = 0; i < kIndexWays; i++) {
+    if(set[i].hash == hash) {
+      return set + i;
+    }
+  }
+  return NULL;
+}
+
+void DiskCache::evictSlot(IndexSlot* slot) {
+  unlink(blockPath(_directory, slot->hash).c_str());
+  _header->usage -= std::min<uint64_t>(_header->usage, slot->size);
+  memset(slot, 0, sizeof(IndexSlot));
+}
+
+void DiskCache::evict() {
+  if(_header->usage <= _budget) {
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, uint32_t> > used;
+  for(uint32_t i = 0; i < kIndexSlots; i++) {
+    if(_slots[i].hash != 0) {
+      used.push_back(std::make_pair(_slots[i].stamp, i));
+    }
+  }
+  std::sort(used.begin(), used.end());
+
+  // go a bit below budget, so the next stores don't all scan the index
+  const uint64_t target = _budget - _budget / 10;
+  for(size_t i = 0; i < used.size() && _header->usage > target; i++) {
+    evictSlot(_slots + used[i].second);
+  }
+}
+
+BlockCache::Block DiskCache::load(const std::string &key) {
+  const uint64_t hash = hashKey(key);
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if(_map == NULL) {
+      return BlockCache::Block();
+    }
+    path = blockPath(_directory, hash);
+  }
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+  if(fd < 0) {
+    return BlockCache::Block();
+  }
+
+  // magic, key size, key, then the block itself
+  std::shared_ptr<std::vector<char> > block;
+  uint32_t header[2];
+  struct stat st;
+  std::string stored_key;
+
+  if(fstat(fd, &st) == 0 && readFull(fd, header, sizeof(header), 0) && header[0] == kBlockMagic &&
+     (off_t) (sizeof(header) + header[1]) <= st.st_size) {
+    stored_key.resize(header[1]);
+    const off_t data_offset = sizeof(header) + header[1];
+
+    if(readFull(fd, &stored_key[0], stored_key.size(), sizeof(header)) && stored_key == key) {
+      block.reset(new std::vector<char>(st.st_size - data_offset));
+      if(!readFull(fd, block->data(), block->size(), data_offset)) {
+        block.reset();
+      }
+    }
+  }
+  ::close(fd);
+
+  if(!block) {
+    return BlockCache::Block();
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_map != NULL) {
+    IndexLock flock(_fd);
+    IndexSlot* slot = findSlot(hash);
+    if(slot != NULL) {
+      slot->stamp = ++_header->clock;
+    }
+  }
+
+  return block;
+}
+
+void DiskCache::store(const std::string &key, const std::vector<char> &block) {
+  const uint64_t hash = hashKey(key);
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if(_map == NULL || block.size() > _budget) {
+      return;
+    }
+    directory = _directory;
+  }
+
+  // write aside, then publish with an atomic rename
+  char suffix[64];
+  snprintf(suffix, sizeof(suffix), ".tmp.%d.%u", (int) getpid(), tmpCounter++);
+  const std::string tmp = blockPath(directory, hash) + suffix;
+
+  int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if(fd < 0) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CORE, "Unable to create {}: {}", tmp, strerror(errno));
+    return;
+  }
+
+  const uint32_t header[2] = { kBlockMagic, (uint32_t) key.size() };
+  const bool written = writeFull(fd, header, sizeof(header)) && writeFull(fd, key.data(), key.size()) &&
+                       writeFull(fd, block.data(), block.size());
+
+  if(::close(fd) != 0 || !written) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CORE, "Unable to write {}", tmp);
+    unlink(tmp.c_str());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_map == NULL || _directory != directory) {
+    unlink(tmp.c_str());
+    return;
+  }
+
+  IndexLock flock(_fd);
+  if(rename(tmp.c_str(), blockPath(directory, hash).c_str()) != 0) {
+    unlink(tmp.c_str());
+    return;
+  }
+
+  IndexSlot* slot = findSlot(hash);
+  if(slot != NULL) {
+    _header->usage -= std::min<uint64_t>(_header->usage, slot->size);
+  }
+  else {
+    // a free slot of the set, or else its least recently used one
+    IndexSlot* set = getSet(hash);
+    slot = set;
+    for(uint32_t i = 1; i < kIndexWays && slot->hash != 0; i++) {
+      if(set[i].hash == 0 || set[i].stamp < slot->stamp) {
+        slot = set + i;
+      }
+    }
+
+    if(slot->hash != 0) {
+      evictSlot(slot);
+    }
+  }
+
+  slot->hash = hash;
+  slot->size = sizeof(header) + key.size() + block.size();
+  slot->stamp = ++_header->clock;
+  _header->usage += slot->size;
+
+  evict();
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_DISK_CACHE_HPP
+#define DAVIX_CORE_DISK_CACHE_HPP
+
+#include <core/BlockCache.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// On-disk block cache, shared by every process of the same user using the
+// same directory. The directory and its files are private to that user, a
+// directory owned by someone else, or writable by others, is refused.
+//
+// Each block lives in its own file, named after the hash of its key, and
+// is published with an atomic rename. A fixed-size index, mmap-ed by all
+// processes and guarded by flock, tracks sizes and access times: it is
+// set-associative, and least recently used blocks are evicted once the
+// directory goes over budget.
+//------------------------------------------------------------------------------
+class DiskCache {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor, an empty directory or a zero budget disables the cache
+  //----------------------------------------------------------------------------
+  DiskCache(const std::string &directory, dav_size_t budget);
+  ~DiskCache();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  DiskCache(const DiskCache& other) = delete;
+  DiskCache& operator=(const DiskCache& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Switch to another directory and budget
+  //----------------------------------------------------------------------------
+  void configure(const std::string &directory, dav_size_t budget);
+
+  bool isEnabled();
+  std::string getDirectory();
+  dav_size_t getBudget();
+
+  //----------------------------------------------------------------------------
+  // Return the block stored under key, or an empty pointer
+  //----------------------------------------------------------------------------
+  BlockCache::Block load(const std::string &key);
+
+  //----------------------------------------------------------------------------
+  // Store a block under key, evicting blocks as needed. Best effort:
+  // failures are logged, and ignored.
+  //----------------------------------------------------------------------------
+  void store(const std::string &key, const std::vector<char> &block);
+
+  //----------------------------------------------------------------------------
+  // Bytes currently cached in the directory, by all processes
+  //----------------------------------------------------------------------------
+  dav_size_t getUsage();
+
+  //----------------------------------------------------------------------------
+  // Defaults, overridable through DAVIX_DISK_CACHE_DIR and
+  // DAVIX_DISK_CACHE_SIZE (in bytes)
+  //----------------------------------------------------------------------------
+  static std::string getDefaultDirectory();
+  static dav_size_t getDefaultBudget();
+
+private:
+  struct IndexHeader;
+  struct IndexSlot;
+  class IndexLock;
+
+  std::mutex _mtx;
+  std::string _directory;
+  dav_size_t _budget;
+  int _fd;
+  void* _map;
+  IndexHeader* _header;
+  IndexSlot* _slots;
+
+  // lock must be held
+  bool open();
+  void close();
+  void removeFiles(bool blocks);
+  IndexSlot* getSet(uint64_t hash);
+  IndexSlot* findSlot(uint64_t hash);
+  void evictSlot(IndexSlot* slot);
+  void evict();
+
+  static std::string blockPath(const std::string &directory, uint64_t hash);
+};
+
+}
+
+#endif
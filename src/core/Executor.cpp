@@ -0,0 +1,121 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "Executor.hpp"
+#include <utils/davix_logger_internal.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Default pool size, overridable through DAVIX_EXECUTOR_THREADS
+//------------------------------------------------------------------------------
+size_t Executor::getDefaultMaxThreads() {
+  const char* value = getenv("DAVIX_EXECUTOR_THREADS");
+  if(value != NULL) {
+    long nthreads = strtol(value, NULL, 10);
+    if(nthreads > 0) {
+      return nthreads;
+    }
+  }
+
+  size_t ncores = std::thread::hardware_concurrency();
+  return std::max<size_t>(16, ncores * 2);
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+Executor::Executor(size_t maxThreads)
+: _max_threads(std::max<size_t>(1, maxThreads)), _idle(0), _stop(false) {}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+Executor::~Executor() {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _stop = true;
+  }
+
+  _cv.notify_all();
+
+  for(size_t i = 0; i < _workers.size(); i++) {
+    _workers[i].join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Queue a task for execution on one of the workers
+//------------------------------------------------------------------------------
+void Executor::submit(const Task &task) {
+  std::unique_lock<std::mutex> lock(_mtx);
+  _tasks.push_back(task);
+
+  if(_idle < _tasks.size() && _workers.size() < _max_threads) {
+    _workers.emplace_back(&Executor::work, this);
+    DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CORE, "Executor: spawned worker {}/{}", _workers.size(), _max_threads);
+  }
+
+  lock.unlock();
+  _cv.notify_one();
+}
+
+//------------------------------------------------------------------------------
+// Maximum number of worker threads
+//------------------------------------------------------------------------------
+size_t Executor::getMaxThreads() const {
+  return _max_threads;
+}
+
+//------------------------------------------------------------------------------
+// Number of worker threads spawned so far
+//------------------------------------------------------------------------------
+size_t Executor::getThreadCount() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _workers.size();
+}
+
+//------------------------------------------------------------------------------
+// Worker thread main loop
+//------------------------------------------------------------------------------
+void Executor::work() {
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  while(true) {
+    _idle++;
+    _cv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+    _idle--;
+
+    if(_tasks.empty()) {
+      return;
+    }
+
+    Task task = std::move(_tasks.front());
+    _tasks.pop_front();
+
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_EXECUTOR_HPP
+#define DAVIX_CORE_EXECUTOR_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Bounded pool of worker threads, owned by a Context, on which background
+// work is queued. Workers are spawned lazily, the first time there is no
+// idle worker to pick up a new task, up to the configured maximum.
+//------------------------------------------------------------------------------
+class Executor {
+public:
+  typedef std::function<void()> Task;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  Executor(size_t maxThreads);
+
+  //----------------------------------------------------------------------------
+  // Destructor - runs what is still queued, then joins all workers.
+  //----------------------------------------------------------------------------
+  virtual ~Executor();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  Executor(const Executor& other) = delete;
+  Executor& operator=(const Executor& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Queue a task for execution on one of the workers
+  //----------------------------------------------------------------------------
+  void submit(const Task &task);
+
+  //----------------------------------------------------------------------------
+  // Maximum number of worker threads
+  //----------------------------------------------------------------------------
+  size_t getMaxThreads() const;
+
+  //----------------------------------------------------------------------------
+  // Number of worker threads spawned so far
+  //----------------------------------------------------------------------------
+  size_t getThreadCount() const;
+
+  //----------------------------------------------------------------------------
+  // Default pool size, overridable through DAVIX_EXECUTOR_THREADS
+  //----------------------------------------------------------------------------
+  static size_t getDefaultMaxThreads();
+
+private:
+  //----------------------------------------------------------------------------
+  // Worker thread main loop
+  //----------------------------------------------------------------------------
+  void work();
+
+  size_t _max_threads;
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+  std::deque<Task> _tasks;
+  std::vector<std::thread> _workers;
+  size_t _idle;
+  bool _stop;
+};
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "HostCapabilities.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <sstream>
+
+namespace Davix {
+
+// header lines need to stay below 8K on Apache2 / nginx, and some S3
+// implementations limit the total header size to 4K
+const dav_size_t HostCapabilityCache::kDefaultMaxHeaderSize = 3900;
+const dav_size_t HostCapabilityCache::kMinHeaderSize = 256;
+
+// without multi-range, each range costs a full round-trip, which is worth
+// reading some more bytes in between
+const dav_size_t HostCapabilityCache::kMultirangeMergeWindow = 2000;
+const dav_size_t HostCapabilityCache::kSingleRangeMergeWindow = 64 * 1024;
+
+MultirangeCapabilities::MultirangeCapabilities()
+: multirange(Unknown), maxHeaderSize(HostCapabilityCache::kDefaultMaxHeaderSize),
+  mergeWindow(HostCapabilityCache::kMultirangeMergeWindow) {}
+
+std::chrono::seconds HostCapabilityCache::getDefaultTTL() {
+  const char* value = getenv("DAVIX_HOST_CAPABILITIES_TTL");
+  if(value != NULL) {
+    long ttl = strtol(value, NULL, 10);
+    if(ttl >= 0) {
+      return std::chrono::seconds(ttl);
+    }
+  }
+
+  return std::chrono::seconds(3600);
+}
+
+HostCapabilityCache::HostCapabilityCache(std::chrono::seconds ttl, size_t maxEntries)
+: _ttl(ttl), _max_entries(std::max<size_t>(1, maxEntries)) {}
+
+std::string HostCapabilityCache::makeKey(const Uri &uri) {
+  std::ostringstream ss;
+  ss << uri.getProtocol() << "://" << uri.getHost() << ":" << uri.getPort();
+  return ss.str();
+}
+
+HostCapabilityCache::Entry& HostCapabilityCache::lookup(const std::string &key) {
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  std::map<std::string, Entry>::iterator it = _entries.find(key);
+  if(it != _entries.end() && it->second.expiry > now) {
+    return it->second;
+  }
+
+  if(it == _entries.end() && _entries.size() >= _max_entries) {
+    for(it = _entries.begin(); it != _entries.end(); ) {
+      if(it->second.expiry <= now) {
+        it = _entries.erase(it);
+      }
+      else {
+        it++;
+      }
+    }
+
+    if(_entries.size() >= _max_entries) {
+      _entries.erase(_entries.begin());
+    }
+  }
+
+  Entry &entry = _entries[key];
+  entry.caps = MultirangeCapabilities();
+  entry.expiry = now + _ttl;
+  return entry;
+}
+
+MultirangeCapabilities HostCapabilityCache::getMultirange(const Uri &uri) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  std::map<std::string, Entry>::iterator it = _entries.find(makeKey(uri));
+  if(it == _entries.end() || it->second.expiry <= std::chrono::steady_clock::now()) {
+    return MultirangeCapabilities();
+  }
+
+  return it->second.caps;
+}
+
+void HostCapabilityCache::setMultirangeSupport(const Uri &uri, bool supported) {
+  if(_ttl.count() == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  Entry &entry = lookup(makeKey(uri));
+
+  MultirangeCapabilities::Support support = supported ? MultirangeCapabilities::Supported : MultirangeCapabilities::Unsupported;
+  if(entry.caps.multirange != support) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Multi-range requests {} by {}", (supported ? "supported" : "not supported"), makeKey(uri));
+  }
+
+  entry.caps.multirange = support;
+  entry.caps.mergeWindow = supported ? kMultirangeMergeWindow : kSingleRangeMergeWindow;
+}
+
+void HostCapabilityCache::setMaxHeaderSize(const Uri &uri, dav_size_t size) {
+  if(_ttl.count() == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  Entry &entry = lookup(makeKey(uri));
+  entry.caps.maxHeaderSize = std::min(entry.caps.maxHeaderSize, std::max(kMinHeaderSize, size));
+}
+
+void HostCapabilityCache::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _entries.clear();
+}
+
+size_t HostCapabilityCache::size() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _entries.size();
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_HOST_CAPABILITIES_HPP
+#define DAVIX_CORE_HOST_CAPABILITIES_HPP
+
+#include <utils/davix_types.hpp>
+#include <utils/davix_uri.hpp>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// What has been learned about the vectored read support of a server
+//------------------------------------------------------------------------------
+struct MultirangeCapabilities {
+  enum Support { Unknown, Supported, Unsupported };
+
+  MultirangeCapabilities();
+
+  Support multirange;
+
+  // largest Range header to send in a single request
+  dav_size_t maxHeaderSize;
+
+  // distance under which neighbouring ranges are fetched together
+  dav_size_t mergeWindow;
+};
+
+//------------------------------------------------------------------------------
+// Per-host cache of server capabilities, owned by a Context, so that
+// repeated vector reads against a server which rejects multi-range
+// requests, or needs smaller Range headers, don't rediscover it the hard
+// way every time.
+//
+// Entries expire, so that a reconfigured server gets probed again.
+//------------------------------------------------------------------------------
+class HostCapabilityCache {
+public:
+  static const dav_size_t kDefaultMaxHeaderSize;
+  static const dav_size_t kMinHeaderSize;
+  static const dav_size_t kMultirangeMergeWindow;
+  static const dav_size_t kSingleRangeMergeWindow;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  HostCapabilityCache(std::chrono::seconds ttl, size_t maxEntries = 1024);
+
+  //----------------------------------------------------------------------------
+  // Capabilities of the server behind the given uri, defaults if unknown
+  //----------------------------------------------------------------------------
+  MultirangeCapabilities getMultirange(const Uri &uri);
+
+  //----------------------------------------------------------------------------
+  // Record whether the server answered a multi-range request properly
+  //----------------------------------------------------------------------------
+  void setMultirangeSupport(const Uri &uri, bool supported);
+
+  //----------------------------------------------------------------------------
+  // Record the largest Range header the server is known to accept. Only
+  // ever lowers the current value.
+  //----------------------------------------------------------------------------
+  void setMaxHeaderSize(const Uri &uri, dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Forget everything
+  //----------------------------------------------------------------------------
+  void clear();
+
+  //----------------------------------------------------------------------------
+  // Number of hosts with known capabilities
+  //----------------------------------------------------------------------------
+  size_t size();
+
+  //----------------------------------------------------------------------------
+  // Default time-to-live, overridable through DAVIX_HOST_CAPABILITIES_TTL
+  // (in seconds, 0 disables the cache)
+  //----------------------------------------------------------------------------
+  static std::chrono::seconds getDefaultTTL();
+
+private:
+  struct Entry {
+    MultirangeCapabilities caps;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  std::mutex _mtx;
+  std::map<std::string, Entry> _entries;
+  std::chrono::seconds _ttl;
+  size_t _max_entries;
+
+  static std::string makeKey(const Uri &uri);
+
+  // find or create a fresh entry, lock must be held
+  Entry& lookup(const std::string &key);
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "RedirectionResolver.hpp"
 #include <utils/davix_logger_internal.hpp>
+#include <cstdlib>
 
 
 using namespace Davix;
@@ -34,8 +35,40 @@ static const std::pair<std::string, std::string> makeKey(const std::string & met
     return std::make_pair(origin.getString(), mymethod);
 }
 
-RedirectionResolver::RedirectionResolver(bool act) : active(act), redirCache(256) {
-  DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CORE, "Redirection Session caching {}", (active?"ENABLED":"DISABLED"));
+size_t RedirectionResolver::KeyHash::operator()(const Key & key) const {
+  return std::hash<std::string>()(key.first) ^ (std::hash<std::string>()(key.second) << 1);
+}
+
+size_t RedirectionResolver::getDefaultCapacity() {
+  const char* value = getenv("DAVIX_REDIRECT_CACHE_SIZE");
+  if(value != NULL) {
+    long capacity = strtol(value, NULL, 10);
+    if(capacity > 0) {
+      return capacity;
+    }
+  }
+
+  return 4096;
+}
+
+std::chrono::seconds RedirectionResolver::getDefaultTTL() {
+  const char* value = getenv("DAVIX_REDIRECT_CACHE_TTL");
+  if(value != NULL) {
+    long seconds = strtol(value, NULL, 10);
+    if(seconds >= 0) {
+      return std::chrono::seconds(seconds);
+    }
+  }
+
+  return std::chrono::seconds(0);
+}
+
+RedirectionResolver::RedirectionResolver(bool act) :
+  RedirectionResolver(act, getDefaultCapacity(), getDefaultTTL()) {}
+
+RedirectionResolver::RedirectionResolver(bool act, size_t capacity, std::chrono::seconds ttl) :
+  active(act), redirCache(capacity, ttl) {
+  DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CORE, "Redirection Session caching {}, capacity {}, ttl {}s", (active?"ENABLED":"DISABLED"), capacity, ttl.count());
 }
 
 // add cached redirection
@@ -76,22 +109,25 @@ bool RedirectionResolver::isActive() const {
 }
 
 void RedirectionResolver::redirectionClean(const std::string & method, const Uri & origin) {
-  std::shared_ptr<Uri> res = redirCache.find(makeKey(method, origin));
+  std::shared_ptr<Uri> res = redirCache.take(makeKey(method, origin));
   if(res.get() != NULL){
       DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_HTTP, "Delete Cached redirection for <{} {} {}>", method.c_str(), origin.getString().c_str(), res->getString().c_str());
-      redirCache.erase(makeKey(method, origin));
       redirectionClean(method, *res);
   }
 }
 
 void RedirectionResolver::redirectionClean(const Uri & origin) {
-  std::pair<std::string, std::string> query = std::make_pair(origin.getString(), "");
-  while(true) {
-    const std::pair<std::string, std::string> nextkey = redirCache.upper_bound(query);
-      if(nextkey.first != origin.getString()) {
-        break;
-      }
-
-    redirectionClean(nextkey.second, nextkey.first);
+  // this is rare enough to afford a scan of the cache for the methods of origin
+  const std::string url = origin.getString();
+  std::vector<Key> keys = redirCache.findKeys([&url](const Key & key) {
+    return key.first == url;
+  });
+
+  for(size_t i = 0; i < keys.size(); i++) {
+    redirectionClean(keys[i].second, origin);
   }
 }
+
+LRUCacheStats RedirectionResolver::getStats() const {
+  return redirCache.getStats();
+}
@@ -22,11 +22,10 @@
 #ifndef DAVIX_CORE_REDIRECTION_RESOLVER_HPP
 #define DAVIX_CORE_REDIRECTION_RESOLVER_HPP
 
-#include <map>
-#include <mutex>
+#include <chrono>
 #include <utils/davix_uri.hpp>
 #include <memory>
-#include <libs/alibxx/containers/cache.hpp>
+#include <libs/alibxx/containers/lru_cache.hpp>
 
 namespace Davix {
 
@@ -34,6 +33,17 @@ class RedirectionResolver {
 public:
   RedirectionResolver(bool active);
 
+  //----------------------------------------------------------------------------
+  // Keep at most capacity redirections, each one for ttl, forever if zero
+  //----------------------------------------------------------------------------
+  RedirectionResolver(bool active, size_t capacity, std::chrono::seconds ttl);
+
+  // DAVIX_REDIRECT_CACHE_SIZE, 4096 if unset
+  static size_t getDefaultCapacity();
+
+  // DAVIX_REDIRECT_CACHE_TTL in seconds, 0 (no expiry) if unset
+  static std::chrono::seconds getDefaultTTL();
+
   // add cached redirection
   void addRedirection(const std::string & method, const Uri & origin, std::shared_ptr<Uri> dest);
 
@@ -47,11 +57,20 @@ public:
   void redirectionClean(const std::string & method, const Uri & origin);
   void redirectionClean(const Uri & origin);
 
+  // hits and misses of the redirection lookups
+  LRUCacheStats getStats() const;
+
 private:
+  typedef std::pair<std::string, std::string> Key;
+
+  struct KeyHash {
+    size_t operator()(const Key & key) const;
+  };
+
   bool active;
 
   // redirection pool
-  Davix::Cache<std::pair<std::string, std::string>, Uri> redirCache;
+  Davix::LRUCache<Key, Uri, KeyHash> redirCache;
 
   // resolve a single redirection chunk
   std::shared_ptr<Uri> resolveSingle(const std::string & method, const Uri & origin);
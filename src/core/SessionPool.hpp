@@ -22,19 +22,54 @@
 #ifndef DAVIX_CORE_SESSION_POOL_HPP
 #define DAVIX_CORE_SESSION_POOL_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <list>
 #include <map>
 #include <mutex>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Counters describing how well a SessionPool is doing.
+//------------------------------------------------------------------------------
+struct SessionPoolStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+};
 
 //------------------------------------------------------------------------------
 // Utility class to juggle sessions based on URI and parameters.
+//
+// Keys are spread over independently locked shards. Within a shard, idle
+// sessions are kept in least-recently-used order; retrieve hands out the
+// most recently stored session of a key, the least likely to have hit the
+// server's keep-alive timeout, and lets the others age. Sessions are evicted
+// when they exceed the idle TTL, the per-host limit, or the shard capacity.
 //------------------------------------------------------------------------------
 template<typename T>
 class SessionPool {
 public:
+  static const size_t kDefaultMaxIdlePerHost = 64;
+  static const size_t kDefaultMaxIdleTotal = 4096;
+  static const size_t kShards = 16;
+
+  typedef std::chrono::steady_clock Clock;
+  typedef std::function<Clock::time_point()> ClockFunction;
+
   //----------------------------------------------------------------------------
   // Constructor
   //----------------------------------------------------------------------------
-  SessionPool() {}
+  SessionPool(size_t maxIdlePerHost = kDefaultMaxIdlePerHost,
+    std::chrono::milliseconds idleTTL = std::chrono::seconds(60),
+    size_t maxIdleTotal = kDefaultMaxIdleTotal)
+  : _max_idle_per_host(maxIdlePerHost), _idle_ttl(idleTTL),
+    _max_idle_total(maxIdleTotal), _clock(&Clock::now), _hits(0), _misses(0), _evictions(0) {}
 
   //----------------------------------------------------------------------------
   // Destructor
@@ -43,20 +78,55 @@ public:
     clear();
   }
 
+  //----------------------------------------------------------------------------
+  // Replace the clock idle sessions are aged with, for tests. Not thread-safe,
+  // call before the pool is in use.
+  //----------------------------------------------------------------------------
+  void setClock(const ClockFunction &clock) {
+    _clock = clock;
+  }
+
   //----------------------------------------------------------------------------
   // Insert
   //----------------------------------------------------------------------------
   void insert(const std::string &key, T item) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _map.insert(std::pair<std::string, T>(key, std::move(item)));
+    std::vector<T> evicted;
+    Shard &shard = getShard(key);
+
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      Clock::time_point now = _clock();
+      purgeExpired(shard, now, evicted);
+
+      shard.lru.push_back(Entry(key, std::move(item), now));
+      std::vector<EntryIterator> &host = shard.index[key];
+      host.push_back(std::prev(shard.lru.end()));
+
+      if(host.size() > _max_idle_per_host) {
+        evict(shard, host.front(), evicted);
+      }
+
+      while(shard.lru.size() > shardCapacity()) {
+        evict(shard, shard.lru.begin(), evicted);
+      }
+    }
+
+    _evictions += evicted.size();
   }
 
   //----------------------------------------------------------------------------
   // Clear
   //----------------------------------------------------------------------------
   void clear() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _map.clear();
+    for(size_t i = 0; i < kShards; i++) {
+      std::list<Entry> released;
+
+      {
+        std::lock_guard<std::mutex> lock(_shards[i].mutex);
+        _shards[i].index.clear();
+        released.swap(_shards[i].lru);
+      }
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -64,23 +134,162 @@ public:
   // Return true if value was found, returned and erased, and false otherwise.
   //----------------------------------------------------------------------------
   bool retrieve(const std::string &key, T& item) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _map.find(key);
+    std::vector<T> evicted;
+    Shard &shard = getShard(key);
+    bool found = false;
 
-    if(it == _map.end()) {
-      return false;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      purgeExpired(shard, _clock(), evicted);
+
+      auto it = shard.index.find(key);
+      if(it != shard.index.end()) {
+        EntryIterator entry = it->second.back();
+        item = std::move(entry->item);
+
+        it->second.pop_back();
+        if(it->second.empty()) {
+          shard.index.erase(it);
+        }
+
+        shard.lru.erase(entry);
+        found = true;
+      }
     }
 
-    item = it->second;
-    _map.erase(it);
-    return true;
+    _evictions += evicted.size();
+
+    if(found) {
+      _hits++;
+    }
+    else {
+      _misses++;
+    }
+
+    return found;
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of idle sessions currently held
+  //----------------------------------------------------------------------------
+  size_t size() const {
+    size_t total = 0;
+    for(size_t i = 0; i < kShards; i++) {
+      std::lock_guard<std::mutex> lock(_shards[i].mutex);
+      total += _shards[i].lru.size();
+    }
+
+    return total;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get hit / miss / eviction counters
+  //----------------------------------------------------------------------------
+  SessionPoolStats getStats() const {
+    SessionPoolStats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.evictions = _evictions;
+    return stats;
+  }
+
+  //----------------------------------------------------------------------------
+  // Defaults, overridable through DAVIX_SESSION_POOL_MAX_IDLE_PER_HOST and
+  // DAVIX_SESSION_POOL_IDLE_TTL (in seconds)
+  //----------------------------------------------------------------------------
+  static size_t getDefaultMaxIdlePerHost() {
+    const char* value = getenv("DAVIX_SESSION_POOL_MAX_IDLE_PER_HOST");
+    if(value != NULL) {
+      char* end = NULL;
+      unsigned long long max = strtoull(value, &end, 10);
+      if(end != value) {
+        return max;
+      }
+    }
+
+    return kDefaultMaxIdlePerHost;
+  }
+
+  static std::chrono::milliseconds getDefaultIdleTTL() {
+    const char* value = getenv("DAVIX_SESSION_POOL_IDLE_TTL");
+    if(value != NULL) {
+      char* end = NULL;
+      long ttl = strtol(value, &end, 10);
+      if(end != value && ttl >= 0) {
+        return std::chrono::seconds(ttl);
+      }
+    }
+
+    return std::chrono::seconds(60);
   }
 
 private:
-  std::multimap<std::string, T> _map;
-  std::mutex _mutex;
+  struct Entry {
+    std::string key;
+    T item;
+    Clock::time_point stored;
+
+    Entry(const std::string &k, T &&i, Clock::time_point t) : key(k), item(std::move(i)), stored(t) {}
+  };
+
+  typedef typename std::list<Entry>::iterator EntryIterator;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::list<Entry> lru; // front is least recently used
+    std::map<std::string, std::vector<EntryIterator> > index; // front is oldest
+  };
+
+  Shard& getShard(const std::string &key) {
+    return _shards[std::hash<std::string>()(key) % kShards];
+  }
+
+  size_t shardCapacity() const {
+    return std::max<size_t>(1, _max_idle_total / kShards);
+  }
 
+  //----------------------------------------------------------------------------
+  // Remove an entry - the session itself is destroyed by the caller, once
+  // the shard lock has been released.
+  //----------------------------------------------------------------------------
+  void evict(Shard &shard, EntryIterator entry, std::vector<T> &evicted) {
+    auto it = shard.index.find(entry->key);
+    std::vector<EntryIterator> &host = it->second;
+
+    for(auto pos = host.begin(); pos != host.end(); pos++) {
+      if(*pos == entry) {
+        host.erase(pos);
+        break;
+      }
+    }
+
+    if(host.empty()) {
+      shard.index.erase(it);
+    }
+
+    evicted.push_back(std::move(entry->item));
+    shard.lru.erase(entry);
+  }
+
+  //----------------------------------------------------------------------------
+  // Evict sessions idle for longer than the TTL - they are at the front.
+  //----------------------------------------------------------------------------
+  void purgeExpired(Shard &shard, Clock::time_point now, std::vector<T> &evicted) {
+    while(!shard.lru.empty() && now - shard.lru.front().stored > _idle_ttl) {
+      evict(shard, shard.lru.begin(), evicted);
+    }
+  }
+
+  size_t _max_idle_per_host;
+  std::chrono::milliseconds _idle_ttl;
+  size_t _max_idle_total;
+  ClockFunction _clock;
+
+  Shard _shards[kShards];
+
+  std::atomic<uint64_t> _hits;
+  std::atomic<uint64_t> _misses;
+  std::atomic<uint64_t> _evictions;
 };
 
 #endif
-
@@ -0,0 +1,208 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "StatCache.hpp"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace Davix {
+
+static std::chrono::seconds getEnvSeconds(const char* name, std::chrono::seconds defaultValue) {
+  const char* value = getenv(name);
+  if(value != NULL) {
+    long seconds = strtol(value, NULL, 10);
+    if(seconds >= 0) {
+      return std::chrono::seconds(seconds);
+    }
+  }
+
+  return defaultValue;
+}
+
+std::chrono::seconds StatCache::getDefaultTTL() {
+  return getEnvSeconds("DAVIX_STAT_CACHE_TTL", std::chrono::seconds(0));
+}
+
+std::chrono::seconds StatCache::getDefaultNegativeTTL() {
+  return getEnvSeconds("DAVIX_STAT_CACHE_NEGATIVE_TTL", getDefaultTTL());
+}
+
+static std::string stripTrailingSlashes(const std::string &path) {
+  size_t end = path.find_last_not_of('/');
+  return (end == std::string::npos) ? std::string() : path.substr(0, end + 1);
+}
+
+static std::string hostKey(const Uri &uri) {
+  std::ostringstream ss;
+  ss << uri.getProtocol() << "://" << uri.getHost() << ":" << uri.getPort();
+  return ss.str();
+}
+
+std::string StatCache::makeKey(const Uri &uri) {
+  std::string key = hostKey(uri) + stripTrailingSlashes(uri.getPath());
+  if(!uri.getQuery().empty()) {
+    key += "?" + uri.getQuery();
+  }
+  return key;
+}
+
+StatCache::StatCache(std::chrono::seconds ttl, std::chrono::seconds negativeTtl, size_t maxEntries)
+: _ttl(ttl), _negative_ttl(negativeTtl), _max_entries(std::max<size_t>(1, maxEntries)) {}
+
+void StatCache::insert(const std::string &key, const Entry &entry) {
+  if(_entries.size() >= _max_entries && _entries.find(key) == _entries.end()) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for(std::map<std::string, Entry>::iterator it = _entries.begin(); it != _entries.end(); ) {
+      if(it->second.expiry <= now) {
+        it = _entries.erase(it);
+      }
+      else {
+        it++;
+      }
+    }
+
+    // still full of fresh entries, start over
+    if(_entries.size() >= _max_entries) {
+      _entries.clear();
+    }
+  }
+
+  _entries[key] = entry;
+}
+
+StatCache::Result StatCache::get(const Uri &uri, StatInfo &info, std::string &error) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  std::map<std::string, Entry>::iterator it = _entries.find(makeKey(uri));
+  if(it == _entries.end()) {
+    return Miss;
+  }
+
+  if(it->second.expiry <= std::chrono::steady_clock::now()) {
+    _entries.erase(it);
+    return Miss;
+  }
+
+  if(!it->second.exists) {
+    error = it->second.error;
+    return NotFound;
+  }
+
+  info = it->second.info;
+  return Hit;
+}
+
+void StatCache::put(const Uri &uri, const StatInfo &info) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_ttl.count() == 0) {
+    return;
+  }
+
+  Entry entry;
+  entry.exists = true;
+  entry.info = info;
+  entry.expiry = std::chrono::steady_clock::now() + _ttl;
+  insert(makeKey(uri), entry);
+}
+
+void StatCache::putChild(const Uri &parent, const std::string &name, const StatInfo &info) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  const std::string child = stripTrailingSlashes(name);
+  if(_ttl.count() == 0 || !parent.getQuery().empty() || child.empty()) {
+    return;
+  }
+
+  Entry entry;
+  entry.exists = true;
+  entry.info = info;
+  entry.expiry = std::chrono::steady_clock::now() + _ttl;
+  insert(hostKey(parent) + stripTrailingSlashes(parent.getPath()) + "/" + child, entry);
+}
+
+void StatCache::putNotFound(const Uri &uri, const std::string &error) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_ttl.count() == 0 || _negative_ttl.count() == 0) {
+    return;
+  }
+
+  Entry entry;
+  entry.exists = false;
+  entry.error = error;
+  entry.expiry = std::chrono::steady_clock::now() + _negative_ttl;
+  insert(makeKey(uri), entry);
+}
+
+void StatCache::invalidate(const Uri &uri) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  const std::string key = makeKey(uri);
+  _entries.erase(key);
+
+  // everything below
+  const std::string prefix = key + "/";
+  std::map<std::string, Entry>::iterator it = _entries.lower_bound(prefix);
+  while(it != _entries.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+    it = _entries.erase(it);
+  }
+
+  // the parent directory, its modification time changes
+  const std::string path = stripTrailingSlashes(uri.getPath());
+  const size_t slash = path.find_last_of('/');
+  if(uri.getQuery().empty() && slash != std::string::npos) {
+    _entries.erase(hostKey(uri) + path.substr(0, slash));
+  }
+}
+
+void StatCache::setTTL(std::chrono::seconds ttl, std::chrono::seconds negativeTtl) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _ttl = ttl;
+  _negative_ttl = negativeTtl;
+
+  if(_ttl.count() == 0) {
+    _entries.clear();
+  }
+}
+
+std::chrono::seconds StatCache::getTTL() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _ttl;
+}
+
+std::chrono::seconds StatCache::getNegativeTTL() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _negative_ttl;
+}
+
+bool StatCache::isEnabled() {
+  return getTTL().count() > 0;
+}
+
+void StatCache::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _entries.clear();
+}
+
+size_t StatCache::size() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _entries.size();
+}
+
+}
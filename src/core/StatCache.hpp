@@ -0,0 +1,119 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_STAT_CACHE_HPP
+#define DAVIX_CORE_STAT_CACHE_HPP
+
+#include <davix_file_types.hpp>
+#include <utils/davix_uri.hpp>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Cache of stat results, owned by a Context. Missing resources are
+// remembered too, with their own time-to-live.
+//
+// Entries are keyed by URI, without fragment nor trailing slash, and can
+// be filled from directory listings, so that stat calls following a
+// listing don't need a round-trip each.
+//------------------------------------------------------------------------------
+class StatCache {
+public:
+  enum Result { Miss, Hit, NotFound };
+
+  //----------------------------------------------------------------------------
+  // Constructor, a zero ttl disables the cache
+  //----------------------------------------------------------------------------
+  StatCache(std::chrono::seconds ttl, std::chrono::seconds negativeTtl, size_t maxEntries = 100000);
+
+  //----------------------------------------------------------------------------
+  // Look up uri. On Hit, info is filled. On NotFound, error holds the
+  // message of the original failure.
+  //----------------------------------------------------------------------------
+  Result get(const Uri &uri, StatInfo &info, std::string &error);
+
+  //----------------------------------------------------------------------------
+  // Remember the stat result of uri
+  //----------------------------------------------------------------------------
+  void put(const Uri &uri, const StatInfo &info);
+
+  //----------------------------------------------------------------------------
+  // Remember the stat result of a directory entry, as found in a listing
+  //----------------------------------------------------------------------------
+  void putChild(const Uri &parent, const std::string &name, const StatInfo &info);
+
+  //----------------------------------------------------------------------------
+  // Remember that uri does not exist
+  //----------------------------------------------------------------------------
+  void putNotFound(const Uri &uri, const std::string &error);
+
+  //----------------------------------------------------------------------------
+  // Forget uri, everything below it, and its parent directory
+  //----------------------------------------------------------------------------
+  void invalidate(const Uri &uri);
+
+  void setTTL(std::chrono::seconds ttl, std::chrono::seconds negativeTtl);
+  std::chrono::seconds getTTL();
+  std::chrono::seconds getNegativeTTL();
+  bool isEnabled();
+
+  //----------------------------------------------------------------------------
+  // Forget everything
+  //----------------------------------------------------------------------------
+  void clear();
+  size_t size();
+
+  //----------------------------------------------------------------------------
+  // Defaults, overridable through DAVIX_STAT_CACHE_TTL (disabled unless
+  // set) and DAVIX_STAT_CACHE_NEGATIVE_TTL (same as the former if unset),
+  // in seconds
+  //----------------------------------------------------------------------------
+  static std::chrono::seconds getDefaultTTL();
+  static std::chrono::seconds getDefaultNegativeTTL();
+
+private:
+  struct Entry {
+    bool exists;
+    StatInfo info;
+    std::string error;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  std::mutex _mtx;
+  std::map<std::string, Entry> _entries;
+  std::chrono::seconds _ttl;
+  std::chrono::seconds _negative_ttl;
+  size_t _max_entries;
+
+  static std::string makeKey(const Uri &uri);
+
+  // lock must be held
+  void insert(const std::string &key, const Entry &entry);
+};
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "TaskGroup.hpp"
+#include "Executor.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <set>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// State shared with the helpers, which may only get to run once the group
+// is gone. They then find nothing queued and return.
+//------------------------------------------------------------------------------
+struct TaskGroupState {
+  struct Entry {
+    TaskGroup::TaskId id;
+    TaskGroup::Task task;
+  };
+
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  std::deque<Entry> queue;
+  std::set<TaskGroup::TaskId> running;
+  TaskGroup::TaskId next_id;
+
+  // helpers submitted, and those of them not running a task
+  size_t helpers;
+  size_t idle_helpers;
+  size_t max_helpers;
+  std::exception_ptr exc;
+  bool closed;
+
+  TaskGroupState(size_t maxHelpers) : next_id(0), helpers(0), idle_helpers(0), max_helpers(maxHelpers), closed(false) {}
+
+  // Run the given entry, lock must be held on entry and is held on exit
+  void run(std::unique_lock<std::mutex> &lock, Entry &entry) {
+    running.insert(entry.id);
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+      entry.task();
+    }
+    catch(...) {
+      error = std::current_exception();
+    }
+
+    // captures of the task may only be valid until it is done
+    entry.task = TaskGroup::Task();
+
+    lock.lock();
+    running.erase(entry.id);
+
+    if(error != std::exception_ptr() && exc == std::exception_ptr()) {
+      exc = error;
+      queue.clear();
+    }
+
+    cv.notify_all();
+  }
+
+  // Run the oldest queued task, lock must be held
+  bool runFront(std::unique_lock<std::mutex> &lock) {
+    if(queue.empty()) {
+      return false;
+    }
+
+    Entry entry = std::move(queue.front());
+    queue.pop_front();
+    run(lock, entry);
+    return true;
+  }
+
+  // Helper main loop, on an executor worker
+  void help() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while(!queue.empty()) {
+      idle_helpers--;
+      runFront(lock);
+      idle_helpers++;
+    }
+
+    helpers--;
+    idle_helpers--;
+  }
+};
+
+TaskGroup::TaskGroup(Executor &executor, size_t maxHelpers)
+: _executor(executor), _state(new TaskGroupState(maxHelpers)) {}
+
+TaskGroup::~TaskGroup() {
+  std::unique_lock<std::mutex> lock(_state->mtx);
+  _state->closed = true;
+  _state->queue.clear();
+
+  std::shared_ptr<TaskGroupState> state = _state;
+  state->cv.wait(lock, [&state]() { return state->running.empty(); });
+}
+
+TaskGroup::TaskId TaskGroup::add(const Task &task) {
+  std::shared_ptr<TaskGroupState> state = _state;
+  std::unique_lock<std::mutex> lock(state->mtx);
+
+  const TaskId id = state->next_id++;
+  if(state->closed || state->exc != std::exception_ptr()) {
+    return id; // never runs
+  }
+
+  state->queue.push_back(TaskGroupState::Entry{id, task});
+  state->cv.notify_all();
+
+  if(state->helpers < state->max_helpers && state->idle_helpers < state->queue.size()) {
+    state->helpers++;
+    state->idle_helpers++;
+    lock.unlock();
+    _executor.submit([state]() { state->help(); });
+  }
+
+  return id;
+}
+
+void TaskGroup::runOrWait(TaskId id) {
+  std::shared_ptr<TaskGroupState> state = _state;
+  std::unique_lock<std::mutex> lock(state->mtx);
+
+  for(std::deque<TaskGroupState::Entry>::iterator it = state->queue.begin(); it != state->queue.end(); it++) {
+    if(it->id == id) {
+      TaskGroupState::Entry entry = std::move(*it);
+      state->queue.erase(it);
+      state->run(lock, entry);
+      return;
+    }
+  }
+
+  state->cv.wait(lock, [&state, id]() { return state->running.count(id) == 0; });
+}
+
+bool TaskGroup::runNext() {
+  std::unique_lock<std::mutex> lock(_state->mtx);
+  return _state->runFront(lock);
+}
+
+void TaskGroup::wait() {
+  std::shared_ptr<TaskGroupState> state = _state;
+  std::unique_lock<std::mutex> lock(state->mtx);
+
+  while(state->runFront(lock) || !state->running.empty()) {
+    state->cv.wait(lock, [&state]() { return !state->queue.empty() || state->running.empty(); });
+  }
+
+  if(state->exc != std::exception_ptr()) {
+    std::rethrow_exception(state->exc);
+  }
+}
+
+void TaskGroup::cancel() {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  _state->queue.clear();
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_TASK_GROUP_HPP
+#define DAVIX_CORE_TASK_GROUP_HPP
+
+#include <functional>
+#include <memory>
+
+namespace Davix {
+
+class Executor;
+struct TaskGroupState;
+
+//------------------------------------------------------------------------------
+// Tasks queued for up to maxHelpers workers of an executor, which the
+// thread waiting for them may also run itself.
+//
+// A thread waiting for a task that no worker has picked up yet runs it
+// instead of waiting, so a group always completes, even when every worker
+// of the executor is busy, or when the waiting thread is one of them.
+//
+// Tasks may add more tasks. The first exception thrown by a task drops
+// the tasks that have not started yet, and is rethrown by wait().
+//------------------------------------------------------------------------------
+class TaskGroup {
+public:
+  typedef std::function<void()> Task;
+  typedef size_t TaskId;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  TaskGroup(Executor &executor, size_t maxHelpers);
+
+  //----------------------------------------------------------------------------
+  // Destructor - drops queued tasks, waits for the running ones
+  //----------------------------------------------------------------------------
+  ~TaskGroup();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  TaskGroup(const TaskGroup& other) = delete;
+  TaskGroup& operator=(const TaskGroup& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Queue a task
+  //----------------------------------------------------------------------------
+  TaskId add(const Task &task);
+
+  //----------------------------------------------------------------------------
+  // Run the given task on the caller if it has not started yet, else wait
+  // for it to finish
+  //----------------------------------------------------------------------------
+  void runOrWait(TaskId id);
+
+  //----------------------------------------------------------------------------
+  // Run the oldest queued task on the caller, returns false if there was none
+  //----------------------------------------------------------------------------
+  bool runNext();
+
+  //----------------------------------------------------------------------------
+  // Run queued tasks on the caller until none is left, then wait for the
+  // running ones. Rethrows the first exception thrown by a task.
+  //----------------------------------------------------------------------------
+  void wait();
+
+  //----------------------------------------------------------------------------
+  // Drop the tasks that have not started yet
+  //----------------------------------------------------------------------------
+  void cancel();
+
+private:
+  Executor &_executor;
+  std::shared_ptr<TaskGroupState> _state;
+};
+
+}
+
+#endif
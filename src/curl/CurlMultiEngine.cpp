@@ -0,0 +1,532 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "CurlMultiEngine.hpp"
+#include <utils/davix_logger_internal.hpp>
+#include <curl/curl.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// A single event loop thread, owning one shared multi handle. All calls
+// into the multi handle happen from the loop thread; other threads talk to
+// it through a command queue.
+//
+// On linux, sockets are watched through epoll and CURLMOPT_SOCKETFUNCTION,
+// elsewhere we fall back to curl_multi_poll.
+//------------------------------------------------------------------------------
+class CurlEventLoop {
+public:
+  CurlEventLoop(long maxHostConnections);
+  ~CurlEventLoop();
+
+  void add(CURL *handle, CurlMultiEngine::CompletionCallback callback);
+  void remove(CURL *handle);
+  void unpause(CURL *handle);
+
+private:
+  struct Command {
+    enum Type { kAdd, kRemove, kUnpause, kStop };
+
+    Type type;
+    CURL *handle;
+    CurlMultiEngine::CompletionCallback callback;
+    std::shared_ptr<std::promise<void> > ack;
+  };
+
+  //----------------------------------------------------------------------------
+  // Queue a command and wake up the loop thread
+  //----------------------------------------------------------------------------
+  void post(const Command &cmd);
+  void wakeup();
+
+  //----------------------------------------------------------------------------
+  // Loop thread internals
+  //----------------------------------------------------------------------------
+  void run();
+  bool processCommands();
+  void processCompletions();
+  void detach(CURL *handle);
+
+  CURLM *_mhandle;
+  std::thread _thread;
+
+  std::mutex _commands_mtx;
+  std::deque<Command> _commands;
+
+  // only ever touched from the loop thread
+  std::map<CURL*, CurlMultiEngine::CompletionCallback> _transfers;
+
+#ifdef __linux__
+  int _epfd;
+  int _evfd;
+  bool _timer_armed;
+  std::chrono::steady_clock::time_point _timer_deadline;
+
+  int computeTimeout() const;
+  void socketActionTimeout();
+
+  static int socketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp);
+  static int timerCallback(CURLM *multi, long timeout_ms, void *userp);
+#endif
+};
+
+#ifdef __linux__
+//------------------------------------------------------------------------------
+// curl asks us to watch / stop watching a socket
+//------------------------------------------------------------------------------
+int CurlEventLoop::socketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp) {
+  CurlEventLoop *loop = (CurlEventLoop*) userp;
+
+  if(what == CURL_POLL_REMOVE) {
+    epoll_ctl(loop->_epfd, EPOLL_CTL_DEL, s, NULL);
+    curl_multi_assign(loop->_mhandle, s, NULL);
+    return 0;
+  }
+
+  struct epoll_event ev;
+  ev.events = 0;
+  ev.data.fd = s;
+
+  if(what & CURL_POLL_IN) ev.events |= EPOLLIN;
+  if(what & CURL_POLL_OUT) ev.events |= EPOLLOUT;
+
+  if(socketp == NULL) {
+    if(epoll_ctl(loop->_epfd, EPOLL_CTL_ADD, s, &ev) != 0 && errno == EEXIST) {
+      epoll_ctl(loop->_epfd, EPOLL_CTL_MOD, s, &ev);
+    }
+
+    curl_multi_assign(loop->_mhandle, s, loop);
+  }
+  else {
+    epoll_ctl(loop->_epfd, EPOLL_CTL_MOD, s, &ev);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// curl asks us to call back in timeout_ms, or to disarm the timer
+//------------------------------------------------------------------------------
+int CurlEventLoop::timerCallback(CURLM *multi, long timeout_ms, void *userp) {
+  CurlEventLoop *loop = (CurlEventLoop*) userp;
+
+  if(timeout_ms < 0) {
+    loop->_timer_armed = false;
+  }
+  else {
+    loop->_timer_armed = true;
+    loop->_timer_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Milliseconds until curl's timer fires, -1 if disarmed
+//------------------------------------------------------------------------------
+int CurlEventLoop::computeTimeout() const {
+  if(!_timer_armed) {
+    return -1;
+  }
+
+  auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+    _timer_deadline - std::chrono::steady_clock::now()).count();
+
+  if(remaining < 0) {
+    return 0;
+  }
+
+  return (int) remaining;
+}
+
+//------------------------------------------------------------------------------
+// Let curl handle its timeouts, if the timer has expired
+//------------------------------------------------------------------------------
+void CurlEventLoop::socketActionTimeout() {
+  if(_timer_armed && computeTimeout() == 0) {
+    int running = 0;
+    _timer_armed = false;
+    curl_multi_socket_action(_mhandle, CURL_SOCKET_TIMEOUT, 0, &running);
+  }
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+CurlEventLoop::CurlEventLoop(long maxHostConnections) : _mhandle(curl_multi_init()) {
+  // HTTP/2 transfers to the same endpoint share one connection
+  curl_multi_setopt(_mhandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+  if(maxHostConnections > 0) {
+    curl_multi_setopt(_mhandle, CURLMOPT_MAX_HOST_CONNECTIONS, maxHostConnections);
+  }
+
+#ifdef __linux__
+  _timer_armed = false;
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+  _evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.fd = _evfd;
+  epoll_ctl(_epfd, EPOLL_CTL_ADD, _evfd, &ev);
+
+  curl_multi_setopt(_mhandle, CURLMOPT_SOCKETFUNCTION, socketCallback);
+  curl_multi_setopt(_mhandle, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(_mhandle, CURLMOPT_TIMERFUNCTION, timerCallback);
+  curl_multi_setopt(_mhandle, CURLMOPT_TIMERDATA, this);
+#endif
+
+  _thread = std::thread(&CurlEventLoop::run, this);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+CurlEventLoop::~CurlEventLoop() {
+  Command cmd;
+  cmd.type = Command::kStop;
+  cmd.handle = NULL;
+  post(cmd);
+
+  _thread.join();
+
+  for(auto it = _transfers.begin(); it != _transfers.end(); it++) {
+    curl_multi_remove_handle(_mhandle, it->first);
+  }
+
+  curl_multi_cleanup(_mhandle);
+
+#ifdef __linux__
+  close(_evfd);
+  close(_epfd);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Queue a command and wake up the loop thread
+//------------------------------------------------------------------------------
+void CurlEventLoop::post(const Command &cmd) {
+  {
+    std::lock_guard<std::mutex> lock(_commands_mtx);
+    _commands.push_back(cmd);
+  }
+
+  wakeup();
+}
+
+void CurlEventLoop::wakeup() {
+#ifdef __linux__
+  uint64_t one = 1;
+  ssize_t ret = write(_evfd, &one, sizeof(one));
+  (void) ret;
+#else
+  curl_multi_wakeup(_mhandle);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Public interface, callable from any thread
+//------------------------------------------------------------------------------
+void CurlEventLoop::add(CURL *handle, CurlMultiEngine::CompletionCallback callback) {
+  Command cmd;
+  cmd.type = Command::kAdd;
+  cmd.handle = handle;
+  cmd.callback = callback;
+  post(cmd);
+}
+
+void CurlEventLoop::remove(CURL *handle) {
+  if(std::this_thread::get_id() == _thread.get_id()) {
+    detach(handle);
+    return;
+  }
+
+  Command cmd;
+  cmd.type = Command::kRemove;
+  cmd.handle = handle;
+  cmd.ack.reset(new std::promise<void>());
+
+  std::future<void> done = cmd.ack->get_future();
+  post(cmd);
+  done.wait();
+}
+
+void CurlEventLoop::unpause(CURL *handle) {
+  Command cmd;
+  cmd.type = Command::kUnpause;
+  cmd.handle = handle;
+  post(cmd);
+}
+
+//------------------------------------------------------------------------------
+// Remove handle from the multi handle, if still there
+//------------------------------------------------------------------------------
+void CurlEventLoop::detach(CURL *handle) {
+  auto it = _transfers.find(handle);
+  if(it != _transfers.end()) {
+    curl_multi_remove_handle(_mhandle, handle);
+    _transfers.erase(it);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Execute all queued commands - returns false when asked to stop
+//------------------------------------------------------------------------------
+bool CurlEventLoop::processCommands() {
+  std::deque<Command> commands;
+  {
+    std::lock_guard<std::mutex> lock(_commands_mtx);
+    commands.swap(_commands);
+  }
+
+  bool keepRunning = true;
+
+  for(auto it = commands.begin(); it != commands.end(); it++) {
+    switch(it->type) {
+      case Command::kAdd: {
+        _transfers[it->handle] = it->callback;
+        CURLMcode rc = curl_multi_add_handle(_mhandle, it->handle);
+
+        if(rc != CURLM_OK) {
+          DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_HTTP, "Unable to add handle to curl event loop: {}", curl_multi_strerror(rc));
+          _transfers.erase(it->handle);
+          it->callback(CURLE_FAILED_INIT);
+        }
+        break;
+      }
+      case Command::kRemove: {
+        detach(it->handle);
+        break;
+      }
+      case Command::kUnpause: {
+        if(_transfers.find(it->handle) != _transfers.end()) {
+          curl_easy_pause(it->handle, CURLPAUSE_CONT);
+        }
+        break;
+      }
+      case Command::kStop: {
+        keepRunning = false;
+        break;
+      }
+    }
+
+    if(it->ack) {
+      it->ack->set_value();
+    }
+  }
+
+  return keepRunning;
+}
+
+//------------------------------------------------------------------------------
+// Notify owners of finished transfers, and release their handles
+//------------------------------------------------------------------------------
+void CurlEventLoop::processCompletions() {
+  CURLMsg *msg;
+  int msgs_left = 0;
+
+  while((msg = curl_multi_info_read(_mhandle, &msgs_left))) {
+    if(msg->msg != CURLMSG_DONE) {
+      continue;
+    }
+
+    CURL *handle = msg->easy_handle;
+    CURLcode result = msg->data.result;
+
+    auto it = _transfers.find(handle);
+    if(it == _transfers.end()) {
+      continue;
+    }
+
+    CurlMultiEngine::CompletionCallback callback = it->second;
+    detach(handle);
+    callback(result);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Main loop
+//------------------------------------------------------------------------------
+void CurlEventLoop::run() {
+#ifdef __linux__
+  const int maxEvents = 256;
+  struct epoll_event events[maxEvents];
+
+  while(true) {
+    int nevents = epoll_wait(_epfd, events, maxEvents, computeTimeout());
+
+    for(int i = 0; i < nevents; i++) {
+      if(events[i].data.fd == _evfd) {
+        uint64_t count;
+        ssize_t ret = read(_evfd, &count, sizeof(count));
+        (void) ret;
+        continue;
+      }
+
+      int flags = 0;
+      if(events[i].events & EPOLLIN) flags |= CURL_CSELECT_IN;
+      if(events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+      if(events[i].events & (EPOLLERR | EPOLLHUP)) flags |= CURL_CSELECT_ERR;
+
+      int running = 0;
+      curl_multi_socket_action(_mhandle, events[i].data.fd, flags, &running);
+    }
+
+    if(!processCommands()) {
+      break;
+    }
+
+    socketActionTimeout();
+    processCompletions();
+  }
+#else
+  while(true) {
+    if(!processCommands()) {
+      break;
+    }
+
+    int running = 0;
+    curl_multi_perform(_mhandle, &running);
+    processCompletions();
+
+    int numfds = 0;
+    curl_multi_poll(_mhandle, NULL, 0, 1000, &numfds);
+  }
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Number of event loops requested through DAVIX_CURL_EVENT_LOOP
+//------------------------------------------------------------------------------
+size_t CurlMultiEngine::getLoopCountFromEnv() {
+  const char* value = getenv("DAVIX_CURL_EVENT_LOOP");
+  if(value == NULL) {
+    return 0;
+  }
+
+  long nloops = strtol(value, NULL, 10);
+  if(nloops <= 0) {
+    return 1;
+  }
+
+  return nloops;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+CurlMultiEngine::CurlMultiEngine(size_t nloops, long maxHostConnections) : _next_loop(0) {
+  if(nloops == 0) {
+    nloops = 1;
+  }
+
+  for(size_t i = 0; i < nloops; i++) {
+    _loops.emplace_back(new CurlEventLoop(maxHostConnections));
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_HTTP, "Started curl event loop engine with {} loop(s)", nloops);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+CurlMultiEngine::~CurlMultiEngine() {}
+
+//------------------------------------------------------------------------------
+// Start driving the given easy handle, spreading handles over the loops
+//------------------------------------------------------------------------------
+void CurlMultiEngine::addHandle(CURL *handle, CompletionCallback callback, const std::string &affinity) {
+  size_t index = affinity.empty() ? _next_loop++ : std::hash<std::string>()(affinity);
+  CurlEventLoop *loop = _loops[index % _loops.size()].get();
+
+  {
+    std::lock_guard<std::mutex> lock(_assignment_mtx);
+    _assignment[handle] = loop;
+  }
+
+  loop->add(handle, callback);
+}
+
+//------------------------------------------------------------------------------
+// Stop driving the given easy handle
+//------------------------------------------------------------------------------
+void CurlMultiEngine::removeHandle(CURL *handle) {
+  CurlEventLoop *loop = NULL;
+
+  {
+    std::lock_guard<std::mutex> lock(_assignment_mtx);
+    auto it = _assignment.find(handle);
+    if(it == _assignment.end()) {
+      return;
+    }
+
+    loop = it->second;
+    _assignment.erase(it);
+  }
+
+  loop->remove(handle);
+}
+
+//------------------------------------------------------------------------------
+// Resume a paused transfer
+//------------------------------------------------------------------------------
+void CurlMultiEngine::unpauseHandle(CURL *handle) {
+  CurlEventLoop *loop = findLoop(handle);
+  if(loop) {
+    loop->unpause(handle);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Number of event loops
+//------------------------------------------------------------------------------
+size_t CurlMultiEngine::getLoopCount() const {
+  return _loops.size();
+}
+
+//------------------------------------------------------------------------------
+// Find the event loop driving the given handle
+//------------------------------------------------------------------------------
+CurlEventLoop* CurlMultiEngine::findLoop(CURL *handle) {
+  std::lock_guard<std::mutex> lock(_assignment_mtx);
+  auto it = _assignment.find(handle);
+  if(it == _assignment.end()) {
+    return NULL;
+  }
+
+  return it->second;
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CURL_MULTI_ENGINE_HPP
+#define DAVIX_CURL_MULTI_ENGINE_HPP
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef void CURL;
+
+namespace Davix {
+
+class CurlEventLoop;
+
+//------------------------------------------------------------------------------
+// Drives the transfers of many StandaloneCurlRequests from a small, fixed
+// number of event loop threads, each owning one shared multi handle.
+//
+// Waiting readers are not polling the network themselves: the event loop
+// invokes the curl callbacks of each easy handle, and the request wakes up
+// its own reader. Enabled through DAVIX_CURL_EVENT_LOOP=<number of loops>.
+//------------------------------------------------------------------------------
+class CurlMultiEngine {
+public:
+  //----------------------------------------------------------------------------
+  // Callback fired from the event loop thread once a transfer is over,
+  // with the CURLcode of the transfer as argument.
+  //----------------------------------------------------------------------------
+  typedef std::function<void(int)> CompletionCallback;
+
+  //----------------------------------------------------------------------------
+  // Constructor - spawns nloops event loop threads. Each loop keeps at most
+  // maxHostConnections connections per endpoint, 0 for no limit; further
+  // transfers wait for one to be available.
+  //----------------------------------------------------------------------------
+  CurlMultiEngine(size_t nloops, long maxHostConnections = 0);
+
+  //----------------------------------------------------------------------------
+  // Destructor - stops and joins all event loops.
+  //----------------------------------------------------------------------------
+  virtual ~CurlMultiEngine();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  CurlMultiEngine(const CurlMultiEngine& other) = delete;
+  CurlMultiEngine& operator=(const CurlMultiEngine& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Start driving the given, fully configured easy handle. Handles with the
+  // same non-empty affinity key are driven by the same loop, and can thus
+  // share its connections - an empty key spreads handles over the loops.
+  //----------------------------------------------------------------------------
+  void addHandle(CURL *handle, CompletionCallback callback, const std::string &affinity = std::string());
+
+  //----------------------------------------------------------------------------
+  // Stop driving the given easy handle. Blocks until the event loop has
+  // released it, after which no more callbacks will be invoked for it.
+  //----------------------------------------------------------------------------
+  void removeHandle(CURL *handle);
+
+  //----------------------------------------------------------------------------
+  // Resume a transfer paused by its write callback.
+  //----------------------------------------------------------------------------
+  void unpauseHandle(CURL *handle);
+
+  //----------------------------------------------------------------------------
+  // Number of event loops
+  //----------------------------------------------------------------------------
+  size_t getLoopCount() const;
+
+  //----------------------------------------------------------------------------
+  // Number of event loops requested through DAVIX_CURL_EVENT_LOOP, or 0 if
+  // the shared event loop is disabled.
+  //----------------------------------------------------------------------------
+  static size_t getLoopCountFromEnv();
+
+private:
+  //----------------------------------------------------------------------------
+  // Find the event loop driving the given handle
+  //----------------------------------------------------------------------------
+  CurlEventLoop* findLoop(CURL *handle);
+
+  std::vector<std::unique_ptr<CurlEventLoop> > _loops;
+  std::atomic<size_t> _next_loop;
+
+  std::mutex _assignment_mtx;
+  std::map<CURL*, CurlEventLoop*> _assignment;
+};
+
+}
+
+#endif
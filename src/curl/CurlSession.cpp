@@ -20,6 +20,7 @@
 */
 
 #include "CurlSession.hpp"
+#include "CurlSessionFactory.hpp"
 #include <curl/curl.h>
 #include <params/davixrequestparams.hpp>
 #include <mutex>
@@ -50,8 +51,10 @@ CurlHandle::~CurlHandle() {
 //------------------------------------------------------------------------------
 // CurlHandle: Constructor
 //------------------------------------------------------------------------------
-CurlHandle::CurlHandle(const std::string &k, CURLM *mh, CURL *h) : key(k), mhandle(mh), handle(h) {
-  curl_multi_add_handle(mhandle, handle);
+CurlHandle::CurlHandle(const std::string &k, CURLM *mh, CURL *h) : key(k), mhandle(mh), handle(h), resolve_entries(false) {
+  if(mhandle) {
+    curl_multi_add_handle(mhandle, handle);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -63,14 +66,31 @@ void CurlHandle::renewHandle() {
   }
 
   handle = curl_easy_init();
-  curl_multi_add_handle(mhandle, handle);
+
+  if(mhandle) {
+    curl_multi_add_handle(mhandle, handle);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Release curl handle
+//------------------------------------------------------------------------------
+void CurlHandle::releaseHandle() {
+  if(handle) {
+    if(mhandle) {
+      curl_multi_remove_handle(mhandle, handle);
+    }
+
+    curl_easy_cleanup(handle);
+    handle = NULL;
+  }
 }
 
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
 CurlSession::CurlSession(CurlSessionFactory &f, CurlHandlePtr h, const Uri & uri, const RequestParams & p, Status &st)
-: _factory(f), _handle(h) {
+: _factory(f), _handle(h), _session_recycling(f.getSessionCaching() && p.getKeepAlive()) {
 
   configureSession(p, st);
 }
@@ -78,7 +98,11 @@ CurlSession::CurlSession(CurlSessionFactory &f, CurlHandlePtr h, const Uri & uri
 //------------------------------------------------------------------------------
 // Destructor
 //------------------------------------------------------------------------------
-CurlSession::~CurlSession() {}
+CurlSession::~CurlSession() {
+  if(_session_recycling) {
+    _factory.storeHandle(std::move(_handle));
+  }
+}
 
 //------------------------------------------------------------------------------
 // Configure session
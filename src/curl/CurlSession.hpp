@@ -40,12 +40,14 @@ class Status;
 //------------------------------------------------------------------------------
 struct CurlHandle {
   std::string key;
-  CURLM *mhandle;
+  CURLM *mhandle; // NULL when driven by the shared CurlMultiEngine
   CURL *handle;
+  bool resolve_entries; // the DNS cache of mhandle holds addresses we gave
 
   void renewHandle();
+  void releaseHandle(); // drops the easy handle, the multi handle keeps its connections
   CurlHandle(const std::string &k, CURLM *mh, CURL *h);
-  CurlHandle() : mhandle(NULL), handle(NULL) {}
+  CurlHandle() : mhandle(NULL), handle(NULL), resolve_entries(false) {}
   ~CurlHandle();
 };
 
@@ -71,6 +73,13 @@ public:
     return _handle.get();
   }
 
+  //----------------------------------------------------------------------------
+  // Do not give the handle back to the factory once done
+  //----------------------------------------------------------------------------
+  void doNotReuseSession() {
+    _session_recycling = false;
+  }
+
 private:
   //----------------------------------------------------------------------------
   // Configure session
@@ -79,6 +88,7 @@ private:
 
   CurlSessionFactory &_factory;
   CurlHandlePtr _handle;
+  bool _session_recycling;
 };
 
 }
@@ -21,6 +21,7 @@
 
 #include "CurlSessionFactory.hpp"
 #include "CurlSession.hpp"
+#include "CurlMultiEngine.hpp"
 #include <backend/SessionFactory.hpp>
 #include <curl/curl.h>
 
@@ -28,6 +29,51 @@
 
 namespace Davix {
 
+//------------------------------------------------------------------------------
+// Connections per endpoint of the HTTP/2 event loops, each one multiplexing
+// as many streams as the server allows
+//------------------------------------------------------------------------------
+static const long kHttp2MaxHostConnections = 4;
+
+//------------------------------------------------------------------------------
+// TLS sessions and DNS cache shared by the handles of a factory, which may
+// run concurrently from many threads.
+//
+// While the address book balances connections, the DNS cache is not shared:
+// every handle gets the addresses of its requests, in its own order, into
+// the cache of its own event loop.
+//
+// Connections are not shared this way, as libcurl does not support using a
+// shared connection cache from concurrent threads: handles on the same
+// event loop share that loop's connections instead.
+//------------------------------------------------------------------------------
+struct CurlShare {
+  CurlShare(bool shareDns) : handle(curl_share_init()) {
+    curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, lock);
+    curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, unlock);
+    curl_share_setopt(handle, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    if(shareDns) {
+      curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    }
+  }
+
+  ~CurlShare() {
+    curl_share_cleanup(handle);
+  }
+
+  static void lock(CURL *h, curl_lock_data data, curl_lock_access access, void *userptr) {
+    static_cast<CurlShare*>(userptr)->locks[data].lock();
+  }
+
+  static void unlock(CURL *h, curl_lock_data data, void *userptr) {
+    static_cast<CurlShare*>(userptr)->locks[data].unlock();
+  }
+
+  CURLSH *handle;
+  std::mutex locks[CURL_LOCK_DATA_LAST];
+};
+
 //------------------------------------------------------------------------------
 // Check if session caching is disabled from environment variables
 //------------------------------------------------------------------------------
@@ -38,7 +84,14 @@ static bool isSessionCachingDisabled(){
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
-CurlSessionFactory::CurlSessionFactory() : _session_caching(!isSessionCachingDisabled()) {}
+CurlSessionFactory::CurlSessionFactory() : _share(new CurlShare(!AddressBook::isActiveByDefault())), _session_caching(!isSessionCachingDisabled()),
+  _session_pool(SessionPool<CurlHandlePtr>::getDefaultMaxIdlePerHost(), SessionPool<CurlHandlePtr>::getDefaultIdleTTL()),
+  _addresses(AddressBook::isActiveByDefault(), AddressBook::getDefaultTTL()) {
+  size_t nloops = CurlMultiEngine::getLoopCountFromEnv();
+  if(nloops != 0) {
+    _multi_engine.reset(new CurlMultiEngine(nloops));
+  }
+}
 
 //------------------------------------------------------------------------------
 // Destructor
@@ -60,6 +113,7 @@ std::unique_ptr<CurlSession> CurlSessionFactory::provideCurlSession(const Uri &u
     return out;
   }
 
+  out->doNotReuseSession();
   out.reset();
   handle.reset();
 
@@ -68,6 +122,18 @@ std::unique_ptr<CurlSession> CurlSessionFactory::provideCurlSession(const Uri &u
   return out;
 }
 
+//------------------------------------------------------------------------------
+// Store a handle for reuse of the connections cached in its multi handle
+//------------------------------------------------------------------------------
+void CurlSessionFactory::storeHandle(CurlHandlePtr handle) {
+  // handles driven by an engine keep nothing: connections live in its loops
+  if(handle && handle->mhandle) {
+    handle->releaseHandle();
+    const std::string key = handle->key;
+    _session_pool.insert(key, std::move(handle));
+  }
+}
+
 //------------------------------------------------------------------------------
 // Set caching on or off
 //------------------------------------------------------------------------------
@@ -84,6 +150,29 @@ bool CurlSessionFactory::getSessionCaching() const {
   return _session_caching;
 }
 
+//------------------------------------------------------------------------------
+// Get the event loop engine driving requests with the given params
+//------------------------------------------------------------------------------
+CurlMultiEngine* CurlSessionFactory::getMultiEngine(const RequestParams &params) {
+  if(!params.getHttp2()) {
+    return _multi_engine.get();
+  }
+
+  // Once the streams of the first connection to an endpoint are exhausted,
+  // every waiting transfer would otherwise open a connection of its own
+  std::call_once(_http2_engine_once, [this]() {
+    _http2_engine.reset(new CurlMultiEngine(CurlMultiEngine::getLoopCountFromEnv(), kHttp2MaxHostConnections));
+  });
+  return _http2_engine.get();
+}
+
+//------------------------------------------------------------------------------
+// Get the share handle of all handles created by this factory
+//------------------------------------------------------------------------------
+CURLSH* CurlSessionFactory::getShareHandle() {
+  return _share->handle;
+}
+
 //------------------------------------------------------------------------------
 // Retrieve cached handle, if possible
 //------------------------------------------------------------------------------
@@ -91,6 +180,10 @@ CurlHandlePtr CurlSessionFactory::getCachedHandle(const Uri &uri, const RequestP
   CurlHandlePtr out;
   std::string sessionKey = SessionFactory::makeSessionKey(uri);
 
+  if(getMultiEngine(params)) {
+    return out;
+  }
+
   if(_session_pool.retrieve(sessionKey, out)) {
     out->renewHandle();
   }
@@ -105,7 +198,11 @@ CurlHandlePtr CurlSessionFactory::makeNewHandle(const Uri &uri, const RequestPar
   std::string sessionKey = SessionFactory::makeSessionKey(uri);
 
   CURL *handle = curl_easy_init();
-  CURLM *mhandle = curl_multi_init();
+  CURLM *mhandle = NULL;
+
+  if(!getMultiEngine(params)) {
+    mhandle = curl_multi_init();
+  }
 
   return CurlHandlePtr(new CurlHandle(sessionKey, mhandle, handle));
 }
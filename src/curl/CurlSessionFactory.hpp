@@ -24,14 +24,20 @@
 
 #include "../backend/SessionFactory.hpp"
 #include <status/DavixStatus.hpp>
+#include <core/AddressBook.hpp>
 #include <core/SessionPool.hpp>
+#include <mutex>
+
+typedef void CURLSH;
 
 namespace Davix {
 
 struct CurlHandle;
+struct CurlShare;
 typedef std::shared_ptr<CurlHandle> CurlHandlePtr;
 
 class CurlSession;
+class CurlMultiEngine;
 
 class CurlSessionFactory {
 public:
@@ -50,6 +56,11 @@ public:
     //--------------------------------------------------------------------------
     std::unique_ptr<CurlSession> provideCurlSession(const Uri &uri, const RequestParams &params, Status &st);
 
+    //--------------------------------------------------------------------------
+    // Store a handle for reuse of the connections cached in its multi handle
+    //--------------------------------------------------------------------------
+    void storeHandle(CurlHandlePtr handle);
+
     //--------------------------------------------------------------------------
     // Set caching on or off
     //--------------------------------------------------------------------------
@@ -60,7 +71,42 @@ public:
     //--------------------------------------------------------------------------
     bool getSessionCaching() const;
 
+    //--------------------------------------------------------------------------
+    // Get session pool hit / miss / eviction counters
+    //--------------------------------------------------------------------------
+    SessionPoolStats getSessionPoolStats() const {
+        return _session_pool.getStats();
+    }
+
+    //--------------------------------------------------------------------------
+    // Get the event loop engine driving requests with the given params -
+    // NULL if every handle drives its own multi handle.
+    //
+    // HTTP/2 requests always go through an engine of their own, as only
+    // handles sharing a multi handle can be multiplexed. It is started on
+    // first use, with as many loops as DAVIX_CURL_EVENT_LOOP asks for.
+    //--------------------------------------------------------------------------
+    CurlMultiEngine* getMultiEngine(const RequestParams &params);
+
+    //--------------------------------------------------------------------------
+    // Get the share handle of all handles created by this factory, through
+    // which they resume each other's TLS sessions and share DNS lookups.
+    //--------------------------------------------------------------------------
+    CURLSH* getShareHandle();
+
+    //--------------------------------------------------------------------------
+    // Get the addresses of the servers new connections are spread over
+    //--------------------------------------------------------------------------
+    AddressBook& getAddressBook() {
+        return _addresses;
+    }
+
 private:
+    //--------------------------------------------------------------------------
+    // Data shared between handles - declared first, as it has to outlive them
+    //--------------------------------------------------------------------------
+    std::unique_ptr<CurlShare> _share;
+
     //--------------------------------------------------------------------------
     // Retrieve cached handle, if possible
     //--------------------------------------------------------------------------
@@ -81,6 +127,22 @@ private:
     // Session pool
     //--------------------------------------------------------------------------
     SessionPool<CurlHandlePtr> _session_pool;
+
+    //--------------------------------------------------------------------------
+    // Shared event loop engine, if enabled
+    //--------------------------------------------------------------------------
+    std::unique_ptr<CurlMultiEngine> _multi_engine;
+
+    //--------------------------------------------------------------------------
+    // Event loop engine of HTTP/2 requests
+    //--------------------------------------------------------------------------
+    std::once_flag _http2_engine_once;
+    std::unique_ptr<CurlMultiEngine> _http2_engine;
+
+    //--------------------------------------------------------------------------
+    // Addresses of the servers, and how connecting to them goes
+    //--------------------------------------------------------------------------
+    AddressBook _addresses;
 };
 
 }
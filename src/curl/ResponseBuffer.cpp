@@ -27,16 +27,143 @@
 
 namespace Davix {
 
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ChunkPool::ChunkPool(size_t csize, size_t maxidle) : chunkSize(csize),
+    maxIdle(maxidle) {}
+
+//------------------------------------------------------------------------------
+// Get a chunk of chunkSize bytes, recycled if possible
+//------------------------------------------------------------------------------
+void ChunkPool::acquire(std::vector<char> &chunk) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if(!chunks.empty()) {
+      chunk.swap(chunks.back());
+      chunks.pop_back();
+      return;
+    }
+  }
+
+  chunk.resize(chunkSize);
+}
+
+//------------------------------------------------------------------------------
+// Give a chunk back to the pool, dropped if the pool is full
+//------------------------------------------------------------------------------
+void ChunkPool::release(std::vector<char> &chunk) {
+  if(chunk.size() != chunkSize) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mtx);
+  if(chunks.size() < maxIdle) {
+    chunks.emplace_back();
+    chunks.back().swap(chunk);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Chunk size served by this pool
+//------------------------------------------------------------------------------
+size_t ChunkPool::getChunkSize() const {
+  return chunkSize;
+}
+
+//------------------------------------------------------------------------------
+// Number of idle chunks
+//------------------------------------------------------------------------------
+size_t ChunkPool::idle() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return chunks.size();
+}
+
+//------------------------------------------------------------------------------
+// Process-wide pool of 16 KB chunks, keeping at most 8 MB idle
+//------------------------------------------------------------------------------
+ChunkPool& ChunkPool::getDefault() {
+  static ChunkPool pool(16384u, 512u);
+  return pool;
+}
+
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
 ResponseBuffer::ResponseBuffer(size_t bsize) : bufferSize(bsize), posWrite(0),
-    posRead(0) {}
+    posRead(0), pool(NULL), directTarget(NULL), directLen(0), directPos(0) {
+
+  if(bufferSize == ChunkPool::getDefault().getChunkSize()) {
+    pool = &ChunkPool::getDefault();
+  }
+}
 
 //------------------------------------------------------------------------------
 // Destructor
 //------------------------------------------------------------------------------
-ResponseBuffer::~ResponseBuffer() {}
+ResponseBuffer::~ResponseBuffer() {
+  while(!buffers.empty()) {
+    dropChunk();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Append a fresh chunk
+//------------------------------------------------------------------------------
+void ResponseBuffer::newChunk() {
+  buffers.emplace_back();
+
+  if(pool) {
+    pool->acquire(buffers.back());
+  }
+  else {
+    buffers.back().resize(bufferSize);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Drop the oldest chunk
+//------------------------------------------------------------------------------
+void ResponseBuffer::dropChunk() {
+  if(pool) {
+    pool->release(buffers.front());
+  }
+
+  buffers.pop_front();
+}
+
+//------------------------------------------------------------------------------
+// Deliver the next fed bytes into target, up to maxlen
+//------------------------------------------------------------------------------
+bool ResponseBuffer::setDirectTarget(char *target, size_t maxlen) {
+  if(size() != 0) {
+    return false;
+  }
+
+  directTarget = target;
+  directLen = maxlen;
+  directPos = 0;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Stop delivering into the direct target
+//------------------------------------------------------------------------------
+size_t ResponseBuffer::releaseDirectTarget() {
+  size_t written = directPos;
+
+  directTarget = NULL;
+  directLen = 0;
+  directPos = 0;
+  return written;
+}
+
+//------------------------------------------------------------------------------
+// Number of bytes written into the direct target so far
+//------------------------------------------------------------------------------
+size_t ResponseBuffer::directSize() const {
+  return directPos;
+}
 
 //------------------------------------------------------------------------------
 // Feed len bytes into the buffer
@@ -44,10 +171,18 @@ ResponseBuffer::~ResponseBuffer() {}
 void ResponseBuffer::feed(const char *buff, size_t len) {
   size_t buffPos = 0;
 
+  if(directTarget && directPos < directLen) {
+    size_t bytesToWrite = std::min(len, directLen - directPos);
+
+    ::memcpy(directTarget+directPos, buff, bytesToWrite);
+    buffPos += bytesToWrite;
+    len -= bytesToWrite;
+    directPos += bytesToWrite;
+  }
+
   while(len > 0) {
     if(buffers.size() == 0 || posWrite == bufferSize) {
-      buffers.emplace_back();
-      buffers.back().resize(bufferSize);
+      newChunk();
       posWrite = 0;
     }
 
@@ -76,7 +211,7 @@ size_t ResponseBuffer::consume(char *target, size_t maxlen) {
     }
 
     if(posRead == bufferSize) {
-      buffers.pop_front();
+      dropChunk();
       posRead = 0;
     }
 
@@ -24,12 +24,59 @@
 
 #include <vector>
 #include <deque>
+#include <mutex>
 #include <stddef.h>
 
 namespace Davix {
 
+//------------------------------------------------------------------------------
+// Thread-safe pool of fixed-size buffer chunks, so that response bodies do
+// not allocate and free a chunk for every few KB received. At most maxIdle
+// chunks are kept around.
+//------------------------------------------------------------------------------
+class ChunkPool {
+public:
+  ChunkPool(size_t chunkSize, size_t maxIdle);
+
+  //----------------------------------------------------------------------------
+  // Get a chunk of chunkSize bytes, recycled if possible
+  //----------------------------------------------------------------------------
+  void acquire(std::vector<char> &chunk);
+
+  //----------------------------------------------------------------------------
+  // Give a chunk back to the pool, dropped if the pool is full
+  //----------------------------------------------------------------------------
+  void release(std::vector<char> &chunk);
+
+  //----------------------------------------------------------------------------
+  // Chunk size served by this pool
+  //----------------------------------------------------------------------------
+  size_t getChunkSize() const;
+
+  //----------------------------------------------------------------------------
+  // Number of idle chunks
+  //----------------------------------------------------------------------------
+  size_t idle() const;
+
+  //----------------------------------------------------------------------------
+  // Process-wide pool of 16 KB chunks
+  //----------------------------------------------------------------------------
+  static ChunkPool& getDefault();
+
+private:
+  size_t chunkSize;
+  size_t maxIdle;
+
+  mutable std::mutex mtx;
+  std::vector<std::vector<char>> chunks;
+};
+
 //------------------------------------------------------------------------------
 // Utility class to buffer HTTP response body
+//
+// A reader waiting for data may lend its own buffer through
+// setDirectTarget: fed bytes are then copied straight into it, and only
+// what does not fit is buffered.
 //------------------------------------------------------------------------------
 class ResponseBuffer {
 public:
@@ -42,6 +89,23 @@ public:
   //----------------------------------------------------------------------------
   void feed(const char *buff, size_t len);
 
+  //----------------------------------------------------------------------------
+  // Deliver the next fed bytes into target, up to maxlen. Only possible
+  // while nothing is buffered, returns false otherwise.
+  //----------------------------------------------------------------------------
+  bool setDirectTarget(char *target, size_t maxlen);
+
+  //----------------------------------------------------------------------------
+  // Stop delivering into the direct target, return how many bytes were
+  // written into it.
+  //----------------------------------------------------------------------------
+  size_t releaseDirectTarget();
+
+  //----------------------------------------------------------------------------
+  // Number of bytes written into the direct target so far
+  //----------------------------------------------------------------------------
+  size_t directSize() const;
+
   //----------------------------------------------------------------------------
   // Consume a maximum of maxlen bytes out of the buffer
   //----------------------------------------------------------------------------
@@ -57,6 +121,15 @@ private:
   size_t bufferSize;
   size_t posWrite;
   size_t posRead;
+
+  ChunkPool *pool;
+
+  char *directTarget;
+  size_t directLen;
+  size_t directPos;
+
+  void newChunk();
+  void dropChunk();
 };
 
 }
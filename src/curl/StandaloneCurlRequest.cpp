@@ -22,6 +22,7 @@
 #include "StandaloneCurlRequest.hpp"
 #include "CurlSessionFactory.hpp"
 #include "CurlSession.hpp"
+#include "CurlMultiEngine.hpp"
 #include "HeaderlineParser.hpp"
 #include <utils/davix_logger_internal.hpp>
 #include <utils/stringutils.hpp>
@@ -34,6 +35,11 @@
 
 namespace Davix {
 
+//------------------------------------------------------------------------------
+// Keep some data cached inside the response buffer, but not too much
+//------------------------------------------------------------------------------
+static const size_t kMaxBufferedBytes = 33554432;
+
 static std::vector<std::string> split(std::string data, std::string token) {
   std::vector<std::string> output;
   size_t pos = std::string::npos;
@@ -173,6 +179,14 @@ static size_t write_callback(char *ptr, size_t size, size_t nmemb, void *userdat
   return bytes;
 }
 
+//------------------------------------------------------------------------------
+// Write callback, when driven by the shared event loop
+//------------------------------------------------------------------------------
+static size_t engine_write_callback(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  StandaloneCurlRequest* req = (StandaloneCurlRequest*) userdata;
+  return req->feedResponseBody(ptr, size * nmemb);
+}
+
 //------------------------------------------------------------------------------
 // Read callback
 //------------------------------------------------------------------------------
@@ -200,13 +214,16 @@ StandaloneCurlRequest::StandaloneCurlRequest(CurlSessionFactory &sessionFactory,
 : _session_factory(sessionFactory), _reuse_session(reuseSession), _bound_hooks(boundHooks),
   _uri(uri), _verb(verb), _params(params), _headers(headers), _req_flag(reqFlag),
   _content_provider(contentProvider), _deadline(deadline), _state(RequestState::kNotStarted),
-  _chunklist(NULL), _received_headers(false) {}
+  _chunklist(NULL), _resolvelist(NULL), _connection_reported(false), _received_headers(false), _engine(NULL), _attached(false),
+  _transfer_done(false), _transfer_paused(false), _response_code(0) {}
 
 //------------------------------------------------------------------------------
 // Destructor
 //------------------------------------------------------------------------------
 StandaloneCurlRequest::~StandaloneCurlRequest() {
+    detachFromEngine();
     curl_slist_free_all(_chunklist);
+    curl_slist_free_all(_resolvelist);
 }
 
 //------------------------------------------------------------------------------
@@ -323,16 +340,35 @@ Status StandaloneCurlRequest::startRequest() {
     return st;
   }
 
+  if(!_reuse_session) {
+    _session->doNotReuseSession();
+  }
+
   //----------------------------------------------------------------------------
   // Set request verb, target URL
   //----------------------------------------------------------------------------
   CURL* handle = _session->getHandle()->handle;
+  _engine = _session_factory.getMultiEngine(_params);
 
   Uri uriCopy(_uri);
   uriCopy.httpizeProtocol();
 
   curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, _verb.c_str());
   curl_easy_setopt(handle, CURLOPT_URL, uriCopy.getString().c_str());
+  curl_easy_setopt(handle, CURLOPT_SHARE, _session_factory.getShareHandle());
+  configureAddresses(handle);
+
+  //----------------------------------------------------------------------------
+  // Set up HTTP version: HTTP/2 transfers wait for a connection to the same
+  // endpoint to be known as multiplexed rather than opening their own
+  //----------------------------------------------------------------------------
+  if(_params.getHttp2()) {
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long) CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+  }
+  else {
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long) CURL_HTTP_VERSION_1_1);
+  }
 
   //----------------------------------------------------------------------------
   // Set up callback to consume response headers
@@ -343,8 +379,14 @@ Status StandaloneCurlRequest::startRequest() {
   //----------------------------------------------------------------------------
   // Set up callback to consume response body
   //----------------------------------------------------------------------------
-  curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_callback);
-  curl_easy_setopt(handle, CURLOPT_WRITEDATA, &_response_buffer);
+  if(_engine) {
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, engine_write_callback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, this);
+  }
+  else {
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &_response_buffer);
+  }
 
   //----------------------------------------------------------------------------
   // Set up callback to provide request body
@@ -441,6 +483,12 @@ Status StandaloneCurlRequest::startRequest() {
   //----------------------------------------------------------------------------
   _state = RequestState::kStarted;
 
+  if(_engine) {
+    _attached = true;
+    _engine->addHandle(handle, [this](int curlCode) { onTransferDone(curlCode); },
+      _params.getHttp2() ? _session->getHandle()->key : std::string());
+  }
+
   while(true) {
     int still_running = 1;
     Status st = performBlockingRound(still_running);
@@ -454,7 +502,7 @@ Status StandaloneCurlRequest::startRequest() {
       return checkErrors();
     }
 
-    if(_response_buffer.size() != 0u) {
+    if(bufferedBytes() != 0u) {
       //------------------------------------------------------------------------
       // We've dealt with the headers already, startRequest() is done. Switch
       // to readBlock() mode.
@@ -469,10 +517,21 @@ Status StandaloneCurlRequest::startRequest() {
 // Check internal mhandle errors
 //------------------------------------------------------------------------------
 Status StandaloneCurlRequest::checkErrors() {
+  if(_engine) {
+    std::lock_guard<std::mutex> lock(_transfer_mtx);
+    if(_transfer_done && !_transfer_status.ok()) {
+      sessionError = _transfer_status;
+      return sessionError;
+    }
+
+    return Status();
+  }
+
   CURLMsg *msg;
   int msgs_left = 0;
   while((msg = curl_multi_info_read(_session->getHandle()->mhandle, &msgs_left))) {
     if(msg->msg == CURLMSG_DONE && msg->data.result != CURLE_OK) {
+      reportConnection(msg->data.result);
       sessionError = curlCodeToStatus(msg->data.result);
       return sessionError;
     }
@@ -507,13 +566,17 @@ Status StandaloneCurlRequest::performBlockingRound(int &still_running) {
     return Status(davix_scope_http_request(), StatusCode::InvalidArgument, "Request not active");
   }
 
+  if(_engine) {
+    return waitForProgress(still_running);
+  }
+
   while(true) {
     Status st = checkTimeout();
     if(!st.ok()) {
       return st;
     }
 
-    size_t prevSize = _response_buffer.size();
+    size_t prevSize = _response_buffer.size() + _response_buffer.directSize();
 
     CURLM* mhandle = _session->getHandle()->mhandle;
     curl_multi_perform(mhandle, &still_running);
@@ -537,7 +600,7 @@ Status StandaloneCurlRequest::performBlockingRound(int &still_running) {
     // Was anything actually read? If so, our work here is done, we're
     // only supposed to do a single blocking round.
     //--------------------------------------------------------------------------
-    if(prevSize != _response_buffer.size()) {
+    if(prevSize != _response_buffer.size() + _response_buffer.directSize()) {
       return Status();
     }
 
@@ -568,20 +631,54 @@ dav_ssize_t StandaloneCurlRequest::readBlock(char* buffer, dav_size_t max_size,
   }
 
   //----------------------------------------------------------------------------
-  // Keep some data cached inside the response buffer, but not too much
+  // Keep some data cached inside the response buffer, but not too much.
+  // If nothing is buffered, incoming data is written straight into the
+  // caller's buffer.
   //----------------------------------------------------------------------------
-  if(_response_buffer.size() <= 33554432) {
+  if(bufferedBytes() <= kMaxBufferedBytes) {
+    {
+      std::lock_guard<std::mutex> lock(_transfer_mtx);
+      _response_buffer.setDirectTarget(buffer, max_size);
+    }
+
     int still_running = 0;
     st = performBlockingRound(still_running);
   }
 
-  return _response_buffer.consume(buffer, max_size);
+  if(!_engine) {
+    size_t direct = _response_buffer.releaseDirectTarget();
+    return direct + _response_buffer.consume(buffer + direct, max_size - direct);
+  }
+
+  //----------------------------------------------------------------------------
+  // Resume the transfer if the event loop paused it while we were behind
+  //----------------------------------------------------------------------------
+  dav_ssize_t consumed = 0;
+  bool resume = false;
+
+  {
+    std::lock_guard<std::mutex> lock(_transfer_mtx);
+    size_t direct = _response_buffer.releaseDirectTarget();
+    consumed = direct + _response_buffer.consume(buffer + direct, max_size - direct);
+
+    if(_transfer_paused && _response_buffer.size() <= kMaxBufferedBytes) {
+      _transfer_paused = false;
+      resume = true;
+    }
+  }
+
+  if(resume) {
+    _engine->unpauseHandle(_session->getHandle()->handle);
+  }
+
+  return consumed;
 }
 
 //------------------------------------------------------------------------------
 // Finish an already started request.
 //------------------------------------------------------------------------------
 Status StandaloneCurlRequest::endRequest() {
+  detachFromEngine();
   _state = RequestState::kFinished;
   return Status();
 }
@@ -612,6 +709,11 @@ Status StandaloneCurlRequest::checkTimeout() {
 int StandaloneCurlRequest::getStatusCode() const {
   long response_code = 0;
 
+  if(_engine) {
+    std::lock_guard<std::mutex> lock(_transfer_mtx);
+    return _response_code;
+  }
+
   if(_session) {
     CURL* handle = _session->getHandle()->handle;
     curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
@@ -624,7 +726,11 @@ int StandaloneCurlRequest::getStatusCode() const {
 // Do not re-use underlying session
 //------------------------------------------------------------------------------
 void StandaloneCurlRequest::doNotReuseSession() {
+  _reuse_session = false;
 
+  if(_session) {
+    _session->doNotReuseSession();
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -676,12 +782,119 @@ Status StandaloneCurlRequest::readResponseHeaders() {
   return Status();
 }
 
+//------------------------------------------------------------------------------
+// Point curl to the addresses of the server. curl races the first address
+// of each family against each other, then goes down the list.
+//
+// The entries go to the DNS cache of the event loop of the handle, which is
+// not shared with other handles while balancing. Requests driven by a shared
+// event loop would overwrite the entries of each other: curl resolves the
+// server for them, and picks among the connections of the loop.
+//------------------------------------------------------------------------------
+void StandaloneCurlRequest::configureAddresses(CURL *handle) {
+  // pooled handles still point to the list of their previous request
+  curl_easy_setopt(handle, CURLOPT_RESOLVE, (struct curl_slist*) NULL);
+
+  // with a proxy, the addresses of the server are none of our business
+  if(_params.getProxyServer() != NULL || _engine != NULL) {
+    return;
+  }
+
+  const std::string host = _uri.getHost();
+  const unsigned int port = httpUriGetPort(_uri);
+  const std::vector<std::string> addresses = _session_factory.getAddressBook().getAddresses(host, port);
+  CurlHandle* curlHandle = _session->getHandle();
+
+  if(addresses.empty()) {
+    // drop what a previous request left in the DNS cache of the handle,
+    // older versions of curl keep it forever
+    if(curlHandle->resolve_entries) {
+      std::ostringstream removal;
+      removal << "-" << host << ":" << port;
+      _resolvelist = curl_slist_append(_resolvelist, removal.str().c_str());
+      curl_easy_setopt(handle, CURLOPT_RESOLVE, _resolvelist);
+      curlHandle->resolve_entries = false;
+    }
+    return;
+  }
+
+  // entries expire from the DNS cache like resolved ones, rather than
+  // sticking to the addresses of the time
+  std::ostringstream entry;
+#if LIBCURL_VERSION_NUM >= 0x074b00
+  entry << "+";
+#endif
+  entry << host << ":" << port << ":";
+  for(size_t i = 0; i < addresses.size(); i++) {
+    if(i != 0) {
+      entry << ",";
+    }
+
+    if(addresses[i].find(':') != std::string::npos) {
+      entry << "[" << addresses[i] << "]";
+    }
+    else {
+      entry << addresses[i];
+    }
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_HTTP, "connect to {} through {} first, out of {} addresses", host, addresses[0], addresses.size());
+  _preferred_address = addresses[0];
+  _resolvelist = curl_slist_append(_resolvelist, entry.str().c_str());
+  curl_easy_setopt(handle, CURLOPT_RESOLVE, _resolvelist);
+  curlHandle->resolve_entries = true;
+}
+
+//------------------------------------------------------------------------------
+// Tell the address book how connecting went. Requests going through an
+// already established connection have nothing to tell.
+//------------------------------------------------------------------------------
+void StandaloneCurlRequest::reportConnection(int curlCode) {
+  if(_connection_reported || _preferred_address.empty()) {
+    return;
+  }
+  _connection_reported = true;
+
+  CURL* handle = _session->getHandle()->handle;
+  AddressBook &book = _session_factory.getAddressBook();
+  const std::string host = _uri.getHost();
+  const unsigned int port = httpUriGetPort(_uri);
+
+  long connects = 0;
+  curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+
+  if(connects > 0) {
+    char *ip = NULL;
+    curl_off_t lookup = 0, connect = 0;
+    curl_easy_getinfo(handle, CURLINFO_PRIMARY_IP, &ip);
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME_T, &lookup);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect);
+
+    if(ip != NULL && ip[0] != '\0') {
+      book.reportSuccess(host, port, ip, std::chrono::microseconds(std::max<curl_off_t>(0, connect - lookup)));
+    }
+  }
+  else if(curlCode == CURLE_COULDNT_CONNECT || curlCode == CURLE_OPERATION_TIMEDOUT) {
+    book.reportFailure(host, port, _preferred_address);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Feed response header
 //------------------------------------------------------------------------------
 void StandaloneCurlRequest::feedResponseHeader(const std::string &header) {
   if(header == "\r\n") {
     _received_headers = true;
+    reportConnection(CURLE_OK);
+
+    if(_engine) {
+      long response_code = 0;
+      curl_easy_getinfo(_session->getHandle()->handle, CURLINFO_RESPONSE_CODE, &response_code);
+
+      std::lock_guard<std::mutex> lock(_transfer_mtx);
+      _response_code = response_code;
+    }
+
     return;
   }
 
@@ -690,4 +903,89 @@ void StandaloneCurlRequest::feedResponseHeader(const std::string &header) {
 }
 
 
+//------------------------------------------------------------------------------
+// Feed response body, when driven by the shared event loop
+//------------------------------------------------------------------------------
+size_t StandaloneCurlRequest::feedResponseBody(const char *ptr, size_t bytes) {
+  std::lock_guard<std::mutex> lock(_transfer_mtx);
+
+  if(_response_buffer.size() > kMaxBufferedBytes) {
+    _transfer_paused = true;
+    return CURL_WRITEFUNC_PAUSE;
+  }
+
+  _response_buffer.feed(ptr, bytes);
+  _transfer_cv.notify_all();
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+// Transfer has completed - called from the event loop thread, after the
+// handle has been released from the multi handle.
+//------------------------------------------------------------------------------
+void StandaloneCurlRequest::onTransferDone(int curlCode) {
+  long response_code = 0;
+  curl_easy_getinfo(_session->getHandle()->handle, CURLINFO_RESPONSE_CODE, &response_code);
+  reportConnection(curlCode);
+
+  std::lock_guard<std::mutex> lock(_transfer_mtx);
+  _transfer_done = true;
+  _transfer_status = curlCodeToStatus((CURLcode) curlCode);
+  _response_code = response_code;
+  _transfer_cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Wait for the event loop to make progress on our transfer: either some
+// response data is available, or the transfer is over.
+//------------------------------------------------------------------------------
+Status StandaloneCurlRequest::waitForProgress(int &still_running) {
+  std::unique_lock<std::mutex> lock(_transfer_mtx);
+
+  while(!_transfer_done && _response_buffer.size() == 0u && _response_buffer.directSize() == 0u) {
+    if(!_deadline.isValid()) {
+      _transfer_cv.wait(lock);
+      continue;
+    }
+
+    uint64_t remaining = getRemainingMs();
+    if(remaining == 0 || _transfer_cv.wait_for(lock, std::chrono::milliseconds(remaining)) == std::cv_status::timeout) {
+      lock.unlock();
+      Status st = checkTimeout();
+      if(!st.ok()) {
+        return st;
+      }
+
+      lock.lock();
+    }
+  }
+
+  still_running = _transfer_done ? 0 : 1;
+
+  if(_transfer_done && !_transfer_status.ok()) {
+    sessionError = _transfer_status;
+    return _transfer_status;
+  }
+
+  return Status();
+}
+
+//------------------------------------------------------------------------------
+// Release our handle from the event loop, if attached
+//------------------------------------------------------------------------------
+void StandaloneCurlRequest::detachFromEngine() {
+  if(_engine && _attached) {
+    _engine->removeHandle(_session->getHandle()->handle);
+    _attached = false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Number of bytes waiting in the response buffer
+//------------------------------------------------------------------------------
+size_t StandaloneCurlRequest::bufferedBytes() {
+  std::lock_guard<std::mutex> lock(_transfer_mtx);
+  return _response_buffer.size();
+}
+
 }
@@ -27,14 +27,18 @@
 #include <backend/StandaloneRequest.hpp>
 #include <backend/BoundHooks.hpp>
 #include <params/davixrequestparams.hpp>
+#include <condition_variable>
+#include <mutex>
 
 struct curl_slist;
+typedef void CURL;
 
 namespace Davix {
 
 class CurlSessionFactory;
 class ContentProvider;
 class CurlSession;
+class CurlMultiEngine;
 
 //------------------------------------------------------------------------------
 // Implementation of StandaloneRequest interface based on libcurl.
@@ -122,6 +126,13 @@ public:
   //----------------------------------------------------------------------------
   void feedResponseHeader(const std::string &header);
 
+  //----------------------------------------------------------------------------
+  // Feed response body, when driven by the shared event loop. Returns the
+  // number of bytes consumed, or CURL_WRITEFUNC_PAUSE if the reader is too
+  // far behind.
+  //----------------------------------------------------------------------------
+  size_t feedResponseBody(const char *ptr, size_t bytes);
+
 private:
   CurlSessionFactory &_session_factory;
   bool _reuse_session;
@@ -159,6 +170,26 @@ private:
   //----------------------------------------------------------------------------
   struct curl_slist *_chunklist;
 
+  //----------------------------------------------------------------------------
+  // Addresses a new connection may go to, the one we would like it to use,
+  // and whether the outcome has been reported to the address book
+  //----------------------------------------------------------------------------
+  struct curl_slist *_resolvelist;
+  std::string _preferred_address;
+  bool _connection_reported;
+
+  //----------------------------------------------------------------------------
+  // Point curl to the addresses of the server, in the order the address
+  // book gives
+  //----------------------------------------------------------------------------
+  void configureAddresses(CURL *handle);
+
+  //----------------------------------------------------------------------------
+  // Tell the address book how connecting went, once the request has either
+  // received its response headers or failed
+  //----------------------------------------------------------------------------
+  void reportConnection(int curlCode);
+
   //----------------------------------------------------------------------------
   // Response variables
   //----------------------------------------------------------------------------
@@ -177,6 +208,40 @@ private:
   //----------------------------------------------------------------------------
   Status performBlockingRound(int &still_running);
 
+  //----------------------------------------------------------------------------
+  // Shared event loop state - only used when the session factory provides a
+  // CurlMultiEngine. The event loop thread feeds _response_buffer and wakes
+  // up the reader through _transfer_cv.
+  //----------------------------------------------------------------------------
+  CurlMultiEngine *_engine;
+  bool _attached;
+  mutable std::mutex _transfer_mtx;
+  std::condition_variable _transfer_cv;
+  bool _transfer_done;
+  bool _transfer_paused;
+  Status _transfer_status;
+  long _response_code;
+
+  //----------------------------------------------------------------------------
+  // Transfer has completed - called from the event loop thread
+  //----------------------------------------------------------------------------
+  void onTransferDone(int curlCode);
+
+  //----------------------------------------------------------------------------
+  // Wait for the event loop to make progress on our transfer
+  //----------------------------------------------------------------------------
+  Status waitForProgress(int &still_running);
+
+  //----------------------------------------------------------------------------
+  // Release our handle from the event loop, if attached
+  //----------------------------------------------------------------------------
+  void detachFromEngine();
+
+  //----------------------------------------------------------------------------
+  // Number of bytes waiting in the response buffer
+  //----------------------------------------------------------------------------
+  size_t bufferedBytes();
+
 };
 
 //------------------------------------------------------------------------------
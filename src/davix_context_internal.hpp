@@ -35,12 +35,25 @@ namespace Davix {
 
 class RedirectionResolver;
 class SessionFactory;
+class Executor;
+class HostCapabilityCache;
+class BlockCache;
+class DiskCache;
+class StatCache;
 
 
 struct ContextExplorer{
 
 static SessionFactory & SessionFactoryFromContext(Context & c);
 static RedirectionResolver & RedirectionResolverFromContext(Context &c);
+static Executor & ExecutorFromContext(Context &c);
+static HostCapabilityCache & HostCapabilitiesFromContext(Context &c);
+static BlockCache & BlockCacheFromContext(Context &c);
+static DiskCache & DiskCacheFromContext(Context &c);
+static StatCache & StatCacheFromContext(Context &c);
+
+// replace the executor of an idle context, for tests
+static void SetExecutorThreads(Context &c, size_t maxThreads);
 
 };
 
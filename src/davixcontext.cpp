@@ -28,6 +28,12 @@
 #include <backend/SessionFactory.hpp>
 #include <davix_context_internal.hpp>
 #include <core/RedirectionResolver.hpp>
+#include <core/Executor.hpp>
+#include <core/TaskGroup.hpp>
+#include <core/HostCapabilities.hpp>
+#include <core/BlockCache.hpp>
+#include <core/DiskCache.hpp>
+#include <core/StatCache.hpp>
 
 #include <curl/curl.h>
 
@@ -52,7 +58,12 @@ struct ContextInternal
     ContextInternal():
         _fsess(new SessionFactory()),
         _redirectionResolver(new RedirectionResolver(!redirCachingDisabled())),
-        _hook_list()
+        _hostCapabilities(new HostCapabilityCache(HostCapabilityCache::getDefaultTTL())),
+        _blockCache(new BlockCache(BlockCache::getDefaultBudget(), BlockCache::getDefaultBlockSize())),
+        _diskCache(new DiskCache(DiskCache::getDefaultDirectory(), DiskCache::getDefaultBudget())),
+        _statCache(new StatCache(StatCache::getDefaultTTL(), StatCache::getDefaultNegativeTTL())),
+        _hook_list(),
+        _executor(new Executor(Executor::getDefaultMaxThreads()))
     {
             DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CORE, "libdavix path {}, version: {}", getLibPath(), version());
     }
@@ -60,7 +71,12 @@ struct ContextInternal
     ContextInternal(const ContextInternal & orig) :
         _fsess(new SessionFactory()),
         _redirectionResolver(new RedirectionResolver(!redirCachingDisabled())),
-        _hook_list(orig._hook_list)
+        _hostCapabilities(new HostCapabilityCache(HostCapabilityCache::getDefaultTTL())),
+        _blockCache(new BlockCache(orig._blockCache->getBudget(), orig._blockCache->getBlockSize())),
+        _diskCache(new DiskCache(orig._diskCache->getDirectory(), orig._diskCache->getBudget())),
+        _statCache(new StatCache(orig._statCache->getTTL(), orig._statCache->getNegativeTTL())),
+        _hook_list(orig._hook_list),
+        _executor(new Executor(orig._executor->getMaxThreads()))
     {
     }
 
@@ -75,9 +91,35 @@ struct ContextInternal
         return _redirectionResolver.get();
     }
 
+    inline HostCapabilityCache* getHostCapabilities() {
+        return _hostCapabilities.get();
+    }
+
+    inline BlockCache* getBlockCache() {
+        return _blockCache.get();
+    }
+
+    inline DiskCache* getDiskCache() {
+        return _diskCache.get();
+    }
+
+    inline StatCache* getStatCache() {
+        return _statCache.get();
+    }
+
+    inline Executor* getExecutor() {
+        return _executor.get();
+    }
+
     std::unique_ptr<SessionFactory>  _fsess;
     std::unique_ptr<RedirectionResolver> _redirectionResolver;
+    std::unique_ptr<HostCapabilityCache> _hostCapabilities;
+    std::unique_ptr<BlockCache> _blockCache;
+    std::unique_ptr<DiskCache> _diskCache;
+    std::unique_ptr<StatCache> _statCache;
     HookList _hook_list;
+    // declared last: background work still queued may use the members above
+    std::unique_ptr<Executor> _executor;
 };
 
 ///////////////////////////////////////////////////////////////
@@ -122,6 +164,90 @@ bool Context::getSessionCaching() const{
 
 void Context::clearCache() {
   _intern->_fsess.reset(new SessionFactory());
+  _intern->_hostCapabilities->clear();
+  _intern->_blockCache->invalidatePrefix("");
+  _intern->_statCache->clear();
+}
+
+void Context::setBlockCacheSize(dav_size_t bytes) {
+  _intern->_blockCache->setBudget(bytes);
+}
+
+dav_size_t Context::getBlockCacheSize() const {
+  return _intern->_blockCache->getBudget();
+}
+
+void Context::setDiskCache(const std::string & directory, dav_size_t bytes) {
+  _intern->_diskCache->configure(directory, bytes);
+}
+
+std::string Context::getDiskCacheDirectory() const {
+  return _intern->_diskCache->getDirectory();
+}
+
+void Context::setStatCacheTTL(int ttl, int negative_ttl) {
+  _intern->_statCache->setTTL(std::chrono::seconds(std::max(0, ttl)), std::chrono::seconds(std::max(0, negative_ttl)));
+}
+
+int Context::getStatCacheTTL() const {
+  return _intern->_statCache->getTTL().count();
+}
+
+int Context::prewarm(const Uri & uri, int n, const RequestParams* params, DavixError** err) {
+  RequestParams p(params);
+  if(n <= 0) {
+    return 0;
+  }
+
+  if(!getSessionCaching() || !p.getKeepAlive()) {
+    DavixError::setupError(err, davix_scope_http_request(), StatusCode::InvalidArgument,
+      "Connections can not be kept without session caching and keep-alive");
+    return -1;
+  }
+
+  std::mutex mtx;
+  int opened = 0;
+  DavixError* firstErr = NULL;
+
+  // requests keep their connection busy until all of them are done, so that
+  // none of them reuses the connection of another one
+  std::vector<std::unique_ptr<HttpRequest> > requests;
+  for(int i = 0; i < n; i++) {
+    requests.emplace_back(new HttpRequest(*this, uri, NULL));
+    requests.back()->setParameters(p);
+    requests.back()->setRequestMethod("HEAD");
+  }
+
+  // the caller runs requests too, it may be a worker of a busy executor
+  TaskGroup group(ContextExplorer::ExecutorFromContext(*this), n - 1);
+  for(int i = 0; i < n; i++) {
+    HttpRequest* req = requests[i].get();
+    group.add([req, &mtx, &opened, &firstErr]() {
+      DavixError* reqErr = NULL;
+      req->executeRequest(&reqErr);
+
+      std::lock_guard<std::mutex> lock(mtx);
+      if(reqErr == NULL) {
+        opened++;
+      }
+      else if(firstErr == NULL) {
+        std::swap(firstErr, reqErr);
+      }
+      DavixError::clearError(&reqErr);
+    });
+  }
+
+  group.wait();
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CORE, "Prewarmed {} of {} connections to {}", opened, n, uri.getString());
+
+  if(opened == 0) {
+    DavixError::propagateError(err, firstErr);
+    return -1;
+  }
+
+  DavixError::clearError(&firstErr);
+  return opened;
 }
 
 HttpRequest* Context::createRequest(const std::string & url, DavixError** err){
@@ -154,6 +280,30 @@ RedirectionResolver & ContextExplorer::RedirectionResolverFromContext(Context &c
     return *c._intern->getRedirectionResolver();
 }
 
+Executor & ContextExplorer::ExecutorFromContext(Context &c) {
+    return *c._intern->getExecutor();
+}
+
+HostCapabilityCache & ContextExplorer::HostCapabilitiesFromContext(Context &c) {
+    return *c._intern->getHostCapabilities();
+}
+
+BlockCache & ContextExplorer::BlockCacheFromContext(Context &c) {
+    return *c._intern->getBlockCache();
+}
+
+DiskCache & ContextExplorer::DiskCacheFromContext(Context &c) {
+    return *c._intern->getDiskCache();
+}
+
+void ContextExplorer::SetExecutorThreads(Context &c, size_t maxThreads) {
+    c._intern->_executor.reset(new Executor(maxThreads));
+}
+
+StatCache & ContextExplorer::StatCacheFromContext(Context &c) {
+    return *c._intern->getStatCache();
+}
+
 LibPath::LibPath(){
     Dl_info shared_lib_infos;
 
@@ -20,6 +20,7 @@
 */
 
 #include "AzureIO.hpp"
+#include "ChunkedUpload.hpp"
 #include <utils/davix_logger_internal.hpp>
 #include <core/ContentProvider.hpp>
 
@@ -51,6 +52,23 @@ static bool is_azure_operation(IOChainContext & context){
   return false;
 }
 
+// Azure blocks are at most 4000 MB, and a blob has at most 50000 blocks
+static dav_size_t get_azure_block_size(IOChainContext & context, dav_ssize_t size) {
+  const dav_size_t MAX_BLOCK_SIZE = 1024ULL * 1024 * 4000; // 4000 MB
+  const dav_size_t MAX_BLOCKS = 50000;
+
+  dav_size_t blockSize = context._reqparams->getMultipartUploadPartSize();
+  if(blockSize == 0) {
+    blockSize = 1024 * 1024 * 64; // 64 MB
+  }
+
+  if(size > 0) {
+    blockSize = std::max(blockSize, ((dav_size_t) size + MAX_BLOCKS - 1) / MAX_BLOCKS);
+  }
+
+  return std::min(blockSize, MAX_BLOCK_SIZE);
+}
+
 static std::string stringifyBlockID(const std::string &prefix, size_t blockid) {
   std::string strblockid = SSTR(prefix << "+" << std::setfill('0') << std::setw(10) << blockid); // TODO ensure fixed size
   return Base64::base64_encode( (unsigned char*) strblockid.c_str(), strblockid.size());
@@ -128,33 +146,20 @@ dav_ssize_t AzureIO::writeFromProvider(IOChainContext & iocontext, ContentProvid
     CHAIN_FORWARD(writeFromProvider(iocontext, provider));
   }
 
-  std::vector<std::string> blockIDs;
-
   DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: size {}, splitting into blocks", provider.getSize());
-  std::vector<char> buffer;
-
-  const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 100; // 100 MB
-  buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
 
   // generate UUID to use as blockid prefix
   std::string prefix = get_uuid();
 
-  size_t blockid = 0;
-  size_t remaining = provider.getSize();
-  while(remaining > 0) {
-    size_t toRead = std::min( (dav_size_t) provider.getSize(), MAX_CHUNK_SIZE);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: toRead from cb {}", toRead);
+  ChunkedUploader uploader(iocontext, get_azure_block_size(iocontext, provider.getSize()));
+  size_t nblocks = uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    writeChunk(iocontext, buff, size, stringifyBlockID(prefix, index));
+  });
 
-    size_t bytesRead = provider.pullBytes(buffer.data(), toRead);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: bytesRead from cb {}", bytesRead);
-    if(bytesRead == 0) break; // EOF?
-
-    blockIDs.push_back(stringifyBlockID(prefix, blockid));
-    writeChunk(iocontext, buffer.data(), bytesRead, blockIDs.back());
-    blockid++;
-
-    remaining -= bytesRead;
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: remaining bytes {}", remaining);
+  // block ids only depend on the block index
+  std::vector<std::string> blockIDs;
+  for(size_t i = 0; i < nblocks; i++) {
+    blockIDs.push_back(stringifyBlockID(prefix, i));
   }
 
   // Now let's commit the blobs
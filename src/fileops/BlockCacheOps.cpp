@@ -0,0 +1,419 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "BlockCacheOps.hpp"
+#include <davix_context_internal.hpp>
+#include <core/DiskCache.hpp>
+#include <request/httprequest.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace Davix {
+
+namespace {
+
+// the server ignored the Range header
+struct NoRangeSupport {};
+
+// the server has another version of the file than the cached blocks, the
+// block fetched from it belongs to that version
+struct ValidatorChanged {
+  std::string validator;
+  dav_size_t index;
+  BlockCache::Block block;
+};
+
+// reads started over after the file changed, before giving up
+const int kMaxRestarts = 3;
+
+}
+
+static std::string uriPrefix(const Uri &uri) {
+  return uri.getString() + '\n';
+}
+
+// the block size is part of the key, the disk cache may be shared by
+// processes using different ones
+static std::string blockKey(const Uri &uri, const std::string &validator, dav_size_t blockSize, dav_size_t index) {
+  std::ostringstream ss;
+  ss << uriPrefix(uri) << validator << '\n' << blockSize << ':' << index;
+  return ss.str();
+}
+
+static std::string getAnswerValidator(const HttpRequest &req) {
+  std::string value;
+  if(req.getAnswerHeader("ETag", value) && !value.empty()) {
+    return value;
+  }
+
+  if(req.getAnswerHeader("Last-Modified", value) && !value.empty()) {
+    return "lm:" + value;
+  }
+
+  return std::string();
+}
+
+// "bytes <first>-<last>/<length>" of a single range answer
+static bool parseContentRange(const std::string &header, dav_off_t &first, dav_off_t &last) {
+  const char* p = header.c_str();
+  if(strncmp(p, "bytes ", 6) != 0) {
+    return false;
+  }
+
+  char* end = NULL;
+  first = strtoll(p + 6, &end, 10);
+  if(end == p + 6 || *end != '-') {
+    return false;
+  }
+
+  p = end + 1;
+  last = strtoll(p, &end, 10);
+  return end != p && *end == '/' && first >= 0 && last >= first;
+}
+
+BlockCacheOps::BlockCacheOps() : _validated(false), _bypass(false) {}
+
+BlockCacheOps::~BlockCacheOps() {}
+
+std::string BlockCacheOps::getValidator(IOChainContext & iocontext, BlockCache & cache, DiskCache & disk) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_validated || (!disk.isEnabled() && !cache.containsPrefix(uriPrefix(iocontext._uri)))) {
+    return _validator;
+  }
+
+  // cached blocks may be stale, check what the server has now
+  DavixError * tmp_err = NULL;
+  HeadRequest req(iocontext._context, iocontext._uri, &tmp_err);
+  if(!tmp_err) {
+    req.setParameters(iocontext._reqparams);
+    req.executeRequest(&tmp_err);
+  }
+
+  if(!tmp_err && httpcodeIsValid(req.getRequestCode())) {
+    _validator = getAnswerValidator(req);
+    _validated = true;
+    _bypass = _validator.empty();
+  }
+  else {
+    // let the regular read path report the problem
+    DavixError::clearError(&tmp_err);
+    _bypass = true;
+  }
+
+  return _validator;
+}
+
+BlockCache::Block BlockCacheOps::fetchBlock(IOChainContext & iocontext, dav_off_t offset, dav_size_t size, std::string & validator) {
+  DavixError * tmp_err = NULL;
+  GetRequest req(iocontext._context, iocontext._uri, &tmp_err);
+  checkDavixError(&tmp_err);
+
+  std::ostringstream range;
+  range << "bytes=" << offset << "-" << (offset + size - 1);
+  req.setParameters(iocontext._reqparams);
+  req.addHeaderField("Range", range.str());
+
+  req.beginRequest(&tmp_err);
+  checkDavixError(&tmp_err);
+
+  std::shared_ptr<std::vector<char> > block(new std::vector<char>());
+  const int code = req.getRequestCode();
+
+  if(code == 416) { // past the end of the file
+    validator = getAnswerValidator(req);
+    req.endRequest(NULL);
+    return block;
+  }
+
+  if(code == 200) {
+    req.endRequest(NULL);
+    throw NoRangeSupport();
+  }
+
+  if(code != 206) {
+    httpcodeToDavixError(code, davix_scope_io_buff(), "read error: ", &tmp_err);
+    checkDavixError(&tmp_err);
+  }
+
+  // anything but the requested block, or its end, would be cached as it
+  std::string header;
+  dav_off_t first = 0, last = 0;
+  if(!req.getAnswerHeader("Content-Range", header) || !parseContentRange(header, first, last) ||
+     first != offset || last > (dav_off_t) (offset + size - 1)) {
+    req.endRequest(NULL);
+    throw DavixException(davix_scope_io_buff(), StatusCode::InvalidServerResponse,
+      fmt::format("Unexpected Content-Range \"{}\" for {}", header, range.str()));
+  }
+
+  validator = getAnswerValidator(req);
+  const dav_size_t expected = last - first + 1;
+  block->resize(expected);
+
+  dav_size_t total = 0;
+  dav_ssize_t ret;
+  while(total < expected && (ret = req.readBlock(block->data() + total, expected - total, &tmp_err)) > 0) {
+    total += ret;
+  }
+  checkDavixError(&tmp_err);
+
+  if(total != expected) {
+    req.endRequest(NULL);
+    throw DavixException(davix_scope_io_buff(), StatusCode::InvalidServerResponse,
+      fmt::format("Block truncated, {} bytes out of {}", total, expected));
+  }
+
+  req.endRequest(&tmp_err);
+  checkDavixError(&tmp_err);
+  return block;
+}
+
+bool BlockCacheOps::isCachingReads(IOChainContext & iocontext) {
+  BlockCache & cache = ContextExplorer::BlockCacheFromContext(iocontext._context);
+  DiskCache & disk = ContextExplorer::DiskCacheFromContext(iocontext._context);
+  if(_bypass || (!cache.isEnabled() && !disk.isEnabled())) {
+    return false;
+  }
+
+  getValidator(iocontext, cache, disk);
+  return !_bypass;
+}
+
+dav_ssize_t BlockCacheOps::pread(IOChainContext & iocontext, void* buf, dav_size_t count, dav_off_t offset) {
+  BlockCache & cache = ContextExplorer::BlockCacheFromContext(iocontext._context);
+  DiskCache & disk = ContextExplorer::DiskCacheFromContext(iocontext._context);
+  if(_bypass || count == 0 || (!cache.isEnabled() && !disk.isEnabled())) {
+    return HttpIOChain::pread(iocontext, buf, count, offset);
+  }
+
+  std::string validator = getValidator(iocontext, cache, disk);
+  if(_bypass) {
+    return HttpIOChain::pread(iocontext, buf, count, offset);
+  }
+
+  const dav_size_t block_size = cache.getBlockSize();
+  char* out = static_cast<char*>(buf);
+  dav_size_t copied = 0;
+  int restarts = 0;
+
+  while(copied < count) {
+    const dav_off_t current = offset + copied;
+    const dav_size_t index = current / block_size;
+    const dav_off_t block_offset = index * block_size;
+
+    std::string fetched_validator;
+    BlockCache::Block block;
+
+    try {
+      if(validator.empty()) {
+        // first block of a cold file: learn the validator with it
+        block = fetchBlock(iocontext, block_offset, block_size, fetched_validator);
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        if(!_validated) {
+          _validator = fetched_validator;
+          _validated = true;
+          _bypass = _validator.empty();
+        }
+        else if(!fetched_validator.empty() && fetched_validator != _validator) {
+          throw ValidatorChanged{fetched_validator, index, block};
+        }
+        validator = _validator;
+
+        if(!_bypass) {
+          const std::string key = blockKey(iocontext._uri, validator, block_size, index);
+          BlockCache::Block fetched = block;
+          cache.get(key, [fetched]() { return fetched; });
+          disk.store(key, *block);
+          _last_key = key;
+          _last_block = block;
+        }
+      }
+      else {
+        const std::string key = blockKey(iocontext._uri, validator, block_size, index);
+        {
+          std::lock_guard<std::mutex> lock(_mtx);
+          if(_last_key == key) {
+            block = _last_block;
+          }
+        }
+
+        if(!block) {
+          // a block of another version is not cached under this one
+          block = cache.get(key, [&]() {
+            BlockCache::Block stored = disk.load(key);
+            if(stored) {
+              return stored;
+            }
+
+            BlockCache::Block fetched = fetchBlock(iocontext, block_offset, block_size, fetched_validator);
+            if(!fetched_validator.empty() && fetched_validator != validator) {
+              throw ValidatorChanged{fetched_validator, index, fetched};
+            }
+
+            if(fetched_validator == validator) {
+              disk.store(key, *fetched);
+            }
+            return fetched;
+          });
+        }
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        _last_key = key;
+        _last_block = block;
+      }
+    }
+    catch(ValidatorChanged &changed) {
+      // the file changed under our feet, what was copied so far belongs to
+      // the previous version: read everything again
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "{} changed, dropping its cached blocks", iocontext._uri);
+      cache.invalidatePrefix(uriPrefix(iocontext._uri));
+
+      {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _validator = validator = changed.validator;
+        _last_key = blockKey(iocontext._uri, validator, block_size, changed.index);
+        _last_block = changed.block;
+      }
+
+      if(++restarts > kMaxRestarts) {
+        throw DavixException(davix_scope_io_buff(), StatusCode::InvalidServerResponse,
+          fmt::format("{} keeps changing while being read", iocontext._uri));
+      }
+
+      copied = 0;
+      continue;
+    }
+    catch(NoRangeSupport &) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "No byte-range support for {}, not caching", iocontext._uri);
+      _bypass = true;
+      return copied + HttpIOChain::pread(iocontext, out + copied, count - copied, current);
+    }
+
+    const dav_size_t inblock = current - block_offset;
+    if(block->size() <= inblock) {
+      break; // end of file
+    }
+
+    const dav_size_t len = std::min<dav_size_t>(count - copied, block->size() - inblock);
+    memcpy(out + copied, block->data() + inblock, len);
+    copied += len;
+
+    if(block->size() < block_size) {
+      break; // short block, end of file
+    }
+  }
+
+  return copied;
+}
+
+dav_ssize_t BlockCacheOps::readFull(IOChainContext & iocontext, std::vector<char> & buffer) {
+  if(!isCachingReads(iocontext)) {
+    return HttpIOChain::readFull(iocontext, buffer);
+  }
+
+  const dav_size_t block_size = ContextExplorer::BlockCacheFromContext(iocontext._context).getBlockSize();
+  const size_t base = buffer.size();
+
+  try {
+    dav_ssize_t ret;
+    do {
+      const size_t offset = buffer.size() - base;
+      buffer.resize(base + offset + block_size);
+      ret = pread(iocontext, buffer.data() + base + offset, block_size, offset);
+      buffer.resize(base + offset + std::max<dav_ssize_t>(ret, 0));
+    } while(ret == (dav_ssize_t) block_size);
+  }
+  catch(...) {
+    buffer.resize(base);
+    throw;
+  }
+
+  return buffer.size() - base;
+}
+
+dav_ssize_t BlockCacheOps::readToFd(IOChainContext & iocontext, int fd, dav_size_t size) {
+  if(!isCachingReads(iocontext)) {
+    return HttpIOChain::readToFd(iocontext, fd, size);
+  }
+
+  if(iocontext.fdHandler.fd != fd) {
+    iocontext.fdHandler.fd = fd;
+    iocontext.fdHandler.bytes_written_to_fd = 0;
+  }
+
+  // resume after what a failed attempt already wrote
+  const dav_size_t block_size = ContextExplorer::BlockCacheFromContext(iocontext._context).getBlockSize();
+  std::vector<char> buffer(block_size);
+  dav_size_t total = 0;
+
+  while(size == 0 || total < size) {
+    const dav_size_t want = (size == 0) ? block_size : std::min<dav_size_t>(block_size, size - total);
+    const dav_ssize_t ret = pread(iocontext, buffer.data(), want, iocontext.fdHandler.bytes_written_to_fd);
+    if(ret <= 0) {
+      break;
+    }
+
+    const char* p = buffer.data();
+    dav_size_t left = ret;
+    while(left > 0) {
+      ssize_t written = ::write(fd, p, left);
+      if(written < 0 && errno == EINTR) {
+        continue;
+      }
+      if(written < 0) {
+        throw DavixException(davix_scope_io_buff(), StatusCode::SystemError,
+                             fmt::format("Impossible to write to fd: {}", strerror(errno)));
+      }
+
+      p += written;
+      left -= written;
+      iocontext.fdHandler.bytes_written_to_fd += written;
+    }
+
+    total += ret;
+    if((dav_size_t) ret < want) {
+      break; // end of file
+    }
+  }
+
+  return total;
+}
+
+dav_ssize_t BlockCacheOps::writeFromProvider(IOChainContext & iocontext, ContentProvider &provider) {
+  ContextExplorer::BlockCacheFromContext(iocontext._context).invalidatePrefix(uriPrefix(iocontext._uri));
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _validated = false;
+    _validator.clear();
+    _last_key.clear();
+    _last_block.reset();
+  }
+
+  return HttpIOChain::writeFromProvider(iocontext, provider);
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_BLOCK_CACHE_OPS_HPP
+#define DAVIX_FILEOPS_BLOCK_CACHE_OPS_HPP
+
+#include <fileops/httpiochain.hpp>
+#include <core/BlockCache.hpp>
+#include <core/DiskCache.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Serves pread from the Context block caches: in memory first, see
+// BlockCache, then on disk, see DiskCache. Blocks are keyed by URI,
+// validator (ETag, or Last-Modified) and block index.
+//
+// The validator is learned from the first block fetched through this
+// chain, or, when blocks of the file may already be cached, checked with
+// a HEAD request before using them. Files without a validator, or on servers
+// ignoring byte ranges, are not cached.
+//
+// Whole-file reads go block by block through the caches as well, so that
+// downloading a file again does not hit the server.
+//------------------------------------------------------------------------------
+class BlockCacheOps : public HttpIOChain {
+public:
+  BlockCacheOps();
+  virtual ~BlockCacheOps();
+
+  virtual bool isCachingReads(IOChainContext & iocontext);
+
+  virtual dav_ssize_t pread(IOChainContext & iocontext, void* buf, dav_size_t count, dav_off_t offset);
+
+  virtual dav_ssize_t readFull(IOChainContext & iocontext, std::vector<char> & buffer);
+
+  virtual dav_ssize_t readToFd(IOChainContext & iocontext, int fd, dav_size_t size);
+
+  virtual dav_ssize_t writeFromProvider(IOChainContext & iocontext, ContentProvider &provider);
+
+private:
+  std::mutex _mtx;
+  bool _validated;
+  std::atomic<bool> _bypass; // also read without _mtx
+  std::string _validator;
+
+  // last block used, small sequential reads mostly hit it again
+  std::string _last_key;
+  BlockCache::Block _last_block;
+
+  // validator to use for the given uri, empty if not known yet
+  std::string getValidator(IOChainContext & iocontext, BlockCache & cache, DiskCache & disk);
+
+  // fetch a block, and the validator it came with
+  BlockCache::Block fetchBlock(IOChainContext & iocontext, dav_off_t offset, dav_size_t size, std::string & validator);
+};
+
+}
+
+#endif
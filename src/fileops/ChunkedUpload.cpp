@@ -0,0 +1,246 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "ChunkedUpload.hpp"
+#include "httpiochain.hpp"
+#include <core/ContentProvider.hpp>
+#include <core/TaskGroup.hpp>
+#include <davix_context_internal.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Davix {
+
+namespace {
+
+struct PendingChunk {
+  size_t slot;
+  dav_size_t size;
+  size_t index;
+};
+
+//------------------------------------------------------------------------------
+// State shared between the reading thread and the chunk uploads
+//------------------------------------------------------------------------------
+struct UploadState {
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  std::vector<std::vector<char> > buffers;
+  std::deque<size_t> free_slots;
+
+  bool failed;
+  std::exception_ptr exc;
+
+  ChunkedUploader::ChunkWriter writer;
+  int max_attempts;
+  int retry_delay;
+
+  UploadState(size_t nbuffers, const ChunkedUploader::ChunkWriter &w, int attempts, int delay)
+  : buffers(nbuffers), failed(false), writer(w), max_attempts(attempts), retry_delay(delay) {
+    for(size_t i = 0; i < nbuffers; i++) {
+      free_slots.push_back(i);
+    }
+  }
+
+  // Upload the given chunk, unless another one failed already
+  void upload(const PendingChunk &chunk) {
+    std::exception_ptr error;
+    for(int attempt = 1; !hasFailed(); attempt++) {
+      try {
+        writer(buffers[chunk.slot].data(), chunk.size, chunk.index);
+        break;
+      }
+      catch(DavixException &e) {
+        if(attempt >= max_attempts || !isRecoverable(e) || hasFailed()) {
+          error = std::current_exception();
+          break;
+        }
+
+        DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Upload of chunk #{} failed: {}, attempt {} of {}",
+                   chunk.index, e.what(), attempt, max_attempts);
+      }
+      catch(...) {
+        error = std::current_exception();
+        break;
+      }
+
+      std::this_thread::sleep_for(std::chrono::seconds(retry_delay));
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    free_slots.push_back(chunk.slot);
+
+    if(error != std::exception_ptr()) {
+      fail(error);
+    }
+
+    cv.notify_all();
+  }
+
+  bool hasFailed() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return failed;
+  }
+
+  // same policy as AutoRetryOps, timeouts and permission errors are final
+  static bool isRecoverable(const DavixException &e) {
+    switch(e.code()) {
+      case StatusCode::RedirectionNeeded:
+      case StatusCode::OperationTimeout:
+      case StatusCode::ConnectionTimeout:
+      case StatusCode::PermissionRefused:
+        return false;
+      default:
+        return true;
+    }
+  }
+
+  // lock must be held
+  void fail(std::exception_ptr error) {
+    if(!failed) {
+      failed = true;
+      exc = error;
+    }
+  }
+};
+
+}
+
+ChunkedUploader::ChunkedUploader(Executor &executor, dav_size_t chunkSize, size_t maxInFlight)
+: _executor(executor), _chunk_size(std::max<dav_size_t>(1, chunkSize)),
+  _max_in_flight(std::max<size_t>(1, maxInFlight)), _max_attempts(1), _retry_delay(0) {}
+
+ChunkedUploader::ChunkedUploader(IOChainContext &iocontext, dav_size_t chunkSize)
+: ChunkedUploader(ContextExplorer::ExecutorFromContext(iocontext._context), chunkSize,
+                  iocontext._reqparams->getMultipartUploadParallelism()) {
+  setRetryPolicy(iocontext._reqparams->getOperationRetry(), iocontext._reqparams->getOperationRetryDelay());
+}
+
+void ChunkedUploader::setRetryPolicy(int maxAttempts, int retryDelay) {
+  _max_attempts = std::max(1, maxAttempts);
+  _retry_delay = std::max(0, retryDelay);
+}
+
+dav_size_t ChunkedUploader::fillChunk(char* buffer, dav_size_t size, ContentProvider &provider) {
+  dav_size_t written = 0;
+
+  while(written < size) {
+    dav_ssize_t bytesRead = provider.pullBytes(buffer + written, size - written);
+    if(bytesRead < 0) {
+      throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle, fmt::format("Error when reading from callback: {}", bytesRead));
+    }
+
+    if(bytesRead == 0) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Reached data provider EOF after {} bytes", written);
+      break;
+    }
+
+    written += bytesRead;
+  }
+
+  return written;
+}
+
+size_t ChunkedUploader::run(ContentProvider &provider, const ChunkWriter &writer) {
+  UploadState state(_max_in_flight + 1, writer, _max_attempts, _retry_delay);
+
+  dav_size_t bufferSize = _chunk_size;
+  if(provider.getSize() >= 0) {
+    bufferSize = std::min<dav_size_t>(bufferSize, std::max<dav_ssize_t>(1, provider.getSize()));
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Chunked upload: chunk size {}, up to {} chunks in flight", _chunk_size, _max_in_flight);
+
+  // workers only upload chunks, the caller does the reading
+  TaskGroup uploads(_executor, _max_in_flight - 1);
+  size_t nchunks = 0;
+  std::unique_lock<std::mutex> lock(state.mtx);
+
+  while(!state.failed) {
+    // no buffer to read into: upload a queued chunk ourselves, or wait
+    while(state.free_slots.empty() && !state.failed) {
+      lock.unlock();
+      const bool uploaded = uploads.runNext();
+      lock.lock();
+
+      if(!uploaded) {
+        state.cv.wait(lock, [&state]() { return !state.free_slots.empty() || state.failed; });
+      }
+    }
+
+    if(state.failed) {
+      break;
+    }
+
+    size_t slot = state.free_slots.front();
+    state.free_slots.pop_front();
+    lock.unlock();
+
+    std::vector<char> &buffer = state.buffers[slot];
+    buffer.resize(bufferSize);
+
+    dav_size_t bytesRead = 0;
+    std::exception_ptr error;
+    try {
+      bytesRead = fillChunk(buffer.data(), bufferSize, provider);
+    }
+    catch(...) {
+      error = std::current_exception();
+    }
+
+    if(error != std::exception_ptr() || bytesRead == 0) {
+      lock.lock();
+      state.free_slots.push_back(slot);
+      if(error != std::exception_ptr()) {
+        state.fail(error);
+      }
+      break;
+    }
+
+    const PendingChunk chunk = PendingChunk{slot, bytesRead, nchunks};
+    uploads.add([&state, chunk]() { state.upload(chunk); });
+    nchunks++;
+    lock.lock();
+
+    if(bytesRead < bufferSize) {
+      break; // short read, EOF
+    }
+  }
+
+  // help with whatever is left, then wait for the workers
+  lock.unlock();
+  uploads.wait();
+
+  if(state.exc != std::exception_ptr()) {
+    std::rethrow_exception(state.exc);
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Chunked upload: {} chunks uploaded", nchunks);
+  return nchunks;
+}
+
+}
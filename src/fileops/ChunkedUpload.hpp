@@ -0,0 +1,97 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_CHUNKED_UPLOAD_HPP
+#define DAVIX_FILEOPS_CHUNKED_UPLOAD_HPP
+
+#include <davix_internal.hpp>
+#include <functional>
+
+namespace Davix {
+
+class ContentProvider;
+class Executor;
+struct IOChainContext;
+
+//------------------------------------------------------------------------------
+// Splits the contents of a ContentProvider into fixed-size chunks, and
+// uploads up to maxInFlight of them concurrently on the Context executor
+// while the next chunk is being read from the provider.
+//
+// Chunk buffers come from a bounded pool of maxInFlight + 1 buffers which
+// are reused across chunks, so memory usage does not depend on the total
+// upload size. The calling thread uploads chunks itself whenever the pool is
+// exhausted, so the upload progresses even with a saturated executor.
+//
+// A chunk which fails with a recoverable error is uploaded again from the
+// same buffer, without touching the provider, up to the configured number
+// of attempts.
+//------------------------------------------------------------------------------
+class ChunkedUploader {
+public:
+  //----------------------------------------------------------------------------
+  // Upload a single chunk. Index is zero-based, and follows the order in
+  // which the chunks were read from the provider. Reports errors by throwing.
+  //----------------------------------------------------------------------------
+  typedef std::function<void (const char* buff, dav_size_t size, size_t index)> ChunkWriter;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ChunkedUploader(Executor &executor, dav_size_t chunkSize, size_t maxInFlight);
+
+  //----------------------------------------------------------------------------
+  // Constructor - executor, parallelism and retry policy are taken from the
+  // given IO context and its request parameters.
+  //----------------------------------------------------------------------------
+  ChunkedUploader(IOChainContext &iocontext, dav_size_t chunkSize);
+
+  //----------------------------------------------------------------------------
+  // Attempt each chunk up to maxAttempts times, waiting retryDelay seconds
+  // between attempts. Only one attempt is made by default.
+  //----------------------------------------------------------------------------
+  void setRetryPolicy(int maxAttempts, int retryDelay);
+
+  //----------------------------------------------------------------------------
+  // Read the provider until EOF, and hand every chunk to the writer.
+  // Returns the number of chunks once all of them have been uploaded.
+  //
+  // If any chunk fails, no more chunks are started, and the first error is
+  // rethrown once all uploads in flight are over.
+  //----------------------------------------------------------------------------
+  size_t run(ContentProvider &provider, const ChunkWriter &writer);
+
+  //----------------------------------------------------------------------------
+  // Fill the given buffer from the provider, stopping only at EOF or once
+  // size bytes have been read. Throws on provider failure.
+  //----------------------------------------------------------------------------
+  static dav_size_t fillChunk(char* buffer, dav_size_t size, ContentProvider &provider);
+
+private:
+  Executor &_executor;
+  dav_size_t _chunk_size;
+  size_t _max_in_flight;
+  int _max_attempts;
+  int _retry_delay;
+};
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix_internal.hpp>
+#include "ListingPrefetch.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <mutex>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// State shared with the fetch task
+//------------------------------------------------------------------------------
+struct ListingPrefetchState {
+  enum Status { Idle, Queued, Ready, Failed };
+
+  std::mutex mtx;
+
+  ListingPrefetcher::PageFetcher fetcher;
+  Status status;
+  bool started;
+  size_t pages;
+
+  std::string marker;
+  ListingPage page;
+
+  std::string error_scope;
+  StatusCode::Code error_code;
+  std::string error_msg;
+
+  ListingPrefetchState(const ListingPrefetcher::PageFetcher &f)
+  : fetcher(f), status(Idle), started(false), pages(0), error_code(StatusCode::OK) {}
+
+  // Fetch the page following marker
+  void fetch() {
+    std::unique_lock<std::mutex> lock(mtx);
+    const std::string current = marker;
+    lock.unlock();
+
+    ListingPage result;
+    std::string scope, msg;
+    StatusCode::Code code = StatusCode::OK;
+
+    try {
+      fetcher(current, result);
+    }
+    catch(DavixException &e) {
+      scope = e.scope();
+      code = e.code();
+      msg = e.what();
+    }
+    catch(std::exception &e) {
+      scope = davix_scope_directory_listing_str();
+      code = StatusCode::SystemError;
+      msg = std::string("System Error ").append(e.what());
+    }
+    catch(...) {
+      scope = davix_scope_directory_listing_str();
+      code = StatusCode::UnknownError;
+      msg = "Unknown error while fetching a listing page";
+    }
+
+    lock.lock();
+    if(code == StatusCode::OK) {
+      page.entries.swap(result.entries);
+      page.next_marker.swap(result.next_marker);
+      status = Ready;
+      pages++;
+    }
+    else {
+      error_scope = scope;
+      error_code = code;
+      error_msg = msg;
+      status = Failed;
+    }
+  }
+};
+
+ListingPrefetcher::ListingPrefetcher(Executor &executor, const PageFetcher &fetcher)
+: _state(new ListingPrefetchState(fetcher)), _fetches(executor, 1), _fetch(0) {}
+
+ListingPrefetcher::~ListingPrefetcher() {}
+
+void ListingPrefetcher::start(const std::string &marker) {
+  std::unique_lock<std::mutex> lock(_state->mtx);
+  if(_state->started) {
+    return;
+  }
+
+  _state->started = true;
+  if(!marker.empty()) {
+    request(marker);
+  }
+}
+
+// lock must be held
+void ListingPrefetcher::request(const std::string &marker) {
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Prefetching listing page after marker {}", marker);
+
+  ListingPrefetchState* state = _state.get();
+  state->marker = marker;
+  state->status = ListingPrefetchState::Queued;
+  _fetch = _fetches.add([state]() { state->fetch(); });
+}
+
+bool ListingPrefetcher::next(std::deque<FileProperties> &entries) {
+  ListingPrefetchState* state = _state.get();
+  std::unique_lock<std::mutex> lock(state->mtx);
+
+  if(state->status == ListingPrefetchState::Idle) {
+    return false; // last page reached, or never paginated
+  }
+
+  // nobody picked it up yet: the caller fetches it itself
+  lock.unlock();
+  _fetches.runOrWait(_fetch);
+  lock.lock();
+
+  if(state->status == ListingPrefetchState::Failed) {
+    state->status = ListingPrefetchState::Idle;
+    throw DavixException(state->error_scope, state->error_code, state->error_msg);
+  }
+
+  entries.swap(state->page.entries);
+  state->page.entries.clear();
+
+  std::string marker;
+  marker.swap(state->page.next_marker);
+  state->status = ListingPrefetchState::Idle;
+
+  if(!marker.empty()) {
+    request(marker);
+  }
+  return true;
+}
+
+size_t ListingPrefetcher::getPageCount() const {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  return _state->pages;
+}
+
+}
@@ -0,0 +1,107 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_LISTING_PREFETCH_HPP
+#define DAVIX_FILEOPS_LISTING_PREFETCH_HPP
+
+#include <utils/davix_fileproperties.hpp>
+#include <core/TaskGroup.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Davix {
+
+class Executor;
+struct ListingPrefetchState;
+
+//------------------------------------------------------------------------------
+// One page of a paginated listing
+//------------------------------------------------------------------------------
+struct ListingPage {
+  std::deque<FileProperties> entries;
+
+  // marker to request the following page with, empty on the last page
+  std::string next_marker;
+};
+
+//------------------------------------------------------------------------------
+// Pipelined fetching of the pages of an S3, Swift or Azure listing.
+//
+// The page following a given marker is requested on the executor as soon
+// as that marker is known, while the caller is still consuming the
+// entries of the current page. Whenever the caller moves on to a
+// prefetched page, the request for the one after it is issued right away,
+// so that one page is always in flight ahead of the reader.
+//------------------------------------------------------------------------------
+class ListingPrefetcher {
+public:
+  //----------------------------------------------------------------------------
+  // Fetch and parse the whole page following marker, throws on failure
+  //----------------------------------------------------------------------------
+  typedef std::function<void (const std::string &marker, ListingPage &page)> PageFetcher;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ListingPrefetcher(Executor &executor, const PageFetcher &fetcher);
+
+  //----------------------------------------------------------------------------
+  // Destructor - drops a queued fetch, waits for a running one
+  //----------------------------------------------------------------------------
+  ~ListingPrefetcher();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  ListingPrefetcher(const ListingPrefetcher& other) = delete;
+  ListingPrefetcher& operator=(const ListingPrefetcher& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Request the page following the first page of the listing. Only the
+  // first call has an effect, the following pages are chained by next().
+  //----------------------------------------------------------------------------
+  void start(const std::string &marker);
+
+  //----------------------------------------------------------------------------
+  // Wait for the requested page and move its entries into the given
+  // deque, then request the following page, if any. Returns false once
+  // there is no page left, throws DavixException if the fetch failed.
+  //----------------------------------------------------------------------------
+  bool next(std::deque<FileProperties> &entries);
+
+  //----------------------------------------------------------------------------
+  // Number of pages fetched in the background so far
+  //----------------------------------------------------------------------------
+  size_t getPageCount() const;
+
+private:
+  void request(const std::string &marker);
+
+  std::unique_ptr<ListingPrefetchState> _state;
+  TaskGroup _fetches; // goes first
+  TaskGroup::TaskId _fetch;
+};
+
+}
+
+#endif
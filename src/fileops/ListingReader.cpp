@@ -0,0 +1,84 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix_internal.hpp>
+#include "ListingReader.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+namespace Davix {
+
+// a chunk filled within the first delay comes from a fast answer, one which
+// took longer than the second holds back entries which are already there
+static const std::chrono::milliseconds kGrowDelay(5);
+static const std::chrono::milliseconds kShrinkDelay(50);
+
+const dav_size_t ListingReader::kMinChunk;
+const dav_size_t ListingReader::kMaxChunk;
+
+ListingReader::ListingReader() : _chunk(kMinChunk), _finished(false) {}
+
+dav_ssize_t ListingReader::read(HttpRequest &req, XMLPropParser &parser, const std::string &scope) {
+  DavixError* tmp_err = NULL;
+  const dav_size_t chunk = _chunk;
+  if(_buffer.size() < chunk) {
+    _buffer.resize(chunk);
+  }
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  const dav_ssize_t ret = req.readSegment(&_buffer[0], chunk, &tmp_err);
+  checkDavixError(&tmp_err);
+  if(ret < 0) {
+    throw DavixException(scope, StatusCode::UnknownError, "Unknown readSegment error");
+  }
+
+  parser.parseChunk(&_buffer[0], ret);
+
+  if((dav_size_t) ret < chunk) {
+    _finished = true;
+  }
+  else {
+    adapt(std::chrono::steady_clock::now() - start);
+  }
+  return ret;
+}
+
+bool ListingReader::finished() const {
+  return _finished;
+}
+
+dav_size_t ListingReader::getChunkSize() const {
+  return _chunk;
+}
+
+void ListingReader::adapt(std::chrono::steady_clock::duration elapsed) {
+  const dav_size_t previous = _chunk;
+  if(elapsed < kGrowDelay) {
+    _chunk = std::min(_chunk * 2, kMaxChunk);
+  }
+  else if(elapsed > kShrinkDelay) {
+    _chunk = std::max(_chunk / 2, kMinChunk);
+  }
+
+  if(_chunk != previous) {
+    DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CHAIN, "Listing read size {} -> {} bytes", previous, _chunk);
+  }
+}
+
+}
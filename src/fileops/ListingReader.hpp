@@ -0,0 +1,82 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_LISTING_READER_HPP
+#define DAVIX_FILEOPS_LISTING_READER_HPP
+
+#include <davix.hpp>
+#include <xml/davxmlparser.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Feeds the body of a listing answer to its parser, in chunks sized after
+// the rate at which the answer comes.
+//
+// readSegment() only returns once a whole chunk is there: small chunks get
+// the first entries out early from a slow server, large ones save parser
+// calls and timeout checks with a fast one. The chunk size starts small,
+// doubles as long as chunks fill up quickly, and halves when they don't.
+//------------------------------------------------------------------------------
+class ListingReader {
+public:
+  static const dav_size_t kMinChunk = 2048;
+  static const dav_size_t kMaxChunk = 256 * 1024;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ListingReader();
+
+  //----------------------------------------------------------------------------
+  // Read the next chunk of the answer and parse it. Returns the number of
+  // bytes read, less than the chunk size only at the end of the answer.
+  // Throws DavixException on error.
+  //----------------------------------------------------------------------------
+  dav_ssize_t read(HttpRequest &req, XMLPropParser &parser, const std::string &scope);
+
+  //----------------------------------------------------------------------------
+  // True once the end of the answer has been read
+  //----------------------------------------------------------------------------
+  bool finished() const;
+
+  //----------------------------------------------------------------------------
+  // Size of the next read
+  //----------------------------------------------------------------------------
+  dav_size_t getChunkSize() const;
+
+  //----------------------------------------------------------------------------
+  // Adapt the chunk size after a whole chunk took the given time to read
+  //----------------------------------------------------------------------------
+  void adapt(std::chrono::steady_clock::duration elapsed);
+
+private:
+  std::vector<char> _buffer;
+  dav_size_t _chunk;
+  bool _finished;
+};
+
+}
+
+#endif
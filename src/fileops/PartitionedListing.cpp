@@ -0,0 +1,414 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix_internal.hpp>
+#include "PartitionedListing.hpp"
+#include <core/TaskGroup.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+
+namespace Davix {
+
+namespace {
+
+// keys are interpolated on a window of base-96 digits, one per printable
+// ASCII character, starting at the first byte where the bounds differ
+const size_t kWindow = 6;
+const uint64_t kBase = 96;
+
+uint64_t windowValue(const std::string &key, size_t skip) {
+  uint64_t value = 0;
+  for(size_t i = 0; i < kWindow; i++) {
+    uint64_t digit = 0;
+    if(skip + i < key.size()) {
+      const unsigned char c = key[skip + i];
+      digit = std::min<unsigned char>(std::max<unsigned char>(c, 0x20), 0x7f) - 0x20;
+    }
+    value = value * kBase + digit;
+  }
+  return value;
+}
+
+// Position of (start, end] in the keyspace: length of the common prefix,
+// and the bounds of the window after it. False if it cannot be split.
+bool measure(const std::string &start, const std::string &end, size_t &prefix, uint64_t &lo, uint64_t &hi) {
+  const std::string upper = end.empty() ? std::string(1, '\x7f') : end;
+
+  prefix = 0;
+  while(prefix < start.size() && prefix < upper.size() && start[prefix] == upper[prefix]) {
+    prefix++;
+  }
+
+  lo = windowValue(start, prefix);
+  hi = windowValue(upper, prefix);
+  return hi > lo + 1;
+}
+
+struct KeyRange {
+  KeyRange(const std::string &s, const std::string &e) : position(s), end(e), queued(false), done(false), task(0) {}
+
+  std::string position; // last key listed, marker of the next request
+  std::string end;      // last key of the range, empty for no bound
+
+  // first and last keys of the previous page, to estimate the key density
+  std::string page_first;
+  std::string page_last;
+  std::deque<FileProperties> entries;
+  bool queued;
+  bool done;
+  TaskGroup::TaskId task;
+};
+
+typedef std::shared_ptr<KeyRange> KeyRangePtr;
+
+}
+
+//------------------------------------------------------------------------------
+// State shared with the fetch tasks
+//------------------------------------------------------------------------------
+struct PartitionedListingState {
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  PartitionedListing::PageFetcher fetcher;
+  size_t parallelism;
+  size_t max_buffered;
+
+  // ranges in key order, the first one is being consumed
+  std::list<KeyRangePtr> ranges;
+
+  size_t inflight;
+  size_t completed;
+  size_t buffered;
+  size_t active;
+  size_t created;
+  size_t requests;
+
+  bool failed;
+  std::string error_scope;
+  StatusCode::Code error_code;
+  std::string error_msg;
+
+  // fetches use everything above: destroyed first, waits for them
+  TaskGroup fetches;
+
+  PartitionedListingState(Executor &e, const PartitionedListing::PageFetcher &f, size_t p, size_t maxBuffered)
+  : fetcher(f), parallelism(std::max<size_t>(1, p)), max_buffered(std::max<size_t>(1, maxBuffered)),
+    inflight(0), completed(0), buffered(0), active(1), created(1), requests(0),
+    failed(false), error_code(StatusCode::OK), fetches(e, parallelism) {
+    ranges.push_back(KeyRangePtr(new KeyRange("", "")));
+  }
+
+  // Fill the free request slots, lock must be held
+  void schedule() {
+    while(!failed && inflight < parallelism) {
+      KeyRangePtr range = pickRange();
+      if(!range) {
+        range = splitRange();
+      }
+      if(!range) {
+        break;
+      }
+
+      range->queued = true;
+      inflight++;
+      requests++;
+
+      range->task = fetches.add([this, range]() { run(range); });
+    }
+  }
+
+  // First range waiting for a request, the one being consumed always qualifies
+  KeyRangePtr pickRange() {
+    for(std::list<KeyRangePtr>::iterator it = ranges.begin(); it != ranges.end(); it++) {
+      if(!(*it)->queued && !(*it)->done && (it == ranges.begin() || buffered < max_buffered)) {
+        return *it;
+      }
+    }
+    return KeyRangePtr();
+  }
+
+  // Cut the widest range in two, returns the upper half
+  KeyRangePtr splitRange() {
+    if(buffered >= max_buffered || active >= 4 * parallelism) {
+      return KeyRangePtr();
+    }
+
+    std::list<KeyRangePtr>::iterator best = ranges.end();
+    size_t best_prefix = 0;
+    uint64_t best_width = 0;
+
+    for(std::list<KeyRangePtr>::iterator it = ranges.begin(); it != ranges.end(); it++) {
+      size_t prefix;
+      uint64_t lo, hi;
+      // blind splits of a range which never answered mostly end up as
+      // empty probes, wait for a page to know where its keys are
+      if((*it)->done || (*it)->page_last.empty() || !measure((*it)->position, (*it)->end, prefix, lo, hi)) {
+        continue;
+      }
+
+      // not worth it if a few more pages cover the rest of the range, part
+      // of the page in flight would be thrown away
+      const uint64_t first = windowValue((*it)->page_first, prefix), last = windowValue((*it)->page_last, prefix);
+      if(last > first && (hi - lo) / 4 <= last - first) {
+        continue;
+      }
+
+      if(best == ranges.end() || prefix < best_prefix || (prefix == best_prefix && hi - lo > best_width)) {
+        best = it;
+        best_prefix = prefix;
+        best_width = hi - lo;
+      }
+    }
+
+    if(best == ranges.end()) {
+      return KeyRangePtr();
+    }
+
+    // the keys of the last page live in a directory the bounds do not
+    // share, cut right after it first instead of probing the space around
+    std::string mid;
+    const std::string &first = (*best)->page_first, &last = (*best)->page_last;
+    size_t shared = 0;
+    while(shared < first.size() && shared < last.size() && first[shared] == last[shared]) {
+      shared++;
+    }
+
+    const size_t slash = (shared > 0) ? first.rfind('/', shared - 1) : std::string::npos;
+    if(slash != std::string::npos && slash + 1 > best_prefix) {
+      mid = first.substr(0, slash + 1) + '\x7f';
+      if(mid <= (*best)->position || (!(*best)->end.empty() && mid >= (*best)->end)) {
+        mid.clear();
+      }
+    }
+
+    if(mid.empty()) {
+      mid = PartitionedListing::splitKey((*best)->position, (*best)->end);
+    }
+    if(mid.empty()) {
+      return KeyRangePtr();
+    }
+
+    KeyRangePtr upper(new KeyRange(mid, (*best)->end));
+    (*best)->end = mid;
+    ranges.insert(++best, upper);
+    active++;
+    created++;
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Listing range split at key {}, {} ranges active", mid, active);
+    return upper;
+  }
+
+  // Fetch the next page of a range
+  void run(const KeyRangePtr &range) {
+    std::unique_lock<std::mutex> lock(mtx);
+    const std::string marker = range->position;
+    lock.unlock();
+
+    ListingPage page;
+    std::string scope, msg;
+    StatusCode::Code code = StatusCode::OK;
+
+    try {
+      fetcher(marker, page);
+    }
+    catch(DavixException &e) {
+      scope = e.scope();
+      code = e.code();
+      msg = e.what();
+    }
+    catch(std::exception &e) {
+      scope = davix_scope_directory_listing_str();
+      code = StatusCode::SystemError;
+      msg = std::string("System Error ").append(e.what());
+    }
+    catch(...) {
+      scope = davix_scope_directory_listing_str();
+      code = StatusCode::UnknownError;
+      msg = "Unknown error while fetching a listing page";
+    }
+
+    lock.lock();
+    inflight--;
+    completed++;
+    range->queued = false;
+
+    if(code != StatusCode::OK) {
+      if(!failed) {
+        failed = true;
+        error_scope = scope;
+        error_code = code;
+        error_msg = msg;
+      }
+    }
+    else {
+      // the range may have been split while this page was in flight
+      bool past_end = false;
+      const std::string first = page.entries.empty() ? std::string() : page.entries.front().filename;
+      for(std::deque<FileProperties>::iterator it = page.entries.begin(); it != page.entries.end(); it++) {
+        if(!range->end.empty() && it->filename > range->end) {
+          past_end = true;
+          break;
+        }
+        range->entries.push_back(FileProperties());
+        std::swap(range->entries.back(), *it);
+        buffered++;
+      }
+
+      if(!range->entries.empty() && !past_end) {
+        range->page_first = first;
+        range->page_last = range->entries.back().filename;
+      }
+
+      if(past_end || page.next_marker.empty()) {
+        range->done = true;
+        active--;
+      }
+      else {
+        range->position = page.next_marker;
+      }
+    }
+
+    cv.notify_all();
+    schedule();
+  }
+
+  // Wait for the next fetch to complete. The one of the front range, or
+  // else any queued one, is run by the caller if no worker started it yet,
+  // so that a busy executor can not stall the listing. Lock must be held on
+  // entry and is held on exit.
+  void progress(std::unique_lock<std::mutex> &lock) {
+    const size_t seen = completed;
+    const KeyRangePtr front = ranges.front();
+    const bool queued = front->queued;
+    lock.unlock();
+
+    if(queued) {
+      fetches.runOrWait(front->task);
+    }
+    else {
+      fetches.runNext();
+    }
+
+    lock.lock();
+    cv.wait(lock, [this, seen]() { return completed != seen; });
+  }
+
+  void throwError() {
+    throw DavixException(error_scope, error_code, error_msg);
+  }
+};
+
+PartitionedListing::PartitionedListing(Executor &executor, const PageFetcher &fetcher, size_t parallelism, size_t maxBuffered)
+: _state(new PartitionedListingState(executor, fetcher, parallelism, maxBuffered)) {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  _state->schedule();
+}
+
+PartitionedListing::~PartitionedListing() {}
+
+void PartitionedListing::waitFirstPage() {
+  PartitionedListingState* state = _state.get();
+  std::unique_lock<std::mutex> lock(state->mtx);
+
+  while(!state->failed && !state->ranges.empty() && state->ranges.front()->entries.empty() && !state->ranges.front()->done) {
+    state->progress(lock);
+  }
+
+  if(state->failed) {
+    state->throwError();
+  }
+}
+
+bool PartitionedListing::next(FileProperties &entry) {
+  PartitionedListingState* state = _state.get();
+  std::unique_lock<std::mutex> lock(state->mtx);
+
+  for(;;) {
+    if(state->failed) {
+      state->throwError();
+    }
+
+    if(state->ranges.empty()) {
+      return false;
+    }
+
+    KeyRangePtr range = state->ranges.front();
+    if(!range->entries.empty()) {
+      std::swap(entry, range->entries.front());
+      range->entries.pop_front();
+      state->buffered--;
+      state->schedule();
+      return true;
+    }
+
+    if(range->done) {
+      state->ranges.pop_front();
+      state->schedule();
+      continue;
+    }
+
+    state->schedule();
+    state->progress(lock);
+  }
+}
+
+size_t PartitionedListing::getRangeCount() const {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  return _state->created;
+}
+
+size_t PartitionedListing::getRequestCount() const {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  return _state->requests;
+}
+
+std::string PartitionedListing::splitKey(const std::string &start, const std::string &end) {
+  size_t prefix;
+  uint64_t lo, hi;
+  if(!measure(start, end, prefix, lo, hi)) {
+    return std::string();
+  }
+
+  uint64_t mid = lo + (hi - lo) / 2;
+  std::string digits(kWindow, ' ');
+  for(size_t i = kWindow; i-- > 0; ) {
+    digits[i] = (char) (0x20 + mid % kBase);
+    mid /= kBase;
+  }
+
+  // trailing spaces are only padding
+  std::string key = start.substr(0, prefix) + digits;
+  while(key.size() > prefix + 1 && key[key.size() - 1] == ' ') {
+    key.erase(key.size() - 1);
+  }
+
+  if(key <= start || (!end.empty() && key >= end)) {
+    return std::string();
+  }
+  return key;
+}
+
+}
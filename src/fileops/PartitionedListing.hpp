@@ -0,0 +1,106 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_PARTITIONED_LISTING_HPP
+#define DAVIX_FILEOPS_PARTITIONED_LISTING_HPP
+
+#include <fileops/ListingPrefetch.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Davix {
+
+class Executor;
+struct PartitionedListingState;
+
+//------------------------------------------------------------------------------
+// Parallel listing of a flat, marker-paginated keyspace, such as an S3
+// bucket listed without delimiter.
+//
+// The keyspace is cut into ranges of keys (start, end], each listed on
+// the executor from its own marker, up to parallelism requests at a time.
+// The page fetcher must return the keys as entry names, in order.
+//
+// Ranges are split on demand: whenever a request slot is free and every
+// range is already being listed, the widest range which returned a page
+// is cut in two, right after the directory of its last page if the range
+// spans more than that, else at a key interpolated between its current
+// marker and its end. Ranges only a few pages wide are left alone.
+//
+// Entries are returned in key order. Ranges ahead of the one being
+// consumed stop being listed once maxBuffered entries are waiting.
+//------------------------------------------------------------------------------
+class PartitionedListing {
+public:
+  typedef ListingPrefetcher::PageFetcher PageFetcher;
+
+  //----------------------------------------------------------------------------
+  // Constructor, starts listing right away
+  //----------------------------------------------------------------------------
+  PartitionedListing(Executor &executor, const PageFetcher &fetcher, size_t parallelism, size_t maxBuffered);
+
+  //----------------------------------------------------------------------------
+  // Destructor - drops queued fetches, waits for the running ones
+  //----------------------------------------------------------------------------
+  ~PartitionedListing();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  PartitionedListing(const PartitionedListing& other) = delete;
+  PartitionedListing& operator=(const PartitionedListing& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Wait for the first page of the listing, throws DavixException if it
+  // failed
+  //----------------------------------------------------------------------------
+  void waitFirstPage();
+
+  //----------------------------------------------------------------------------
+  // Next entry in key order. Returns false at the end of the listing,
+  // throws DavixException if a page could not be fetched.
+  //----------------------------------------------------------------------------
+  bool next(FileProperties &entry);
+
+  //----------------------------------------------------------------------------
+  // Number of ranges the keyspace has been split into so far
+  //----------------------------------------------------------------------------
+  size_t getRangeCount() const;
+
+  //----------------------------------------------------------------------------
+  // Number of page requests issued so far
+  //----------------------------------------------------------------------------
+  size_t getRequestCount() const;
+
+  //----------------------------------------------------------------------------
+  // A key strictly between start and end, empty end meaning no bound,
+  // roughly halfway on printable ASCII. Returns an empty string if the
+  // range is too narrow to be split.
+  //----------------------------------------------------------------------------
+  static std::string splitKey(const std::string &start, const std::string &end);
+
+private:
+  std::unique_ptr<PartitionedListingState> _state;
+};
+
+}
+
+#endif
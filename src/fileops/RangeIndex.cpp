@@ -0,0 +1,146 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "RangeIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Davix {
+
+RangeIndex::RangeIndex(const DavIOVecInput *in, DavIOVecOuput *out, dav_size_t count) {
+  _entries.reserve(count);
+
+  bool sorted = true;
+  for(dav_size_t i = 0; i < count; i++) {
+    out[i].diov_size = 0; // reset elem read status
+    out[i].diov_buffer = in[i].diov_buffer;
+
+    if(in[i].diov_size == 0) {
+      continue;
+    }
+
+    Entry entry;
+    entry.start = in[i].diov_offset;
+    entry.end = in[i].diov_offset + in[i].diov_size - 1;
+    entry.in = in + i;
+    entry.out = out + i;
+
+    if(!_entries.empty() && entry.start < _entries.back().start) {
+      sorted = false;
+    }
+
+    _entries.push_back(entry);
+  }
+
+  // requests are very often sorted already
+  if(!sorted) {
+    std::stable_sort(_entries.begin(), _entries.end(), [](const Entry &a, const Entry &b) {
+      return a.start < b.start;
+    });
+  }
+
+  _max_end.resize(_entries.size());
+  for(size_t i = 0; i < _entries.size(); i++) {
+    _max_end[i] = (i == 0) ? _entries[i].end : std::max(_max_end[i-1], _entries[i].end);
+  }
+}
+
+SortedRanges RangeIndex::merge(dav_size_t mergedist) const {
+  SortedRanges output;
+  if(_entries.empty()) {
+    return output;
+  }
+
+  dav_off_t offset = _entries[0].start;
+  dav_off_t end = _entries[0].end;
+
+  for(size_t i = 1; i < _entries.size(); i++) {
+    if(end + (dav_off_t) mergedist >= _entries[i].start) {
+      end = std::max(end, _entries[i].end);
+    }
+    else {
+      output.push_back(std::make_pair(offset, end));
+      offset = _entries[i].start;
+      end = _entries[i].end;
+    }
+  }
+
+  output.push_back(std::make_pair(offset, end));
+  return output;
+}
+
+void RangeIndex::reset() {
+  for(size_t i = 0; i < _entries.size(); i++) {
+    _entries[i].out->diov_size = 0;
+  }
+}
+
+size_t RangeIndex::size() const {
+  return _entries.size();
+}
+
+RangeIndex::Cursor::Cursor(const RangeIndex &index) : _index(index), _lo(0), _last(0) {}
+
+size_t RangeIndex::Cursor::fill(const char *source, dav_off_t offset, dav_size_t size) {
+  const std::vector<Entry> &entries = _index._entries;
+  const std::vector<dav_off_t> &max_end = _index._max_end;
+
+  if(size == 0 || entries.empty()) {
+    return 0;
+  }
+
+  const dav_off_t last = offset + size - 1;
+
+  // skip ranges which end before this piece: a linear walk while the
+  // answer moves forward, a binary search if it ever jumps back
+  if(offset < _last) {
+    _lo = std::lower_bound(max_end.begin(), max_end.end(), offset) - max_end.begin();
+  }
+  else {
+    while(_lo < max_end.size() && max_end[_lo] < offset) {
+      _lo++;
+    }
+  }
+  _last = offset;
+
+  size_t matches = 0;
+  for(size_t i = _lo; i < entries.size() && entries[i].start <= last; i++) {
+    const Entry &entry = entries[i];
+    if(entry.end < offset) {
+      continue;
+    }
+
+    // first byte from which we'll start copying, and the length for which
+    // the two segments intersect
+    dav_off_t common_offset = std::max(offset, entry.start);
+    dav_size_t intersect_dist = std::min(last, entry.end) - common_offset + 1;
+
+    ::memcpy( (char*) entry.in->diov_buffer + (common_offset - entry.start),
+              source + (common_offset - offset), intersect_dist);
+
+    entry.out->diov_size += intersect_dist;
+    matches++;
+  }
+
+  return matches;
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_RANGE_INDEX_HPP
+#define DAVIX_FILEOPS_RANGE_INDEX_HPP
+
+#include <davix.hpp>
+#include <vector>
+
+namespace Davix {
+
+typedef std::vector<std::pair<dav_off_t, dav_size_t> > SortedRanges;
+
+//------------------------------------------------------------------------------
+// Flat index over the user-provided ranges of a vectored read, sorted by
+// offset, used to route the bytes received from the server into the
+// matching output buffers.
+//
+// Server answers come with monotonically increasing offsets, so lookups
+// go through a Cursor which resumes where the previous one stopped,
+// instead of searching the whole index for every piece of the body.
+//------------------------------------------------------------------------------
+class RangeIndex {
+public:
+  struct Entry {
+    dav_off_t start;
+    dav_off_t end; // inclusive
+    const DavIOVecInput *in;
+    DavIOVecOuput *out;
+  };
+
+  //----------------------------------------------------------------------------
+  // Build the index, and reset the output vector.
+  //----------------------------------------------------------------------------
+  RangeIndex(const DavIOVecInput *in, DavIOVecOuput *out, dav_size_t count);
+
+  //----------------------------------------------------------------------------
+  // Coalesce ranges separated by at most mergedist bytes. Returns sorted,
+  // non-overlapping [first, last] ranges.
+  //----------------------------------------------------------------------------
+  SortedRanges merge(dav_size_t mergedist) const;
+
+  //----------------------------------------------------------------------------
+  // Mark every output as empty again, before fetching the ranges over
+  //----------------------------------------------------------------------------
+  void reset();
+
+  //----------------------------------------------------------------------------
+  // Number of ranges
+  //----------------------------------------------------------------------------
+  size_t size() const;
+
+  //----------------------------------------------------------------------------
+  // Streaming lookup over the index. Not thread-safe, but any number of
+  // cursors can be used concurrently, as long as they fill disjoint ranges.
+  //----------------------------------------------------------------------------
+  class Cursor {
+  public:
+    Cursor(const RangeIndex &index);
+
+    //--------------------------------------------------------------------------
+    // Copy size bytes starting at the given object offset into every
+    // overlapping output buffer. Returns the number of matching ranges.
+    //--------------------------------------------------------------------------
+    size_t fill(const char *source, dav_off_t offset, dav_size_t size);
+
+  private:
+    const RangeIndex &_index;
+    size_t _lo;
+    dav_off_t _last;
+  };
+
+private:
+  std::vector<Entry> _entries;
+
+  // _max_end[i] is the largest end among _entries[0..i], non-decreasing,
+  // which bounds how far back an overlapping range can be
+  std::vector<dav_off_t> _max_end;
+};
+
+}
+
+#endif
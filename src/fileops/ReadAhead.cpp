@@ -0,0 +1,222 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "ReadAhead.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Davix {
+
+namespace {
+
+struct Block {
+  enum Status { Queued, Fetching, Ready, Failed };
+
+  Block(dav_off_t off, dav_size_t sz) : offset(off), size(sz), status(Queued), task(0) {}
+
+  dav_off_t offset;
+  dav_size_t size;
+  std::vector<char> data;
+  Status status;
+  std::string error;
+  TaskGroup::TaskId task;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+}
+
+//------------------------------------------------------------------------------
+// State shared with the fetch tasks
+//------------------------------------------------------------------------------
+struct ReadAheadState {
+  std::mutex mtx;
+
+  ReadAheadWindow::Fetcher fetcher;
+  std::deque<std::shared_ptr<Block> > blocks;
+
+  dav_off_t next;
+  dav_off_t end;
+  dav_size_t block_size;
+
+  size_t window;
+  size_t max_window;
+  size_t stalls;
+
+  // throughput observed since the last window change, from its first
+  // completed fetch on
+  bool saturated;
+  double last_throughput;
+  Clock::time_point measure_start;
+  dav_size_t measure_bytes;
+  size_t measure_blocks;
+
+  ReadAheadState(const ReadAheadWindow::Fetcher &f, dav_off_t start, dav_off_t e, dav_size_t bs, size_t maxInFlight)
+  : fetcher(f), next(start), end(e), block_size(std::max<dav_size_t>(1, bs)),
+    window(std::min<size_t>(2, std::max<size_t>(1, maxInFlight))), max_window(std::max<size_t>(1, maxInFlight)),
+    stalls(0), saturated(false), last_throughput(0), measure_start(), measure_bytes(0), measure_blocks(0) {}
+
+  // Fetch the given block
+  void fetch(const std::shared_ptr<Block> &block) {
+    std::unique_lock<std::mutex> lock(mtx);
+    block->status = Block::Fetching;
+    lock.unlock();
+
+    std::string error;
+    try {
+      block->data.resize(block->size);
+      fetcher(block->offset, block->size, block->data.data());
+    }
+    catch(std::exception &e) {
+      error = e.what();
+    }
+    catch(...) {
+      error = "unknown error";
+    }
+
+    lock.lock();
+    if(error.empty()) {
+      block->status = Block::Ready;
+
+      // the measure starts at the first completion, once the pipeline is full
+      if(measure_blocks++ == 0) {
+        measure_start = Clock::now();
+      }
+      else {
+        measure_bytes += block->size;
+      }
+    }
+    else {
+      block->status = Block::Failed;
+      block->error = error;
+      block->data.clear();
+    }
+  }
+
+  // The reader had to wait: widen the window if the previous widening paid off
+  void onStall() {
+    stalls++;
+    if(saturated || window >= max_window || measure_blocks <= 2 * window) {
+      return;
+    }
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - measure_start).count();
+    const double throughput = measure_bytes / std::max(elapsed, 1e-6);
+
+    if(last_throughput > 0 && throughput < last_throughput * 1.1) {
+      window = std::max<size_t>(1, window / 2);
+      saturated = true;
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead throughput saturated at {} B/s, window set to {} blocks", last_throughput, window);
+      return;
+    }
+
+    last_throughput = throughput;
+    window = std::min(window * 2, max_window);
+    measure_bytes = 0;
+    measure_blocks = 0;
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead at {} B/s, window grown to {} blocks", throughput, window);
+  }
+};
+
+ReadAheadWindow::ReadAheadWindow(Executor &executor, const Fetcher &fetcher, dav_off_t start, dav_off_t end,
+                                 dav_size_t blockSize, size_t maxInFlight)
+: _state(new ReadAheadState(fetcher, start, end, blockSize, maxInFlight)), _fetches(executor, _state->max_window) {
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead from offset {} to {}, blocks of {} bytes, up to {} in flight",
+             start, end, _state->block_size, _state->max_window);
+}
+
+ReadAheadWindow::~ReadAheadWindow() {}
+
+dav_ssize_t ReadAheadWindow::read(dav_off_t offset, char* buffer, dav_size_t count) {
+  ReadAheadState* state = _state.get();
+  std::unique_lock<std::mutex> lock(state->mtx);
+  dav_size_t copied = 0;
+
+  while(copied < count) {
+    const dav_off_t current = offset + copied;
+
+    // release consumed blocks
+    while(!state->blocks.empty() && state->blocks.front()->offset + (dav_off_t) state->blocks.front()->size <= current) {
+      state->blocks.pop_front();
+    }
+
+    if(state->blocks.empty() && state->next < current) {
+      state->next = current; // reader skipped ahead
+    }
+
+    if(current >= state->end) {
+      break;
+    }
+
+    // top up the window
+    while(state->blocks.size() < state->window && state->next < state->end) {
+      std::shared_ptr<Block> block(new Block(state->next, std::min<dav_off_t>(state->block_size, state->end - state->next)));
+      state->next += block->size;
+      state->blocks.push_back(block);
+
+      block->task = _fetches.add([state, block]() { state->fetch(block); });
+    }
+
+    std::shared_ptr<Block> block = state->blocks.front();
+    if(block->offset > current) {
+      return (copied > 0) ? (dav_ssize_t) copied : -1;
+    }
+
+    if(block->status == Block::Queued || block->status == Block::Fetching) {
+      state->onStall();
+
+      // nobody picked it up yet: the caller fetches it itself
+      lock.unlock();
+      _fetches.runOrWait(block->task);
+      lock.lock();
+      continue;
+    }
+
+    if(block->status == Block::Failed) {
+      DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Read-ahead of {} bytes at offset {} failed: {}", block->size, block->offset, block->error);
+      return (copied > 0) ? (dav_ssize_t) copied : -1;
+    }
+
+    const dav_size_t inblock = current - block->offset;
+    const dav_size_t len = std::min<dav_size_t>(count - copied, block->size - inblock);
+    memcpy(buffer + copied, block->data.data() + inblock, len);
+    copied += len;
+  }
+
+  return copied;
+}
+
+size_t ReadAheadWindow::getWindow() const {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  return _state->window;
+}
+
+size_t ReadAheadWindow::getStalls() const {
+  std::lock_guard<std::mutex> lock(_state->mtx);
+  return _state->stalls;
+}
+
+}
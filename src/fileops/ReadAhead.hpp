@@ -0,0 +1,96 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_READ_AHEAD_HPP
+#define DAVIX_FILEOPS_READ_AHEAD_HPP
+
+#include <davix.hpp>
+#include <core/TaskGroup.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace Davix {
+
+class Executor;
+struct ReadAheadState;
+
+//------------------------------------------------------------------------------
+// Read-ahead engine for sequential reads: keeps a window of fixed-size
+// blocks in flight ahead of the reader, fetched concurrently on the
+// executor, and serves reads from them.
+//
+// The window starts at two blocks. Every time the reader has to wait for
+// data, it doubles, as long as this keeps improving the throughput
+// observed over the previous window, up to maxInFlight blocks.
+//------------------------------------------------------------------------------
+class ReadAheadWindow {
+public:
+  //----------------------------------------------------------------------------
+  // Fetch exactly size bytes at the given offset, throws on failure
+  //----------------------------------------------------------------------------
+  typedef std::function<void (dav_off_t offset, dav_size_t size, char* buffer)> Fetcher;
+
+  //----------------------------------------------------------------------------
+  // Constructor, covers [start, end)
+  //----------------------------------------------------------------------------
+  ReadAheadWindow(Executor &executor, const Fetcher &fetcher, dav_off_t start, dav_off_t end,
+                  dav_size_t blockSize, size_t maxInFlight);
+
+  //----------------------------------------------------------------------------
+  // Destructor - drops queued fetches, waits for the running ones
+  //----------------------------------------------------------------------------
+  ~ReadAheadWindow();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving.
+  //----------------------------------------------------------------------------
+  ReadAheadWindow(const ReadAheadWindow& other) = delete;
+  ReadAheadWindow& operator=(const ReadAheadWindow& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Copy up to count bytes at offset, which must not be behind the previous
+  // read. Returns the number of bytes copied, short only at the end of the
+  // window, or -1 if the data could not be fetched.
+  //----------------------------------------------------------------------------
+  dav_ssize_t read(dav_off_t offset, char* buffer, dav_size_t count);
+
+  //----------------------------------------------------------------------------
+  // Current window size, in blocks
+  //----------------------------------------------------------------------------
+  size_t getWindow() const;
+
+  //----------------------------------------------------------------------------
+  // Number of times the reader had to wait for data
+  //----------------------------------------------------------------------------
+  size_t getStalls() const;
+
+private:
+  std::unique_ptr<ReadAheadState> _state;
+
+  // fetches write to the blocks of _state, and use whatever the fetcher
+  // references until they are done: destroyed first, waits for them
+  TaskGroup _fetches;
+};
+
+}
+
+#endif
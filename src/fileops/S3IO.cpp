@@ -20,10 +20,13 @@
 */
 
 #include "S3IO.hpp"
+#include "ChunkedUpload.hpp"
 #include <core/ContentProvider.hpp>
 #include <utils/davix_logger_internal.hpp>
 #include <xml/S3MultiPartInitiationParser.hpp>
 
+#include <mutex>
+
 #define SSTR(message) static_cast<std::ostringstream&>(std::ostringstream().flush() << message).str()
 
 namespace Davix{
@@ -46,9 +49,28 @@ static bool should_use_s3_multipart(IOChainContext & context, dav_size_t size) {
     return true;
   }
 
-  return size > (1024 * 1024 * 512); // 512 MB
+  return size > context._reqparams->getMultipartUploadThreshold();
 }
 
+// S3 parts are between 5 MB and 5 GB, at most 10000 per upload
+static dav_size_t get_s3_part_size(IOChainContext & context, dav_ssize_t size) {
+  const dav_size_t MIN_PART_SIZE = 1024 * 1024 * 5; // 5 MB
+  const dav_size_t MAX_PART_SIZE = 1024ULL * 1024 * 1024 * 5; // 5 GB
+  const dav_size_t MAX_PARTS = 10000;
+
+  dav_size_t partSize = context._reqparams->getMultipartUploadPartSize();
+  if(partSize == 0) {
+    partSize = 1024 * 1024 * 64; // 64 MB
+  }
+
+  if(size > 0) {
+    partSize = std::max(partSize, ((dav_size_t) size + MAX_PARTS - 1) / MAX_PARTS);
+  }
+
+  return std::min(std::max(partSize, MIN_PART_SIZE), MAX_PART_SIZE);
+}
+
+
 S3IO::S3IO() {
 
 }
@@ -161,34 +183,6 @@ void S3IO::commitChunks(IOChainContext & iocontext,  const Uri &url, const std::
   checkDavixError(&tmp_err);
 }
 
-static dav_size_t fillBufferWithProviderData(std::vector<char> &buffer, const dav_size_t maxChunkSize, ContentProvider &provider) {
-    dav_size_t written = 0u;
-    dav_size_t remaining = maxChunkSize;
-
-    while(true) {
-      dav_ssize_t bytesRead = provider.pullBytes(buffer.data(), remaining);
-      if(bytesRead < 0) {
-        throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle, fmt::format("Error when reading from callback: {}", bytesRead));
-      }
-
-      remaining -= bytesRead;
-      written += bytesRead;
-
-      if(bytesRead == 0) {
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Reached data provider EOF, received 0 bytes, even though asked for {}", remaining);
-        break; // EOF
-      }
-
-      if(remaining == 0) {
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Data provider buffer has been filled");
-        break; // buffer is full
-      }
-    }
-
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrieved {} bytes from data provider", written);
-    return written;
-}
-
 // write from a buffer
 bool S3IO::writeFromBuffer(IOChainContext& iocontext, const char* buff,
                            dav_size_t size, const std::string& uploadId,
@@ -206,26 +200,23 @@ dav_ssize_t S3IO::writeFromProvider(IOChainContext & iocontext, ContentProvider
   DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Initiating multi-part upload towards {} to upload file with size {}", iocontext._uri, provider.getSize());
   std::string uploadId = initiateMultipart(iocontext);
 
-  size_t remaining = provider.getSize();
-  const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 256; // 256 MB
-
-  std::vector<char> buffer;
-  buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
-
+  // parts may complete out of order, etags are stored by part index
+  std::mutex etagsMtx;
   std::vector<std::string> etags;
 
-  size_t partNumber = 0;
-  while(remaining > 0) {
-    size_t toRead = std::min( (dav_size_t) provider.getSize(), MAX_CHUNK_SIZE);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "S3IO write: toRead from cb {}", toRead);
+  ChunkedUploader uploader(iocontext, get_s3_part_size(iocontext, provider.getSize()));
 
-    dav_size_t bytesRead = fillBufferWithProviderData(buffer, MAX_CHUNK_SIZE, provider);
-    if(bytesRead == 0) break; // EOF
+  size_t nparts = uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    std::string etag = writeChunk(iocontext, buff, size, uploadId, index + 1);
 
-    partNumber++;
-    etags.emplace_back(writeChunk(iocontext, buffer.data(), bytesRead, uploadId, partNumber));
-  }
+    std::lock_guard<std::mutex> lock(etagsMtx);
+    if(etags.size() <= index) {
+      etags.resize(index + 1);
+    }
+    etags[index] = etag;
+  });
 
+  etags.resize(nparts);
   commitChunks(iocontext, uploadId, etags);
   return provider.getSize();
 }
@@ -265,33 +256,35 @@ void S3IO::performUgrS3MultiPart(IOChainContext & iocontext, const std::string &
         Uri uri(posturl);
         std::string uploadId = initiateMultipart(iocontext, posturl);
 
-        const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 256; // 256 MB
-        std::vector<char> buffer;
-        buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
-
-        size_t nchunks = (provider.getSize() / MAX_CHUNK_SIZE) + 2;
+        const dav_size_t partSize = get_s3_part_size(iocontext, provider.getSize());
+        size_t nchunks = (provider.getSize() / partSize) + 2;
         DynafedUris uris = retrieveDynafedUris(iocontext, uploadId, pluginId, nchunks);
 
         if(uris.chunks.size() != nchunks) {
-          DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CHAIN, "Dynafed returned different number of URIs than expected: {} vs {]", "} retrieveDynafedUris: Obtained list with {} chunk URIs in total", uris.chunks.size(), nchunks);
+          DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CHAIN, "Dynafed returned different number of URIs than expected: {} vs {}", uris.chunks.size(), nchunks);
           throw DavixException("S3::MultiPart", StatusCode::InvalidServerResponse, "Dynafed returned different number of URIs than expected");
         }
 
+        std::mutex etagsMtx;
         std::vector<std::string> etags;
-        size_t partNumber = 1;
-        uint64_t remaining = provider.getSize();
 
-        while(remaining > 0) {
-          dav_size_t bytesRetrieved = fillBufferWithProviderData(buffer, MAX_CHUNK_SIZE, provider);
-          if(bytesRetrieved == 0) {
-            break; // EOF
+        ChunkedUploader uploader(iocontext, partSize);
+
+        size_t nparts = uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+          if(index >= uris.chunks.size()) {
+            throw DavixException("S3::MultiPart", StatusCode::InvalidServerResponse, "Not enough chunk URIs for the amount of data provided");
           }
 
-          etags.emplace_back(writeChunk(iocontext, buffer.data(), bytesRetrieved, Uri(uris.chunks[partNumber-1]), partNumber));
-          partNumber++;
-          remaining -= bytesRetrieved;
-        }
+          std::string etag = writeChunk(iocontext, buff, size, Uri(uris.chunks[index]), index + 1);
+
+          std::lock_guard<std::mutex> lock(etagsMtx);
+          if(etags.size() <= index) {
+            etags.resize(index + 1);
+          }
+          etags[index] = etag;
+        });
 
+        etags.resize(nparts);
         commitChunks(iocontext, Uri(uris.post), etags);
     }
     CATCH_DAVIX(err);
@@ -0,0 +1,121 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "StatCacheOps.hpp"
+#include <davix_context_internal.hpp>
+#include <core/StatCache.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+namespace Davix {
+
+namespace {
+
+// drop the cached entries of a resource once the operation modifying it
+// is over, whatever its outcome
+struct InvalidateOnExit {
+  InvalidateOnExit(IOChainContext & iocontext, const Uri & uri)
+  : cache(ContextExplorer::StatCacheFromContext(iocontext._context)), uri(uri) {}
+
+  ~InvalidateOnExit() {
+    cache.invalidate(uri);
+  }
+
+  StatCache & cache;
+  Uri uri;
+};
+
+}
+
+StatCacheOps::StatCacheOps() : HttpIOChain() {}
+
+StatCacheOps::~StatCacheOps() {}
+
+StatInfo & StatCacheOps::statInfo(IOChainContext & iocontext, StatInfo & st_info) {
+  StatCache & cache = ContextExplorer::StatCacheFromContext(iocontext._context);
+  if(!cache.isEnabled()) {
+    return HttpIOChain::statInfo(iocontext, st_info);
+  }
+
+  std::string error;
+  switch(cache.get(iocontext._uri, st_info, error)) {
+    case StatCache::Hit:
+      DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CHAIN, "stat of {} served from cache", iocontext._uri);
+      return st_info;
+    case StatCache::NotFound:
+      throw DavixException(davix_scope_stat_str(), StatusCode::FileNotFound, error);
+    case StatCache::Miss:
+      break;
+  }
+
+  try {
+    HttpIOChain::statInfo(iocontext, st_info);
+  }
+  catch(DavixException & e) {
+    if(e.code() == StatusCode::FileNotFound) {
+      cache.putNotFound(iocontext._uri, e.what());
+    }
+    throw;
+  }
+
+  cache.put(iocontext._uri, st_info);
+  return st_info;
+}
+
+bool StatCacheOps::nextSubItem(IOChainContext & iocontext, std::string & entry_name, StatInfo & info) {
+  if(!HttpIOChain::nextSubItem(iocontext, entry_name, info)) {
+    return false;
+  }
+
+  StatCache & cache = ContextExplorer::StatCacheFromContext(iocontext._context);
+  if(cache.isEnabled()) {
+    cache.putChild(iocontext._uri, entry_name, info);
+  }
+  return true;
+}
+
+void StatCacheOps::deleteResource(IOChainContext & iocontext) {
+  InvalidateOnExit invalidate(iocontext, iocontext._uri);
+  HttpIOChain::deleteResource(iocontext);
+}
+
+void StatCacheOps::makeCollection(IOChainContext & iocontext) {
+  InvalidateOnExit invalidate(iocontext, iocontext._uri);
+  HttpIOChain::makeCollection(iocontext);
+}
+
+void StatCacheOps::move(IOChainContext & iocontext, const std::string & target_url) {
+  InvalidateOnExit invalidate_source(iocontext, iocontext._uri);
+  InvalidateOnExit invalidate_target(iocontext, Uri(target_url));
+  HttpIOChain::move(iocontext, target_url);
+}
+
+dav_ssize_t StatCacheOps::writeFromProvider(IOChainContext & iocontext, ContentProvider &provider) {
+  InvalidateOnExit invalidate(iocontext, iocontext._uri);
+  return HttpIOChain::writeFromProvider(iocontext, provider);
+}
+
+bool StatCacheOps::commitChunks(IOChainContext& iocontext, const std::string &uploadId,
+                                const std::vector<std::string> &etags) {
+  InvalidateOnExit invalidate(iocontext, iocontext._uri);
+  return HttpIOChain::commitChunks(iocontext, uploadId, etags);
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_STAT_CACHE_OPS_HPP
+#define DAVIX_FILEOPS_STAT_CACHE_OPS_HPP
+
+#include <fileops/httpiochain.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Serves stat from the Context stat cache, see StatCache, and fills it
+// from directory listings. Operations modifying a resource drop its
+// cached entries, and those of its parent.
+//------------------------------------------------------------------------------
+class StatCacheOps : public HttpIOChain {
+public:
+  StatCacheOps();
+  virtual ~StatCacheOps();
+
+  virtual StatInfo & statInfo(IOChainContext & iocontext, StatInfo & st_info);
+
+  virtual bool nextSubItem(IOChainContext & iocontext, std::string & entry_name, StatInfo & info);
+
+  virtual void deleteResource(IOChainContext & iocontext);
+
+  virtual void makeCollection(IOChainContext & iocontext);
+
+  virtual void move(IOChainContext & iocontext, const std::string & target_url);
+
+  virtual dav_ssize_t writeFromProvider(IOChainContext & iocontext, ContentProvider &provider);
+
+  virtual bool commitChunks(IOChainContext& iocontext, const std::string &uploadId,
+                            const std::vector<std::string> &etags);
+};
+
+}
+
+#endif
@@ -20,10 +20,13 @@
 */
 
 #include "SwiftIO.hpp"
+#include "ChunkedUpload.hpp"
 #include <core/ContentProvider.hpp>
 #include <utils/davix_logger_internal.hpp>
 #include <utils/davix_swift_utils.hpp>
 
+#include <mutex>
+
 
 namespace Davix{
 
@@ -45,43 +48,27 @@ static bool should_use_swift_multipart(IOChainContext & context, dav_size_t size
         return true;
     }
 
-    return size > (1024 * 1024 * 512); // 512 MB
+    return size > context._reqparams->getMultipartUploadThreshold();
 }
 
-SwiftIO::SwiftIO() {
+// Swift segments are at most 5 GB
+static dav_size_t get_swift_segment_size(IOChainContext & context) {
+    const dav_size_t MAX_SEGMENT_SIZE = 1024ULL * 1024 * 1024 * 5; // 5 GB
 
-}
-
-SwiftIO::~SwiftIO() {
+    dav_size_t segmentSize = context._reqparams->getMultipartUploadPartSize();
+    if(segmentSize == 0) {
+        segmentSize = 1024 * 1024 * 64; // 64 MB
+    }
 
+    return std::min(segmentSize, MAX_SEGMENT_SIZE);
 }
 
-static dav_size_t fillBufferWithProviderData(std::vector<char> &buffer, const dav_size_t maxChunkSize, ContentProvider &provider) {
-    dav_size_t written = 0u;
-    dav_size_t remaining = maxChunkSize;
-
-    while(true) {
-        dav_ssize_t bytesRead = provider.pullBytes(buffer.data(), remaining);
-        if(bytesRead < 0) {
-            throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle, fmt::format("Error when reading from callback: {}", bytesRead));
-        }
-
-        remaining -= bytesRead;
-        written += bytesRead;
+SwiftIO::SwiftIO() {
 
-        if(bytesRead == 0) {
-            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Reached data provider EOF, received 0 bytes, even though asked for {}", remaining);
-            break; // EOF
-        }
+}
 
-        if(remaining == 0) {
-            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Data provider buffer has been filled");
-            break; // buffer is full
-        }
-    }
+SwiftIO::~SwiftIO() {
 
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrieved {} bytes from data provider", written);
-    return written;
 }
 
 std::string SwiftIO::writeChunk(IOChainContext &iocontext, const char *buff, dav_size_t size, int partNumber) {
@@ -217,27 +204,24 @@ dav_ssize_t SwiftIO::writeFromProvider(IOChainContext & iocontext, ContentProvid
 
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Initiating large file upload towards {} to upload file with size {}", iocontext._uri, provider.getSize());
 
-    size_t remaining = provider.getSize();
-    const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 256; // 256 MB
     const size_t MAX_MANIFEST_SEGMENTS = 1000;
 
-    std::vector<char> buffer;
-    buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
-
+    // segments may complete out of order, props are stored by segment index
+    std::mutex propsMtx;
     std::vector<Prop> props;
 
-    size_t partNumber = 0;
-
-    while(remaining > 0) {
-        size_t toRead = std::min( (dav_size_t) provider.getSize(), MAX_CHUNK_SIZE);
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "SwiftIO write: toRead from cb {}", toRead);
+    ChunkedUploader uploader(iocontext, get_swift_segment_size(iocontext));
+    size_t nsegments = uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+        std::string etag = writeChunk(iocontext, buff, size, index + 1);
 
-        dav_size_t bytesRead = fillBufferWithProviderData(buffer, MAX_CHUNK_SIZE, provider);
-        if(bytesRead == 0) break; // EOF
+        std::lock_guard<std::mutex> lock(propsMtx);
+        if(props.size() <= index) {
+            props.resize(index + 1);
+        }
+        props[index] = Prop(etag, size);
+    });
 
-        partNumber++;
-        props.emplace_back(writeChunk(iocontext, buffer.data(), bytesRead, partNumber), bytesRead);
-    }
+    props.resize(nsegments);
 
     if(props.size() > MAX_MANIFEST_SEGMENTS){ // if segment number is larger than max_manifest_segments (by default 1000), use inline segments
         commitInlineChunks(iocontext, props, MAX_MANIFEST_SEGMENTS);
@@ -26,7 +26,7 @@
 
 namespace Davix{
 
-typedef std::pair <std::string, int> Prop;
+typedef std::pair <std::string, dav_size_t> Prop;
 
 class SwiftIO : public HttpIOChain {
 public:
@@ -28,6 +28,8 @@
 #include "AzureIO.hpp"
 #include "S3IO.hpp"
 #include "SwiftIO.hpp"
+#include "BlockCacheOps.hpp"
+#include "StatCacheOps.hpp"
 
 namespace Davix{
 
@@ -37,12 +39,13 @@ ChainFactory::ChainFactory(){}
 
 HttpIOChain& ChainFactory::instanceChain(const CreationFlags & flags, HttpIOChain & c){
     HttpIOChain* elem;
-    elem= c.add(new MetalinkOps())->add(new AutoRetryOps())->add(new S3MetaOps())->add(new SwiftMetaOps())->add(new AzureMetaOps())->add(new HttpMetaOps());
+    elem= c.add(new MetalinkOps())->add(new AutoRetryOps())->add(new StatCacheOps())->add(new S3MetaOps())->add(new SwiftMetaOps())->add(new AzureMetaOps())->add(new HttpMetaOps());
 
     // add posix to the chain if needed
     if(flags[CHAIN_POSIX] == true){
         elem = elem->add(new HttpIOBuffer());
     }
+    elem = elem->add(new BlockCacheOps());
 
     elem->add(new S3IO())->add(new SwiftIO())->add(new AzureIO())->add(new HttpIO())->add(new HttpIOVecOps());
     return c;
@@ -42,6 +42,10 @@
 #include <utils/stringutils.hpp>
 #include "libs/alibxx/crypto/base64.hpp"
 #include <neon/neonrequest.hpp>
+#include <fileops/ListingPrefetch.hpp>
+#include <fileops/ListingReader.hpp>
+#include <fileops/PartitionedListing.hpp>
+#include <davix_context_internal.hpp>
 
 
 using namespace StrUtil;
@@ -62,11 +66,26 @@ static const std::string quota_stat("<?xml version=\"1.0\" encoding=\"utf-8\" ?>
 
 struct DirHandle{
 
-    DirHandle(HttpRequest* req, XMLPropParser * p): request(req), parser(p){}
+    DirHandle(HttpRequest* req, XMLPropParser * p): request(req), parser(p), body_done(false){}
 
     std::unique_ptr<HttpRequest> request;
     std::unique_ptr<Davix::XMLPropParser> parser;
+    ListingReader reader;
 
+    // paginated listings: the pages after the first one, fetched ahead
+    std::unique_ptr<ListingPrefetcher> prefetcher;
+    bool body_done;
+
+    // flat S3 listings over several connections, replaces request and parser
+    std::unique_ptr<PartitionedListing> partitioned;
+
+    // request the page after the first one as soon as its marker is known
+    void prefetchNextPage(){
+        const std::string marker = parser->getNextMarker();
+        if(prefetcher && (body_done || !marker.empty())){
+            prefetcher->start(marker);
+        }
+    }
 
 };
 
@@ -191,23 +210,6 @@ int dav_stat_mapper_http_get(Context& context, const RequestParams* params, cons
 }
 
 
-dav_ssize_t incremental_listdir_parsing(HttpRequest* req, XMLPropParser * parser, dav_size_t s_buff, const std::string & scope){
-    DavixError* tmp_err=NULL;
-
-    char buffer[s_buff+1];
-    const dav_ssize_t ret = req->readSegment(buffer, s_buff, &tmp_err);
-    checkDavixError(&tmp_err);
-    if(ret >= 0){
-        buffer[ret]= '\0';
-        parser->parseChunk(buffer, ret);
-    }else{
-        throw DavixException(scope, StatusCode::UnknownError, "Unknown readSegment error");
-    }
-
-    return ret;
-}
-
-
 dav_ssize_t getStatInfo(Context & c, const Uri & url, const RequestParams * p,
                       struct StatInfo& st_info){
     RequestParams params(p);
@@ -448,19 +450,16 @@ int internal_checksum(Context & c, const Uri & url, const RequestParams *p, std:
 
 bool wedav_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> wedav_get_next_property");
-    const size_t read_size = 2048;
-
 
     HttpRequest& req = *(handle->request); // setup env again
     XMLPropParser& parser = *(handle->parser);
 
     size_t prop_size = parser.getProperties().size();
-    ssize_t s_resu = read_size;
 
     while( prop_size == 0
-          && s_resu > 0){ // request not complete and current data too smalls
+          && !handle->reader.finished()){ // request not complete and current data too smalls
         // continue the parsing until one more result
-       s_resu = incremental_listdir_parsing(&req, &parser, read_size, "WebDav::listing");
+       handle->reader.read(req, parser, "WebDav::listing");
 
        prop_size = parser.getProperties().size();
     }
@@ -479,7 +478,6 @@ bool wedav_get_next_property(std::unique_ptr<DirHandle> & handle, std::string &
 
 
 void webdav_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
-    dav_ssize_t s_resu;
 
     DavixError* tmp_err=NULL;
     handle.reset(new DirHandle(new PropfindRequest(context, url, &tmp_err), new DavPropXMLParser()));
@@ -500,10 +498,10 @@ void webdav_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & c
 
     size_t prop_size = 0;
     do{ // parse the begining of the request until the first property -> directory property
-       s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+       handle->reader.read(http_req, parser, davix_scope_directory_listing_str());
 
        prop_size = parser.getProperties().size();
-       if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+       if(handle->reader.finished() && prop_size <1){ // verify request status : if req done + no data -> error
            throw DavixException(davix_scope_directory_listing_str(), StatusCode::WebDavPropertiesParsingError, "bad server answer, not a valid WebDav PROPFIND answer");
        }
 
@@ -668,29 +666,102 @@ bool is_a_container(Uri u) {
     return false;
 }
 
-bool s3_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info);
-
-void swift_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
-    (void) body;
-    dav_ssize_t s_resu;
+//
+// Fetch and parse one whole page of a paginated S3, Swift or Azure listing
+//
+static void fetch_listing_page(Context & context, const RequestParams & params, const Uri & url, const std::string & marker,
+                               XMLPropParser & parser, ListingPage & page){
     DavixError* tmp_err=NULL;
+    Uri page_url(url);
+    page_url.addQueryParam("marker", marker);
+
+    GetRequest req(context, page_url, &tmp_err);
+    checkDavixError(&tmp_err);
+
+    req.setParameters(params);
+    req.beginRequest(&tmp_err);
+    checkDavixError(&tmp_err);
+
+    check_file_status(req, davix_scope_directory_listing_str());
+
+    ListingReader reader;
+    while(!reader.finished()){
+        reader.read(req, parser, davix_scope_directory_listing_str());
+    }
+
+    page.entries.swap(parser.getProperties());
+    page.next_marker = parser.getNextMarker();
+}
+
+//
+// Next entry of a paginated listing: from the answer to the first request,
+// then from the pages prefetched after it
+//
+static bool paged_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info, const std::string & scope){
+    HttpRequest& req = *(handle->request); // setup env again
+    XMLPropParser& parser = *(handle->parser);
+    std::deque<FileProperties> & props = parser.getProperties();
+
+    while(props.empty()){
+        if(!handle->body_done){
+            // continue the parsing until one more result
+            handle->reader.read(req, parser, scope);
+            handle->body_done = handle->reader.finished();
+            handle->prefetchNextPage();
+        }
+        else if(!handle->prefetcher || !handle->prefetcher->next(props)){
+            return false; // end of the last page, end of the story
+        }
+    }
+
+    FileProperties & front = props.front();
+    name_entry.swap(front.filename);
+    info = front.info;
+    props.pop_front(); // clean the current element
+    return true;
+}
+
+bool s3_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info);
 
+//
+// Listing request of a Swift container, and the parser for its answer
+//
+static XMLPropParser* swift_listing_request(const RequestParams* params, const Uri & url, Uri & list_url){
     if(params->getSwiftListingMode() == SwiftListingMode::Hierarchical){
-        Uri new_url = Swift::swiftUriTransformer(url, params, true);
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new SwiftPropParser(Swift::extract_swift_path(url))));
+        list_url = Swift::swiftUriTransformer(url, params, true);
+        return new SwiftPropParser(Swift::extract_swift_path(url));
     }
     else if(params->getSwiftListingMode() == SwiftListingMode::SemiHierarchical){
-        Uri new_url = Swift::swiftUriTransformer(url, params, false);
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new SwiftPropParser(Swift::extract_swift_path(url))));
+        list_url = Swift::swiftUriTransformer(url, params, false);
+        return new SwiftPropParser(Swift::extract_swift_path(url));
     }
-    else{
-        if(is_a_container(url) == false){
-            throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a Swift container");
-        }
-        handle.reset(new DirHandle(new GetRequest(context, url, &tmp_err), new SwiftPropParser()));
+    list_url = url;
+    return new SwiftPropParser();
+}
+
+void swift_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
+    (void) body;
+    DavixError* tmp_err=NULL;
+
+    if(params->getSwiftListingMode() != SwiftListingMode::Hierarchical &&
+       params->getSwiftListingMode() != SwiftListingMode::SemiHierarchical && is_a_container(url) == false){
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a Swift container");
     }
+
+    Uri list_url;
+    XMLPropParser* list_parser = swift_listing_request(params, url, list_url);
+    handle.reset(new DirHandle(new GetRequest(context, list_url, &tmp_err), list_parser));
     checkDavixError(&tmp_err);
 
+    RequestParams page_params(params);
+    page_params.addHeader("Accept", "application/xml");
+    handle->prefetcher.reset(new ListingPrefetcher(ContextExplorer::ExecutorFromContext(context),
+        [&context, page_params, url](const std::string & marker, ListingPage & page){
+            Uri page_url;
+            std::unique_ptr<XMLPropParser> parser(swift_listing_request(&page_params, url, page_url));
+            fetch_listing_page(context, page_params, page_url, marker, *parser, page);
+        }));
+
 
     const int operation_timeout = params->getOperationTimeout()->tv_sec;
     HttpRequest & http_req = *(handle->request);
@@ -708,10 +779,10 @@ void swift_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & co
 
     size_t prop_size = 0;
     do{ // first entry -> container information
-        s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+        handle->reader.read(http_req, parser, davix_scope_directory_listing_str());
 
         prop_size = parser.getProperties().size();
-        if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+        if(handle->reader.finished() && prop_size <1){ // verify request status : if req done + no data -> error
             throw DavixException(davix_scope_directory_listing_str(), StatusCode::ParsingError, "Invalid server response, not a Swift listing or the directory is empty");
         }
         if(timestamp_timeout < time(NULL)){
@@ -720,6 +791,7 @@ void swift_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & co
 
     }while( prop_size < 1); // prop < 1 means not enough data
 
+    handle->prefetchNextPage();
 }
 
 bool swift_directory_listing(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & uri, const std::string & body, std::string & name_entry, StatInfo & info){
@@ -931,7 +1003,6 @@ void s3StatMapper(Context& context, const RequestParams* params, const Uri & uri
             Uri new_url = S3::s3UriTransformer(uri, p, true);
             DirHandle handle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(uri, params->getAwsAlternate())));
 
-            dav_ssize_t s_resu=0;
 
             const int operation_timeout = p.getOperationTimeout()->tv_sec;
             HttpRequest & http_req = *(handle.request);
@@ -949,7 +1020,7 @@ void s3StatMapper(Context& context, const RequestParams* params, const Uri & uri
             size_t prop_size = 0;
             do{ // first entry
                TRY_DAVIX{
-                    s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, scope);
+                    handle.reader.read(http_req, parser, scope);
                }CATCH_DAVIX(&tmp_err)
 
                if(tmp_err && (tmp_err->getStatus() == StatusCode::IsNotADirectory)){
@@ -959,7 +1030,7 @@ void s3StatMapper(Context& context, const RequestParams* params, const Uri & uri
                 }
 
                prop_size = parser.getProperties().size();
-               if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+               if(handle.reader.finished() && prop_size <1){ // verify request status : if req done + no data -> error
                   throw DavixException(scope, StatusCode::ParsingError, "Invalid server response, not a S3 listing");
                }
                if(timestamp_timeout < time(NULL)){
@@ -1009,68 +1080,100 @@ StatInfo & S3MetaOps::statInfo(IOChainContext & iocontext, StatInfo & st_info){
 
 bool s3_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> s3_get_next_property");
-    const size_t read_size = 2048;
-
-
-    HttpRequest& req = *(handle->request); // setup env again
-    XMLPropParser& parser = *(handle->parser);
-
-    size_t prop_size = parser.getProperties().size();
-    ssize_t s_resu = read_size;
-
-    while( prop_size == 0
-          && s_resu > 0){ // execute request only if no property are available
-
-        // continue the parsing until one more result
-       s_resu = incremental_listdir_parsing(&req, &parser, read_size, "S3::listing");
-       prop_size = parser.getProperties().size();
-    }
-
-
-    if(prop_size == 0){
-        return false; // end of the request, end of the story
+    if(handle->partitioned){
+        FileProperties entry;
+        if(!handle->partitioned->next(entry)){
+            return false;
+        }
+        name_entry.swap(entry.filename);
+        info = entry.info;
+        return true;
     }
-
-    FileProperties & front = parser.getProperties().front();
-    name_entry.swap(front.filename);
-    info = front.info;
-    parser.getProperties().pop_front(); // clean the current element
-    return true;
+    return paged_get_next_property(handle, name_entry, info, "S3::listing");
 }
 
+//
+// Flat listing of a whole bucket, split in key ranges listed concurrently
+//
+static void s3_start_partitioned_listing(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url){
+    const size_t parallelism = params->getS3ListingParallelism();
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Listing {} over {} connections", url, parallelism);
+
+    RequestParams page_params(params);
+    PartitionedListing::PageFetcher fetcher = [&context, page_params, url](const std::string & marker, ListingPage & page){
+        // no delimiter, the entry names are the keys
+        S3PropParser parser(S3ListingMode::Flat, "");
+        fetch_listing_page(context, page_params, url, marker, parser, page);
+        if(!page.entries.empty()){
+            page.entries.pop_front(); // bucket entry
+        }
+    };
 
-void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
-    (void) body;
-    dav_ssize_t s_resu;
-    DavixError* tmp_err=NULL;
-    bool listing_buckets;
+    handle.reset(new DirHandle(NULL, NULL));
+    handle->partitioned.reset(new PartitionedListing(ContextExplorer::ExecutorFromContext(context), fetcher,
+                                                     parallelism, parallelism * 10000));
+    handle->partitioned->waitFirstPage();
+}
 
+//
+// Listing request of an S3 or GCloud directory, and the parser for its answer
+//
+static XMLPropParser* s3_listing_request(const RequestParams* params, const Uri & url, Uri & list_url){
     if(params->getProtocol() == RequestProtocol::Gcloud) {
-        Uri new_url = gcloud::getListingURI(url, params);
+        list_url = gcloud::getListingURI(url, params);
 
         std::string prefix = gcloud::extract_path(url);
         if(prefix != "/") prefix = "/" + prefix;
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(),  prefix)));
+        return new S3PropParser(params->getS3ListingMode(),  prefix);
     }
     else if(params->getS3ListingMode() == S3ListingMode::Hierarchical){
-        Uri new_url = S3::s3UriTransformer(url, params, true);
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()))));
+        list_url = S3::s3UriTransformer(url, params, true);
+        return new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()));
     }
     else if(params->getS3ListingMode() == S3ListingMode::SemiHierarchical){
-        Uri new_url = S3::s3UriTransformer(url, params, false);
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()))));
+        list_url = S3::s3UriTransformer(url, params, false);
+        return new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()));
     }
-    else{
-        if(is_a_bucket(url) == false){
-           throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a S3 bucket");
-        }
-        handle.reset(new DirHandle(new GetRequest(context, url, &tmp_err), new S3PropParser()));
+    list_url = url;
+    return new S3PropParser();
+}
+
+
+void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
+    (void) body;
+    DavixError* tmp_err=NULL;
+    bool listing_buckets;
+
+    if(params->getProtocol() != RequestProtocol::Gcloud && params->getS3ListingMode() == S3ListingMode::Flat && is_a_bucket(url) == false){
+       throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a S3 bucket");
     }
-    checkDavixError(&tmp_err);
 
     // Check if we are listing available buckets
     listing_buckets = (params->getAwsAlternate() && url.getPath() == "/");
 
+    if(params->getProtocol() != RequestProtocol::Gcloud && params->getS3ListingMode() == S3ListingMode::Flat &&
+       params->getS3ListingParallelism() > 1 && !listing_buckets){
+        s3_start_partitioned_listing(handle, context, params, url);
+        return;
+    }
+
+    Uri list_url;
+    XMLPropParser* list_parser = s3_listing_request(params, url, list_url);
+    handle.reset(new DirHandle(new GetRequest(context, list_url, &tmp_err), list_parser));
+    checkDavixError(&tmp_err);
+
+    // every page starts with the bucket entry, the first one is handled below
+    RequestParams page_params(params);
+    handle->prefetcher.reset(new ListingPrefetcher(ContextExplorer::ExecutorFromContext(context),
+        [&context, page_params, url](const std::string & marker, ListingPage & page){
+            Uri page_url;
+            std::unique_ptr<XMLPropParser> parser(s3_listing_request(&page_params, url, page_url));
+            fetch_listing_page(context, page_params, page_url, marker, *parser, page);
+            if(!page.entries.empty()){
+                page.entries.pop_front();
+            }
+        }));
+
 
     const int operation_timeout = params->getOperationTimeout()->tv_sec;
     HttpRequest & http_req = *(handle->request);
@@ -1087,10 +1190,10 @@ void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & conte
 
     size_t prop_size = 0;
     do{ // first entry -> bucket information
-       s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+       handle->reader.read(http_req, parser, davix_scope_directory_listing_str());
 
        prop_size = parser.getProperties().size();
-       if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+       if(handle->reader.finished() && prop_size <1){ // verify request status : if req done + no data -> error
            throw DavixException(davix_scope_directory_listing_str(), StatusCode::ParsingError, "Invalid server response, not a S3 listing");
        }
        if(timestamp_timeout < time(NULL)){
@@ -1108,6 +1211,8 @@ void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & conte
             parser.getProperties().pop_front(); // suppress the bucket name entry
     }
 
+    handle->prefetchNextPage();
+
 }
 
 
@@ -1165,7 +1270,6 @@ void azureStatMapper(Context& context, const RequestParams* params, const Uri &
             Uri new_url = Azure::transformURI(uri, p, true);
             DirHandle handle(new GetRequest(context, new_url, &tmp_err), new AzurePropParser(Azure::extract_azure_filename(uri)));
 
-            dav_ssize_t s_resu=0;
 
             const int operation_timeout = p.getOperationTimeout()->tv_sec;
             HttpRequest & http_req = *(handle.request);
@@ -1181,10 +1285,10 @@ void azureStatMapper(Context& context, const RequestParams* params, const Uri &
 
             size_t prop_size = 0;
             do{ // first entry -> container information
-                s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+                handle.reader.read(http_req, parser, davix_scope_directory_listing_str());
 
                 prop_size = parser.getProperties().size();
-                if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+                if(handle.reader.finished() && prop_size <1){ // verify request status : if req done + no data -> error
                     throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "The specified directory does not exist");
                 }
                 if(timestamp_timeout < time(NULL)){
@@ -1220,10 +1324,17 @@ StatInfo & AzureMetaOps::statInfo(IOChainContext & iocontext, StatInfo & st_info
 
 static void azure_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body) {
     DavixError* tmp_err=NULL;
-    dav_ssize_t s_resu;
 
     Uri new_url = Davix::Azure::transformURI(url, params, true);
     handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new AzurePropParser(Davix::Azure::extract_azure_filename(url))));
+    checkDavixError(&tmp_err);
+
+    RequestParams page_params(params);
+    handle->prefetcher.reset(new ListingPrefetcher(ContextExplorer::ExecutorFromContext(context),
+        [&context, page_params, new_url, url](const std::string & marker, ListingPage & page){
+            AzurePropParser parser(Davix::Azure::extract_azure_filename(url));
+            fetch_listing_page(context, page_params, new_url, marker, parser, page);
+        }));
 
     const int operation_timeout = params->getOperationTimeout()->tv_sec;
     HttpRequest & http_req = *(handle->request);
@@ -1239,10 +1350,10 @@ static void azure_start_listing_query(std::unique_ptr<DirHandle> & handle, Conte
 
     size_t prop_size = 0;
     do{ // first entry -> container information
-       s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+       handle->reader.read(http_req, parser, davix_scope_directory_listing_str());
 
        prop_size = parser.getProperties().size();
-       if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+       if(handle->reader.finished() && prop_size <1){ // verify request status : if req done + no data -> error
            throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "The specified directory does not exist");
        }
        if(timestamp_timeout < time(NULL)){
@@ -1250,35 +1361,12 @@ static void azure_start_listing_query(std::unique_ptr<DirHandle> & handle, Conte
        }
     }while( prop_size < 1); // prop < 1 means not enough data
 
+    handle->prefetchNextPage();
 }
 
 bool azure_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info) {
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> azure_get_next_property");
-    const size_t read_size = 2048;
-
-    HttpRequest& req = *(handle->request); // setup env again
-    XMLPropParser& parser = *(handle->parser);
-
-    size_t prop_size = parser.getProperties().size();
-    ssize_t s_resu = read_size;
-
-    while( prop_size == 0
-          && s_resu > 0){ // execute request only if no property are available
-
-        // continue the parsing until one more result
-       s_resu = incremental_listdir_parsing(&req, &parser, read_size, "S3::listing");
-       prop_size = parser.getProperties().size();
-    }
-
-    if(prop_size == 0){
-        return false; // end of the request, end of the story
-    }
-
-    FileProperties & front = parser.getProperties().front();
-    name_entry.swap(front.filename);
-    info = front.info;
-    parser.getProperties().pop_front(); // clean the current element
-    return true;
+    return paged_get_next_property(handle, name_entry, info, "Azure::listing");
 }
 
 static bool azure_directory_listing(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & uri, const std::string & body, std::string & name_entry, StatInfo & info){
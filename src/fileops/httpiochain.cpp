@@ -89,6 +89,12 @@ bool HttpIOChain::open(IOChainContext & iocontext, int flags){
      CHAIN_FORWARD(prefetchInfo(iocontext, offset, size_read, adv));
  }
 
+bool HttpIOChain::isCachingReads(IOChainContext & iocontext){
+    if(_next.get() != NULL)
+        return _next->isCachingReads(iocontext);
+    return false;
+}
+
 dav_ssize_t HttpIOChain::readFull(IOChainContext & iocontext, std::vector<char> &buffer){
     CHAIN_FORWARD(readFull(iocontext, buffer));
 }
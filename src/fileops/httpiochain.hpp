@@ -129,6 +129,10 @@ public:
 
     virtual void prefetchInfo(IOChainContext & iocontext, off_t offset, dav_size_t size_read, advise_t adv);
 
+    // true when preads are served from a block cache, sequential readers
+    // should then go through pread instead of streaming the file
+    virtual bool isCachingReads(IOChainContext & iocontext);
+
     virtual dav_ssize_t readFull(IOChainContext & iocontext, std::vector<char> & buffer);
 
     // overloaded version for string content
@@ -23,8 +23,11 @@
 #include "httpiovec.hpp"
 #include <utils/davix_logger_internal.hpp>
 #include <utils/stringutils.hpp>
-#include "libs/IntervalTree.h"
+#include <core/TaskGroup.hpp>
+#include <core/HostCapabilities.hpp>
+#include <davix_context_internal.hpp>
 
+#include <atomic>
 #include <map>
 
 #define DBG(message) std::cerr << __FILE__ << ":" << __LINE__ << " -- " << #message << " = " << message << std::endl;
@@ -100,13 +103,16 @@ int davIOVecProvider(const SortedRanges ranges, dav_size_t & counter, dav_off_t
 
 // do a multi-range on selected ranges
 MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
-                                                 const IntervalTree<ElemChunk> &tree,
-                                                 const SortedRanges & ranges) {
+                                                 const RangeIndex & index,
+                                                 const SortedRanges & ranges,
+                                                 dav_size_t maxHeaderSize) {
 
     DavixError * tmp_err=NULL;
     dav_ssize_t tmp_ret=-1, ret = 0;
     ptrdiff_t p_diff=0;
     dav_size_t counter = 0;
+    dav_size_t rejected_header = 0;
+    int rejected_code = 0;
     MultirangeResult::OperationResult opresult = MultirangeResult::SUCCESS;
 
     // calculate total bytes to be read (approximate, since ranges could overlap)
@@ -117,10 +123,9 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
 
     std::function<int (dav_off_t &, dav_off_t &)> offsetProvider = std::bind(&davIOVecProvider, ranges, std::ref(counter), std::placeholders::_1, std::placeholders::_2);
 
-    // header line need to be inferior to 8K on Apache2 / ngnix
-    // in Addition, some S3 implementation limit the total header size to 4k....
-    // 3900 bytes maximum for the range seems to be a ood compromise
-    std::vector< std::pair<dav_size_t, std::string> > vecRanges = generateRangeHeaders(3900, offsetProvider);
+    // the header budget comes from the host capability cache, 3900 bytes
+    // unless the server is known to reject that
+    std::vector< std::pair<dav_size_t, std::string> > vecRanges = generateRangeHeaders(maxHeaderSize, offsetProvider);
 
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> getPartialVec operation for {} vectors", ranges.size());
 
@@ -128,7 +133,7 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> getPartialVec request for {} chunks", it->first);
 
         if(it->first == 1){ // one chunk only : no need of multi part
-            ret += singleRangeRequest(iocontext, tree, ranges[p_diff].first, ranges[p_diff].second - ranges[p_diff].first + 1);
+            ret += singleRangeRequest(iocontext, index, ranges[p_diff].first, ranges[p_diff].second - ranges[p_diff].first + 1);
             p_diff += 1;
         }else{
             GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
@@ -142,7 +147,7 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
 
                     // looks like the server supports multi-range requests.. yay
                     if(retcode == 206) {
-                        ret = parseMultipartRequest(req, tree, &tmp_err);
+                        ret = parseMultipartRequest(req, index, &tmp_err);
 
                         // could not parse multipart response - server's broken?
                         // known to happen with ceph - return code is 206, but only
@@ -169,7 +174,7 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
                         else {
                             DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Simulating multi-part response from the contents of the entire file");
                             opresult = MultirangeResult::SUCCESS_BUT_NO_MULTIRANGE;
-                            ret = simulateMultiPartRequest(req, tree, &tmp_err);
+                            ret = simulateMultiPartRequest(req, index, &tmp_err);
                         }
                         break;
                     }
@@ -177,6 +182,19 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
                       ret = 0;
                       DavixError::clearError(&tmp_err);
                     }
+                    // Range header too large for the server, retry with smaller ones.
+                    // Some servers answer 400 for oversized headers too, but a 400
+                    // can mean anything: preadVec retries those only once
+                    else if((retcode == 400 || retcode == 413 || retcode == 431) &&
+                            maxHeaderSize > HostCapabilityCache::kMinHeaderSize) {
+                        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Multi-range request with a {} bytes Range header rejected with {}", it->second.size(), retcode);
+                        opresult = MultirangeResult::HEADER_REJECTED;
+                        rejected_header = it->second.size();
+                        rejected_code = retcode;
+                        req.endRequest(&tmp_err);
+                        DavixError::clearError(&tmp_err);
+                        break;
+                    }
                     else {
                         httpcodeToDavixError(req.getRequestCode(),davix_scope_http_request(),", ", &tmp_err);
                         ret = -1;
@@ -195,7 +213,7 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
 
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " <- getPartialVec operation for {} vectors", ranges.size());
     checkDavixError(&tmp_err);
-    return MultirangeResult(opresult, ret);
+    return MultirangeResult(opresult, ret, rejected_header, rejected_code);
 }
 
 /* fire off a single, one-range request */
@@ -212,130 +230,40 @@ dav_ssize_t HttpIOVecOps::singleRangeRequest(IOChainContext & iocontext,
     return size;
 }
 
-// merge user-provided ranges, add them to intervals
-typedef std::multimap<dav_off_t, dav_size_t> MergedRanges;
-static SortedRanges partialMerging(const IntervalTree<ElemChunk> &tree, const dav_size_t mergedist) {
-    MergedRanges merged;
-
-    std::vector<Interval<ElemChunk> > allranges_unsorted;
-    tree.findContained(0, std::numeric_limits<dav_size_t>::max(), allranges_unsorted);
-
-    MergedRanges allranges;
-    for(std::vector<Interval<ElemChunk> >::iterator it = allranges_unsorted.begin(); it != allranges_unsorted.end(); it++)
-        allranges.insert(std::make_pair(it->start, it->stop));
-
-    dav_off_t offset = allranges.begin()->first;
-    dav_off_t end = allranges.begin()->second;
-
-    for(MergedRanges::iterator it = allranges.begin(); it != allranges.end(); it++) {
-        if(end + (dav_off_t) mergedist >= it->first) {
-            end = it->second;
-        }
-        else {
-            merged.insert(std::make_pair(offset, end));
-            offset = it->first;
-            end = it->second;
-        }
-    }
-    merged.insert(std::make_pair(offset, end));
-
-    SortedRanges output;
-    for(MergedRanges::iterator it = merged.begin(); it != merged.end(); it++)
-        output.push_back(*it);
-
-    return output;
-}
-
-static IntervalTree<ElemChunk> buildIntervalTree(const DavIOVecInput *in, DavIOVecOuput *out, const dav_size_t count_vec) {
-    std::vector<Interval<ElemChunk> > intervals;
-
-    for(dav_size_t i = 0; i < count_vec; i++) {
-        dav_off_t start = in[i].diov_offset;
-        dav_off_t end = start + in[i].diov_size - 1;
-        ElemChunk elem(in+i, out+i);
-
-        intervals.push_back(Interval<ElemChunk>(start, end, elem));
-    }
-    return IntervalTree<ElemChunk>(intervals);
-}
-
-typedef struct thread_data {
-    HttpIOVecOps *ptr;
-    int thread_no;
-    const SortedRanges *ranges;
-    const IntervalTree<ElemChunk> *tree;
-    IOChainContext *iocontext;
-    dav_size_t start, end;
-
-    dav_ssize_t size;
-    std::exception_ptr exc;
-} thdata;
-
-void* parallelSingleRange(void *args) {
-
-    thdata *data = (thdata*) args;
-    const SortedRanges & ranges = *data->ranges;
-
-    data->size = 0;
-    for(dav_size_t i = data->start; i < data->end; i++) {
-        try {
-          data->size += data->ptr->singleRangeRequest(*data->iocontext, *data->tree,
-                                                      ranges[i].first,
-                                                      ranges[i].second - ranges[i].first + 1);
-        }
-        catch(const Davix::DavixException &err) {
-          data->exc = std::current_exception();
-          return NULL;
-        }
-    }
-
-    return NULL;
-}
-
-
 dav_ssize_t HttpIOVecOps::simulateMultirange(IOChainContext & iocontext,
-                                     const IntervalTree<ElemChunk> & tree,
+                                     const RangeIndex & index,
                                      const SortedRanges & ranges,
                                      const uint nconnections) {
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Simulating a multi-range request with {} vectors", ranges.size());
-    dav_ssize_t size = 0;
 
-    uint num_threads = nconnections;
-    if(num_threads > ranges.size()) {
-        num_threads = ranges.size();
+    // ranges are handed out one at a time, largest first, to whichever
+    // worker is free, so that a slow range does not hold back a statically
+    // assigned batch of others
+    std::vector<dav_size_t> order(ranges.size());
+    for(dav_size_t i = 0; i < ranges.size(); i++) {
+        order[i] = i;
     }
-    uint queries_per_thread = ranges.size() / num_threads;
-
-    pthread_t threads[num_threads];
-    thdata data[num_threads];
-    for(uint i = 0; i < num_threads; i++) {
-        data[i].ptr = this;
-        data[i].thread_no = i;
-        data[i].ranges = &ranges;
-        data[i].tree = &tree;
-        data[i].iocontext = &iocontext;
-
-        data[i].start = i*queries_per_thread;
-        data[i].end = data[i].start + queries_per_thread;
-
-        if(i == num_threads - 1) {
-            data[i].end = ranges.size();
-        }
 
-        pthread_create(&threads[i], NULL, parallelSingleRange, (void*) &data[i]);
-    }
+    std::stable_sort(order.begin(), order.end(), [&ranges](dav_size_t a, dav_size_t b) {
+        return (ranges[a].second - ranges[a].first) > (ranges[b].second - ranges[b].first);
+    });
 
-    for(uint i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], NULL);
-        size += data[i].size;
+    uint num_workers = std::max<uint>(1, nconnections);
+    if(num_workers > ranges.size()) {
+        num_workers = ranges.size();
     }
 
-    for(uint i = 0; i < num_threads; i++) {
-        if(data[i].exc != std::exception_ptr()) {
-            std::rethrow_exception(data[i].exc);
-        }
+    std::atomic<dav_ssize_t> size(0);
+    TaskGroup group(ContextExplorer::ExecutorFromContext(iocontext._context), num_workers - 1);
+
+    for(dav_size_t i = 0; i < order.size(); i++) {
+        const SortedRanges::value_type & range = ranges[order[i]];
+        group.add([this, &iocontext, &index, &range, &size]() {
+            size += singleRangeRequest(iocontext, index, range.first, range.second - range.first + 1);
+        });
     }
 
+    group.wait();
     return size;
 }
 
@@ -345,12 +273,11 @@ dav_ssize_t HttpIOVecOps::preadVec(IOChainContext & iocontext, const DavIOVecInp
     if(count_vec ==0)
         return 0;
 
-    for(dav_size_t i = 0; i < count_vec; i++) {
-      output_vec[i].diov_size = 0;
-    }
+    HostCapabilityCache & capabilities = ContextExplorer::HostCapabilitiesFromContext(iocontext._context);
+    MultirangeCapabilities caps = capabilities.getMultirange(iocontext._uri);
 
     // size of merge window
-    dav_size_t mergewindow = 2000;
+    dav_size_t mergewindow = caps.mergeWindow;
     if(iocontext._uri.fragmentParamExists("mergewindow")) {
         mergewindow = atoi(iocontext._uri.getFragmentParam("mergewindow").c_str());
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Setting mergewindow to {}", mergewindow);
@@ -363,23 +290,62 @@ dav_ssize_t HttpIOVecOps::preadVec(IOChainContext & iocontext, const DavIOVecInp
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Setting number of desired parallel connections to {}", nconnections);
     }
 
-    IntervalTree<ElemChunk> tree = buildIntervalTree(input_vec, output_vec, count_vec);
+    RangeIndex index(input_vec, output_vec, count_vec);
+    if(index.size() == 0)
+        return 0;
+
+    SortedRanges sorted = index.merge(mergewindow);
 
     // a lot of servers do not support multirange... should we even try?
-    if(count_vec == 1 || iocontext._uri.getFragmentParam("multirange") == "false") {
-        SortedRanges sorted = partialMerging(tree, mergewindow);
-        return simulateMultirange(iocontext, tree, sorted, nconnections);
+    const std::string multirange = iocontext._uri.getFragmentParam("multirange");
+    if(count_vec == 1 || multirange == "false") {
+        return simulateMultirange(iocontext, index, sorted, nconnections);
     }
 
-    SortedRanges sorted = partialMerging(tree, mergewindow);
-    MultirangeResult res = performMultirange(iocontext, tree, sorted);
-    if(res.res == MultirangeResult::SUCCESS || res.res == MultirangeResult::SUCCESS_BUT_NO_MULTIRANGE) {
-        return res.size_bytes;
+    if(caps.multirange == MultirangeCapabilities::Unsupported && multirange != "true") {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Server is known not to support multi-range requests, using single-range requests");
+        return simulateMultirange(iocontext, index, sorted, nconnections);
     }
-    else {
+
+    dav_size_t maxHeaderSize = caps.maxHeaderSize;
+    bool unconfirmed = false;
+    while(true) {
+        MultirangeResult res = performMultirange(iocontext, index, sorted, maxHeaderSize);
+
+        // a single merged range tells nothing about multi-range support
+        if(sorted.size() > 1 && res.res != MultirangeResult::HEADER_REJECTED) {
+            capabilities.setMultirangeSupport(iocontext._uri, res.res == MultirangeResult::SUCCESS);
+        }
+
+        if(res.res == MultirangeResult::SUCCESS || res.res == MultirangeResult::SUCCESS_BUT_NO_MULTIRANGE) {
+            // the 400 was about the header size after all
+            if(unconfirmed) {
+                capabilities.setMaxHeaderSize(iocontext._uri, maxHeaderSize);
+            }
+            return res.size_bytes;
+        }
+
+        // start over, some buffers might have been partially filled
+        index.reset();
+
+        if(res.res == MultirangeResult::HEADER_REJECTED && res.rejected_code == 400) {
+            // maybe unrelated to the header: a single retry with the smallest
+            // one, remembered only if it works. A second 400 is an error.
+            maxHeaderSize = HostCapabilityCache::kMinHeaderSize;
+            unconfirmed = true;
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrying multi-range request with a Range header of at most {} bytes", maxHeaderSize);
+            continue;
+        }
+
+        if(res.res == MultirangeResult::HEADER_REJECTED) {
+            maxHeaderSize = std::max(HostCapabilityCache::kMinHeaderSize, std::min(maxHeaderSize, res.rejected_header) / 2);
+            capabilities.setMaxHeaderSize(iocontext._uri, maxHeaderSize);
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrying multi-range request with a Range header of at most {} bytes", maxHeaderSize);
+            continue;
+        }
+
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Multi-range request has failed, attempting to recover by using multiple single-range requests");
-        sorted = partialMerging(tree, mergewindow);
-        return simulateMultirange(iocontext, tree, sorted, nconnections);
+        return simulateMultirange(iocontext, index, sorted, nconnections);
     }
 }
 
@@ -512,39 +478,14 @@ int  parse_multi_part_header(HttpRequest& req, const std::string & boundary, Chu
     return -1;
 }
 
-// copy from source to chunk
-static void copyBytes(const char *source, dav_off_t offset, dav_size_t size, ElemChunk &chunk) {
-    dav_off_t chunkOffset = chunk._in->diov_offset;
-    dav_size_t chunkSize = chunk._in->diov_size;
-
-    // first byte from which we'll start copying
-    dav_off_t common_offset = std::max(offset, chunkOffset);
-
-    // the length for which the two segments intersect
-    dav_size_t intersect_dist = std::min(size - (common_offset-offset), chunkSize - (common_offset-chunkOffset));
-
-    memcpy( (char*) chunk._in->diov_buffer+(common_offset-chunkOffset),
-            source+(common_offset-offset), intersect_dist);
-
-    chunk._ou->diov_buffer = chunk._in->diov_buffer;
-    chunk._ou->diov_size += intersect_dist;
-}
-
-// find all matching chunks in tree and fill them
-static void fillChunks(const char *source, const IntervalTree<ElemChunk> &tree, dav_off_t offset, dav_size_t size) {
-    std::vector<Interval<ElemChunk> > matches;
-    tree.findOverlapping(offset, offset+size-1, matches);
-
-    for(std::vector<Interval<ElemChunk> >::iterator it = matches.begin(); it != matches.end(); it++) {
-        copyBytes(source, offset, size, it->value);
-    }
-
-    if(matches.size() == 0) {
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "WARNING: Received byte-range from server does not match any in the interval tree");
+// fill all matching chunks, warn about unexpected bytes
+static void fillChunks(const char *source, RangeIndex::Cursor & cursor, dav_off_t offset, dav_size_t size) {
+    if(cursor.fill(source, offset, size) == 0) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "WARNING: Received byte-range from server does not match any requested range");
     }
 }
 
-dav_ssize_t copyChunk(HttpRequest & req, const IntervalTree<ElemChunk> &tree, dav_off_t offset, dav_size_t size,
+dav_ssize_t copyChunk(HttpRequest & req, RangeIndex::Cursor & cursor, dav_off_t offset, dav_size_t size,
                       DavixError** err){
     DavixError* tmp_err=NULL;
     dav_ssize_t ret;
@@ -558,25 +499,26 @@ dav_ssize_t copyChunk(HttpRequest & req, const IntervalTree<ElemChunk> &tree, da
         DavixError::propagateError(err, tmp_err);
     }
     else {
-        fillChunks(&buffer[0], tree, offset, size);
+        fillChunks(&buffer[0], cursor, offset, size);
     }
 
     return ret;
 }
 
 dav_ssize_t HttpIOVecOps::singleRangeRequest(IOChainContext & iocontext,
-                                             const IntervalTree<ElemChunk> & tree,
+                                             const RangeIndex & index,
                                              dav_off_t offset, dav_size_t size) {
     std::vector<char> buffer;
     buffer.resize(size+1);
 
     dav_ssize_t s = _start->pread(iocontext, &buffer[0], size, offset);
-    fillChunks(&buffer[0], tree, offset, s);
+    RangeIndex::Cursor cursor(index);
+    fillChunks(&buffer[0], cursor, offset, s);
     return s;
 }
 
 dav_ssize_t HttpIOVecOps::parseMultipartRequest(HttpRequest & _req,
-                                                const IntervalTree<ElemChunk> & tree,
+                                                const RangeIndex & index,
                                                 DavixError** err) {
     std::string boundary;
     dav_ssize_t ret = 0, tmp_ret =0;
@@ -588,6 +530,8 @@ dav_ssize_t HttpIOVecOps::parseMultipartRequest(HttpRequest & _req,
     }
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest multi-part boundary {}", boundary);
 
+    RangeIndex::Cursor cursor(index);
+
     while(1) {
        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest parsing a new chunk");
        ChunkInfo infos;
@@ -597,7 +541,7 @@ dav_ssize_t HttpIOVecOps::parseMultipartRequest(HttpRequest & _req,
        if(tmp_ret == -2) break; // terminating boundary
        if(tmp_ret == -1) return -1; // error
 
-       if( (tmp_ret = copyChunk(_req, tree, infos.offset, infos.size, err)) <0 )
+       if( (tmp_ret = copyChunk(_req, cursor, infos.offset, infos.size, err)) <0 )
            return -1;
 
        ret += tmp_ret;
@@ -611,12 +555,13 @@ dav_ssize_t HttpIOVecOps::parseMultipartRequest(HttpRequest & _req,
     return ret;
 }
 
-dav_ssize_t HttpIOVecOps::simulateMultiPartRequest(HttpRequest & _req, const IntervalTree<ElemChunk> & tree, DavixError** err) {
+dav_ssize_t HttpIOVecOps::simulateMultiPartRequest(HttpRequest & _req, const RangeIndex & index, DavixError** err) {
     DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CHAIN, " -> Davix vec : 200 full file, simulate vec io");
     char buffer[DAVIX_READ_BLOCK_SIZE+1];
     dav_ssize_t partial_read_size = 0, total_read_size = 0;
+    RangeIndex::Cursor cursor(index);
     while( (partial_read_size = _req.readBlock(buffer, DAVIX_READ_BLOCK_SIZE, err)) >0) {
-        fillChunks(buffer, tree, total_read_size, partial_read_size);
+        fillChunks(buffer, cursor, total_read_size, partial_read_size);
         total_read_size += partial_read_size;
     }
 
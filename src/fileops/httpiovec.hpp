@@ -25,7 +25,7 @@
 #include <davix.hpp>
 #include <fileops/iobuffmap.hpp>
 #include <fileops/httpiochain.hpp>
-#include "libs/IntervalTree.h"
+#include <fileops/RangeIndex.hpp>
 
 namespace Davix{
 
@@ -40,31 +40,19 @@ struct ChunkInfo {
     bool bounded;
 };
 
-struct ElemChunk{
-    ElemChunk(const DavIOVecInput* in, DavIOVecOuput* ou) :
-        _in(in),
-        _ou(ou),
-        _cursor((char*) in->diov_buffer){
-        _ou->diov_size=0; // reset elem read status
-        _ou->diov_buffer = _in->diov_buffer;
-    }
-
-    const DavIOVecInput *_in;
-    DavIOVecOuput * _ou;
-    char *_cursor;
-
-};
-
-typedef std::multimap<dav_off_t, ElemChunk> MapChunk;
-typedef std::vector<std::pair<dav_off_t, dav_size_t> > SortedRanges;
 
 struct MultirangeResult {
-    enum OperationResult { SUCCESS, NOMULTIRANGE, SUCCESS_BUT_NO_MULTIRANGE };
+    enum OperationResult { SUCCESS, NOMULTIRANGE, SUCCESS_BUT_NO_MULTIRANGE, HEADER_REJECTED };
     OperationResult res;
     dav_ssize_t size_bytes;
 
-    MultirangeResult(OperationResult _res, dav_ssize_t _size_bytes)
-        : res(_res), size_bytes(_size_bytes) {}
+    // size of the Range header refused by the server, and the status code
+    // it came with, for HEADER_REJECTED
+    dav_size_t rejected_header;
+    int rejected_code;
+
+    MultirangeResult(OperationResult _res, dav_ssize_t _size_bytes, dav_size_t _rejected_header = 0, int _rejected_code = 0)
+        : res(_res), size_bytes(_size_bytes), rejected_header(_rejected_header), rejected_code(_rejected_code) {}
 };
 
 ////
@@ -81,33 +69,32 @@ public:
                               DavIOVecOuput * output_vec,
                               const dav_size_t count_vec);
 
-    // these two should have been private, but because of pthread we need to call them from
-    // a function
+private:
     dav_ssize_t singleRangeRequest(IOChainContext & iocontext,
                                    const DavIOVecInput * input,
                                    DavIOVecOuput * output);
 
     dav_ssize_t singleRangeRequest(IOChainContext & iocontext,
-                                   const IntervalTree<ElemChunk> & tree,
+                                   const RangeIndex & index,
                                    dav_off_t offset, dav_size_t size);
 
-private:
 
     MultirangeResult performMultirange(IOChainContext & iocontext,
-                                       const IntervalTree<ElemChunk> &tree,
-                                       const SortedRanges & ranges);
+                                       const RangeIndex & index,
+                                       const SortedRanges & ranges,
+                                       dav_size_t maxHeaderSize);
 
     dav_ssize_t simulateMultirange(IOChainContext & iocontext,
-                                   const IntervalTree<ElemChunk> & tree,
+                                   const RangeIndex & index,
                                    const SortedRanges & ranges,
                                    uint nconnections);
 
     dav_ssize_t parseMultipartRequest(HttpRequest & req,
-                                      const IntervalTree<ElemChunk> & tree,
+                                      const RangeIndex & index,
                                       DavixError** tmp_err);
 
     dav_ssize_t simulateMultiPartRequest(HttpRequest & _req,
-                                         const IntervalTree<ElemChunk> & tree,
+                                         const RangeIndex & index,
                                          DavixError** err);
 };
 
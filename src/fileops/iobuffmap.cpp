@@ -28,7 +28,11 @@
 #include <utils/davix_logger_internal.hpp>
 #include <fileops/httpiovec.hpp>
 #include <fileops/davmeta.hpp>
+#include <fileops/ReadAhead.hpp>
 #include <system_utils/env_utils.hpp>
+#include <core/Executor.hpp>
+#include <core/TaskGroup.hpp>
+#include <davix_context_internal.hpp>
 
 
 #include <sstream>
@@ -40,6 +44,10 @@
 #include <cmath>
 
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+
 
 
 
@@ -146,6 +154,24 @@ dav_ssize_t HttpIO::readFull(IOChainContext & iocontext, std::vector<char> & buf
 
     DAVIX_SCOPE_TRACE(DAVIX_LOG_CHAIN, fun_readFull);
 
+    const dav_size_t segmented_size = getSegmentedDownloadSize(iocontext);
+    if(segmented_size > 0) {
+        const size_t base = buffer.size();
+        buffer.resize(base + segmented_size);
+
+        try {
+            segmentedDownload(iocontext, segmented_size, [&buffer, base](dav_off_t offset, const char* buff, dav_size_t size) {
+                memcpy(buffer.data() + base + offset, buff, size);
+            });
+        }
+        catch(...) {
+            // don't leave zeroes and partial data behind
+            buffer.resize(base);
+            throw;
+        }
+        return segmented_size;
+    }
+
     GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
     if(!tmp_err){
         RequestParams params(iocontext._reqparams);
@@ -236,6 +262,42 @@ dav_ssize_t HttpIO::readToFd(IOChainContext & iocontext, int fd, dav_size_t read
 
     DAVIX_SCOPE_TRACE(DAVIX_LOG_CHAIN, fun_readToFd);
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "request size {}", read_size);
+
+    // segments are written at their offset, which needs a seekable fd
+    struct stat st;
+    const off_t base = ::lseek(fd, 0, SEEK_CUR);
+    if(iocontext.fdHandler.bytes_written_to_fd == 0 && base >= 0 &&
+       fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+
+        dav_size_t segmented_size = getSegmentedDownloadSize(iocontext);
+        if(read_size > 0) {
+            segmented_size = std::min(segmented_size, read_size);
+        }
+
+        if(segmented_size > 0) {
+            segmentedDownload(iocontext, segmented_size, [fd, base](dav_off_t offset, const char* buff, dav_size_t size) {
+                while(size > 0) {
+                    ssize_t written = ::pwrite(fd, buff, size, base + offset);
+                    if(written < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if(written < 0) {
+                        throw DavixException(davix_scope_io_buff(), StatusCode::SystemError,
+                                             fmt::format("Impossible to write to fd: {}", strerror(errno)));
+                    }
+
+                    buff += written;
+                    offset += written;
+                    size -= written;
+                }
+            });
+
+            // leave the fd where a sequential download would have left it
+            ::lseek(fd, base + segmented_size, SEEK_SET);
+            iocontext.fdHandler.bytes_written_to_fd += segmented_size;
+            return segmented_size;
+        }
+    }
     GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
     if(!tmp_err){
         RequestParams params(iocontext._reqparams);
@@ -265,6 +327,99 @@ dav_ssize_t HttpIO::readToFd(IOChainContext & iocontext, int fd, dav_size_t read
     return ret;
 }
 
+dav_size_t HttpIO::getSegmentedDownloadSize(IOChainContext & iocontext) {
+    const unsigned int nstreams = iocontext._reqparams->getSegmentedDownloadStreams();
+    const dav_size_t segment_size = std::max<dav_size_t>(1, iocontext._reqparams->getSegmentedDownloadSegmentSize());
+    if(nstreams <= 1) {
+        return 0;
+    }
+
+    DavixError * tmp_err=NULL;
+    HeadRequest req(iocontext._context, iocontext._uri, &tmp_err);
+    if(!tmp_err) {
+        req.setParameters(iocontext._reqparams);
+        req.executeRequest(&tmp_err);
+    }
+
+    // any failure here is reported by the single-stream download
+    if(tmp_err || req.getRequestCode() != 200) {
+        DavixError::clearError(&tmp_err);
+        return 0;
+    }
+
+    std::string accept_ranges;
+    const dav_ssize_t size = req.getAnswerSize();
+    if(!req.getAnswerHeader("Accept-Ranges", accept_ranges) || accept_ranges.find("bytes") == std::string::npos) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "No byte-range support announced for {}, using a single stream", iocontext._uri);
+        return 0;
+    }
+
+    if(size <= 0 || (dav_size_t) size <= 2 * segment_size) {
+        return 0;
+    }
+
+    return size;
+}
+
+static void downloadSegment(IOChainContext & iocontext, dav_off_t offset, dav_size_t size, const std::function<void (dav_off_t, const char*, dav_size_t)> & sink) {
+    DavixError * tmp_err=NULL;
+    GetRequest req(iocontext._context, iocontext._uri, &tmp_err);
+    checkDavixError(&tmp_err);
+
+    req.setParameters(iocontext._reqparams);
+    req.addHeaderField("Range", SSTR("bytes=" << offset << "-" << (offset + size - 1)));
+
+    req.beginRequest(&tmp_err);
+    if(!tmp_err && req.getRequestCode() != 206) {
+        if(httpcodeIsValid(req.getRequestCode())) {
+            DavixError::setupError(&tmp_err, davix_scope_io_buff(), StatusCode::InvalidServerResponse,
+                                   fmt::format("Expected a partial content answer for segment at offset {}, got {}", offset, req.getRequestCode()));
+        }
+        else {
+            httpcodeToDavixError(req.getRequestCode(), davix_scope_io_buff(), "read error: ", &tmp_err);
+        }
+    }
+    checkDavixError(&tmp_err);
+
+    std::vector<char> buffer(std::min<dav_size_t>(size, DAVIX_MAX_BLOCK_SIZE / 4));
+    dav_size_t total = 0;
+    dav_ssize_t ret;
+    while(total < size && (ret = req.readBlock(buffer.data(), std::min<dav_size_t>(buffer.size(), size - total), &tmp_err)) > 0) {
+        sink(offset + total, buffer.data(), ret);
+        total += ret;
+    }
+    checkDavixError(&tmp_err);
+
+    if(total != size) {
+        throw DavixException(davix_scope_io_buff(), StatusCode::InvalidServerResponse,
+                             fmt::format("Segment at offset {} truncated: got {} bytes out of {}", offset, total, size));
+    }
+
+    req.endRequest(&tmp_err);
+    checkDavixError(&tmp_err);
+}
+
+void HttpIO::segmentedDownload(IOChainContext & iocontext, dav_size_t size, const SegmentSink & sink) {
+    const dav_size_t segment_size = std::max<dav_size_t>(1, iocontext._reqparams->getSegmentedDownloadSegmentSize());
+    const dav_size_t nsegments = (size + segment_size - 1) / segment_size;
+    const dav_size_t nworkers = std::min<dav_size_t>(nsegments, iocontext._reqparams->getSegmentedDownloadStreams());
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Downloading {} bytes from {} as {} segments over {} streams",
+               size, iocontext._uri, nsegments, nworkers);
+
+    // the first failure drops the segments not started yet
+    TaskGroup group(ContextExplorer::ExecutorFromContext(iocontext._context), std::max<dav_size_t>(1, nworkers) - 1);
+    for(dav_size_t i = 0; i < nsegments; i++) {
+        const dav_off_t offset = i * segment_size;
+        const dav_size_t length = std::min<dav_size_t>(segment_size, size - offset);
+        group.add([&iocontext, &sink, offset, length]() {
+            downloadSegment(iocontext, offset, length, sink);
+        });
+    }
+
+    group.wait();
+}
+
 dav_ssize_t HttpIO::writeFromProvider(IOChainContext & iocontext, ContentProvider &provider) {
     DavixError * tmp_err=NULL;
 
@@ -314,7 +469,9 @@ HttpIOBuffer::HttpIOBuffer() :
     _rwlock(),
     _read_pos(0),
     _read_endfile(false),
-    _read_req(NULL)
+    _read_req(NULL),
+    _read_ahead(),
+    _read_ahead_failed(false)
 {
 
 }
@@ -393,10 +550,12 @@ dav_ssize_t HttpIOBuffer::read(IOChainContext & iocontext, void *buf, dav_size_t
 
     if(_pos ==0) // reset read ahead offset to default if try to read a full file
         resetIO(iocontext);
-    if(_pos == _read_pos && isAdviseFullRead()){
+    // blocks may be cached already, streaming would fetch them again
+    if(_pos == _read_pos && isAdviseFullRead() && !isCachingReads(iocontext)){
         // try read ahead strategie
         ret = readInternal(iocontext, buf, count);
     }else{ // fallback on partial read
+        _read_ahead.reset();
         ret = _start->pread(iocontext, buf, count, _pos);
     }
     if(ret > 0)
@@ -415,6 +574,13 @@ dav_ssize_t HttpIOBuffer::readInternal(IOChainContext & iocontext, void *buffer,
     if(_read_endfile)
         return 0;
 
+    if(_read_req == NULL && _read_ahead.get() == NULL && !_read_ahead_failed)
+        startReadAhead(iocontext);
+
+    // a new GET can only stream from the beginning of the file
+    if(_read_ahead.get() != NULL || (_read_req == NULL && _read_pos != 0))
+        return readAhead(iocontext, buffer, size_read);
+
     if( _read_req == NULL
             && (_read_req = new HttpRequest(iocontext._context, iocontext._uri, &tmp_err)) != NULL
             && tmp_err == NULL ){
@@ -457,11 +623,73 @@ dav_ssize_t HttpIOBuffer::readInternal(IOChainContext & iocontext, void *buffer,
 
 
 
+void HttpIOBuffer::startReadAhead(IOChainContext & iocontext){
+    const unsigned int inflight = iocontext._reqparams->getReadAheadMaxInFlight();
+    const dav_size_t block_size = std::max<dav_size_t>(1, iocontext._reqparams->getReadAheadBlockSize());
+
+    // unknown size or a single block left: one request does as well
+    if(inflight == 0 || (dav_off_t) _file_size <= _read_pos + (dav_off_t) block_size)
+        return;
+
+    // the window may outlive iocontext, which can be a temporary one
+    // created for a metalink replica: fetches work on their own copies
+    Context & context = iocontext._context;
+    std::shared_ptr<Uri> uri(new Uri(iocontext._uri));
+    std::shared_ptr<RequestParams> params(new RequestParams(iocontext._reqparams));
+
+    Executor & executor = ContextExplorer::ExecutorFromContext(context);
+    ReadAheadWindow::Fetcher fetcher = [&context, uri, params](dav_off_t offset, dav_size_t size, char* buffer) {
+        IOChainContext fetchcontext(context, *uri, params.get());
+        downloadSegment(fetchcontext, offset, size, [buffer, offset](dav_off_t off, const char* buff, dav_size_t len) {
+            memcpy(buffer + (off - offset), buff, len);
+        });
+    };
+
+    _read_ahead.reset(new ReadAheadWindow(executor, fetcher, _read_pos, _file_size, block_size, inflight));
+}
+
+
+dav_ssize_t HttpIOBuffer::readAhead(IOChainContext & iocontext, void *buffer, dav_size_t size_read){
+    dav_ssize_t ret = -1;
+
+    if(_read_ahead.get() != NULL){
+        ret = _read_ahead->read(_read_pos, (char*) buffer, size_read);
+        if(ret < 0){
+            // let the chain deal with retries and errors from now on
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead failed for {}, falling back to plain requests", iocontext._uri);
+            _read_ahead.reset();
+            _read_ahead_failed = true;
+
+            // maybe no byte-range support at all: stream the whole file
+            if(_read_pos == 0)
+                return readInternal(iocontext, buffer, size_read);
+        }
+    }
+
+    if(ret < 0)
+        ret = _start->pread(iocontext, buffer, size_read, _read_pos);
+
+    if(ret >= 0){
+        _read_pos += ret;
+        if(ret < (dav_ssize_t) size_read){ // end of file
+            _read_endfile = true;
+            _read_ahead.reset();
+        }
+    }
+    return ret;
+}
+
+
 void HttpIOBuffer::prefetchInfo(IOChainContext & iocontext, off_t offset, dav_size_t size_read, advise_t adv){
     (void) iocontext;
     (void) offset;
     (void) size_read;
+    std::lock_guard<std::recursive_mutex> l(_rwlock);
     _last_advise = adv;
+
+    // random reads bypass the window, don't keep it busy
+    if(!isAdviseFullRead())
+        _read_ahead.reset();
 }
 
 
@@ -472,7 +700,10 @@ void HttpIOBuffer::resetIO(IOChainContext & iocontext){
         delete _read_req;
         _read_req = NULL;
     }
+    _read_ahead.reset();
+    _read_ahead_failed = false;
     _read_pos =0;
+    _read_endfile = false;
     commitLocal(iocontext);
 }
 
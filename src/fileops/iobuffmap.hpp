@@ -27,6 +27,8 @@
 #include <fileops/fileutils.hpp>
 #include <fileops/httpiochain.hpp>
 
+#include <functional>
+
 
 
 namespace Davix {
@@ -60,6 +62,15 @@ public:
 
 private:
 
+    // consumer of downloaded data, called concurrently for disjoint ranges
+    typedef std::function<void (dav_off_t offset, const char* buff, dav_size_t size)> SegmentSink;
+
+    // size of the object if it should be downloaded in segments, 0 otherwise
+    dav_size_t getSegmentedDownloadSize(IOChainContext & iocontext);
+
+    // download the first size bytes of the object as concurrent byte-range segments
+    void segmentedDownload(IOChainContext & iocontext, dav_size_t size, const SegmentSink & sink);
+
 
     HttpIO(const HttpIO & );
     HttpIO & operator=(const HttpIO & );
@@ -69,6 +80,7 @@ private:
 
 
 struct IOBufferLocalFile;
+class ReadAheadWindow;
 
 ///
 /// RW operation with buffering support and POSIX like interface
@@ -117,6 +129,10 @@ protected:
     bool _read_endfile;
     HttpRequest * _read_req;
 
+    // range requests in flight ahead of _read_pos, if enabled
+    std::unique_ptr<ReadAheadWindow> _read_ahead;
+    bool _read_ahead_failed;
+
 private:
 
     inline bool isAdviseFullRead(){
@@ -125,6 +141,11 @@ private:
 
     dav_ssize_t readInternal(IOChainContext & iocontext, void *buffer, dav_size_t size_read);
 
+    // start a read-ahead window at _read_pos, if worth it
+    void startReadAhead(IOChainContext & iocontext);
+
+    dav_ssize_t readAhead(IOChainContext & iocontext, void *buffer, dav_size_t size_read);
+
     HttpIOBuffer(const HttpIOBuffer & );
     HttpIOBuffer & operator=(const HttpIOBuffer & );
 };
@@ -20,6 +20,7 @@
 
 // containers
 #include "containers/cache.hpp"
+#include "containers/lru_cache.hpp"
 
 // chrono
 #include "chrono/timepoint.hpp"
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace Davix {
+
+///
+/// Counters of a LRUCache, since its creation
+///
+struct LRUCacheStats {
+    LRUCacheStats() : hits(0), misses(0), evictions(0), expirations(0) {}
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;   // dropped to make room for a new entry
+    uint64_t expirations; // dropped when found past their expiry
+};
+
+///
+/// Thread safe cache container with a bounded capacity: once full, the
+/// least recently used entry makes room for the new one. Entries may also
+/// expire, after a time-to-live given per cache or per entry.
+///
+/// Keys are spread over independently locked shards, so that concurrent
+/// users of different keys seldom wait for each other. The LRU order is
+/// kept per shard.
+///
+template <class Key, class Value, class Hash = std::hash<Key> >
+class LRUCache {
+public:
+    typedef std::shared_ptr<Value> shrPtr_type;
+    typedef std::chrono::steady_clock Clock;
+
+    ///
+    /// \brief constructor
+    /// \param capacity maximum number of entries
+    /// \param ttl default time-to-live of an entry, zero for none
+    /// \param shards number of independently locked parts
+    ///
+    LRUCache(size_t capacity, Clock::duration ttl = Clock::duration::zero(), size_t shards = 16) :
+        _ttl(ttl), _hits(0), _misses(0), _evictions(0), _expirations(0) {
+        capacity = std::max<size_t>(1, capacity);
+        const size_t count = std::max<size_t>(1, std::min(shards, capacity));
+
+        _shards.reserve(count);
+        for(size_t i = 0; i < count; i++) {
+            _shards.push_back(std::unique_ptr<Shard>(new Shard((capacity + count - 1) / count)));
+        }
+    }
+
+    ~LRUCache(){}
+
+    LRUCache(const LRUCache &) = delete;
+    LRUCache& operator=(const LRUCache &) = delete;
+
+    ///
+    /// \brief insert a value with the default time-to-live, replacing the one mapped to the same key
+    /// \return the value
+    ///
+    shrPtr_type insert(const Key & key, const shrPtr_type & value){
+        return insert(key, value, _ttl);
+    }
+
+    ///
+    /// \brief insert a value which expires after ttl, never for a zero ttl
+    /// \return the value
+    ///
+    shrPtr_type insert(const Key & key, const shrPtr_type & value, Clock::duration ttl){
+        const Clock::time_point expiry = (ttl == Clock::duration::zero()) ? Clock::time_point::max() : Clock::now() + ttl;
+        Shard &shard = shardOf(key);
+        std::lock_guard<std::mutex> l(shard.mtx);
+
+        typename Index::iterator it = shard.index.find(key);
+        if(it != shard.index.end()){
+            it->second->value = value;
+            it->second->expiry = expiry;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return value;
+        }
+
+        if(shard.index.size() >= shard.capacity){
+            Node &oldest = shard.lru.back();
+            if(oldest.expiry <= Clock::now()){
+                _expirations++;
+            }
+            else{
+                _evictions++;
+            }
+            shard.index.erase(oldest.key);
+            shard.lru.pop_back();
+        }
+
+        shard.lru.push_front(Node(key, value, expiry));
+        shard.index.insert(std::make_pair(key, shard.lru.begin()));
+        return value;
+    }
+
+    ///
+    /// \brief find a cached value, and mark it as recently used
+    /// \return the value, a NULL shared pointer if not found or expired
+    ///
+    shrPtr_type find(const Key & key){
+        Shard &shard = shardOf(key);
+        std::lock_guard<std::mutex> l(shard.mtx);
+
+        typename Index::iterator it = shard.index.find(key);
+        if(it == shard.index.end()){
+            _misses++;
+            return shrPtr_type();
+        }
+
+        if(it->second->expiry <= Clock::now()){
+            _expirations++;
+            _misses++;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+            return shrPtr_type();
+        }
+
+        _hits++;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->value;
+    }
+
+    ///
+    /// \brief remove an object from this cache and return it, expired or not
+    ///
+    shrPtr_type take(const Key & key){
+        Shard &shard = shardOf(key);
+        std::lock_guard<std::mutex> l(shard.mtx);
+
+        typename Index::iterator it = shard.index.find(key);
+        if(it == shard.index.end()){
+            return shrPtr_type();
+        }
+
+        shrPtr_type ret = it->second->value;
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+        return ret;
+    }
+
+    ///
+    /// \brief erase an object from the cache
+    /// \return true if it was there
+    ///
+    bool erase(const Key & key){
+        return take(key).get() != NULL;
+    }
+
+    ///
+    /// \brief keys of the entries for which pred holds, expired ones included
+    ///
+    template <class Predicate>
+    std::vector<Key> findKeys(Predicate pred) const{
+        std::vector<Key> keys;
+        for(size_t i = 0; i < _shards.size(); i++){
+            std::lock_guard<std::mutex> l(_shards[i]->mtx);
+            for(typename std::list<Node>::const_iterator it = _shards[i]->lru.begin(); it != _shards[i]->lru.end(); ++it){
+                if(pred(it->key)){
+                    keys.push_back(it->key);
+                }
+            }
+        }
+        return keys;
+    }
+
+    ///
+    /// \brief getSize return the number of objects stored in the cache, expired ones included
+    ///
+    size_t getSize() const{
+        size_t size = 0;
+        for(size_t i = 0; i < _shards.size(); i++){
+            std::lock_guard<std::mutex> l(_shards[i]->mtx);
+            size += _shards[i]->index.size();
+        }
+        return size;
+    }
+
+    ///
+    /// \brief maximum number of objects in the cache
+    ///
+    size_t getCapacity() const{
+        return _shards.size() * _shards[0]->capacity;
+    }
+
+    LRUCacheStats getStats() const{
+        LRUCacheStats stats;
+        stats.hits = _hits;
+        stats.misses = _misses;
+        stats.evictions = _evictions;
+        stats.expirations = _expirations;
+        return stats;
+    }
+
+    void clear(){
+        for(size_t i = 0; i < _shards.size(); i++){
+            std::lock_guard<std::mutex> l(_shards[i]->mtx);
+            _shards[i]->index.clear();
+            _shards[i]->lru.clear();
+        }
+    }
+
+private:
+    struct Node {
+        Node(const Key & k, const shrPtr_type & v, Clock::time_point e) : key(k), value(v), expiry(e) {}
+
+        Key key;
+        shrPtr_type value;
+        Clock::time_point expiry;
+    };
+
+    typedef std::unordered_map<Key, typename std::list<Node>::iterator, Hash> Index;
+
+    struct Shard {
+        Shard(size_t c) : capacity(c) {}
+
+        mutable std::mutex mtx;
+        std::list<Node> lru; // most recently used first
+        Index index;
+        const size_t capacity;
+    };
+
+    std::vector<std::unique_ptr<Shard> > _shards;
+    Clock::duration _ttl;
+    Hash _hash;
+
+    std::atomic<uint64_t> _hits;
+    std::atomic<uint64_t> _misses;
+    std::atomic<uint64_t> _evictions;
+    std::atomic<uint64_t> _expirations;
+
+    Shard & shardOf(const Key & key){
+        return *_shards[_hash(key) % _shards.size()];
+    }
+};
+
+}
@@ -62,7 +62,7 @@ std::string hmac_sha256(const std::string & key, const std::string & data){
 #endif
 }
 
-std::string sha256(const std::string input) {
+std::string sha256(const std::string & input) {
 #ifdef HAVE_OPENSSL
     unsigned char hash[SHA256_DIGEST_LENGTH];
     SHA256_CTX sha256;
@@ -75,39 +75,47 @@ std::string sha256(const std::string input) {
 #endif
 }
 
-std::string rsasha256(const std::string &key, const std::string &data) {
+RsaSha256Signer::RsaSha256Signer(const std::string &key) : _pkey(NULL), _rsa(NULL) {
 #ifdef HAVE_OPENSSL
-
     BIO* bio = BIO_new_mem_buf( (void*) key.data(), key.size());
-    if(!bio) return "";
+    if(!bio) return;
 
-    EVP_PKEY* private_key = PEM_read_bio_PrivateKey(bio, NULL, NULL, NULL);
-    if(!private_key) {
-        BIO_free(bio);
-        return "";
+    _pkey = PEM_read_bio_PrivateKey(bio, NULL, NULL, NULL);
+    if(_pkey) {
+        _rsa = EVP_PKEY_get1_RSA(_pkey);
     }
 
-    RSA *rsa = EVP_PKEY_get1_RSA(private_key);
-    if(!rsa) {
-      EVP_PKEY_free(private_key);
-      BIO_free(bio);
-      return "";
-    }
+    BIO_free(bio);
+#else
+#error "No support for sha256 calculation"
+#endif
+}
+
+RsaSha256Signer::~RsaSha256Signer() {
+#ifdef HAVE_OPENSSL
+    if(_rsa) RSA_free(_rsa);
+    if(_pkey) EVP_PKEY_free(_pkey);
+#endif
+}
+
+std::string RsaSha256Signer::sign(const std::string &data) const {
+#ifdef HAVE_OPENSSL
+    if(!_rsa) return "";
 
     std::string digest = sha256(data);
 
     unsigned int siglen;
     char retbuff[2048];
-    if(RSA_sign(NID_sha256, (const unsigned char*) digest.c_str(), digest.size(), (unsigned char*) retbuff, &siglen, rsa) != 1) {
+    if(RSA_sign(NID_sha256, (const unsigned char*) digest.c_str(), digest.size(), (unsigned char*) retbuff, &siglen, _rsa) != 1) {
         siglen = 0;
     }
 
-    RSA_free(rsa);
-    EVP_PKEY_free(private_key);
-    BIO_free(bio);
-
     return std::string(retbuff, siglen);
 #else
 #error "No support for sha256 calculation"
 #endif
 }
+
+std::string rsasha256(const std::string &key, const std::string &data) {
+    return RsaSha256Signer(key).sign(data);
+}
@@ -25,5 +25,26 @@
 
 std::string hmac_sha1(const std::string & key, const std::string & data);
 std::string hmac_sha256(const std::string & key, const std::string & data);
-std::string sha256(const std::string input);
+std::string sha256(const std::string & input);
 std::string rsasha256(const std::string &key, const std::string &data);
+
+struct evp_pkey_st;
+struct rsa_st;
+
+// RSA-SHA256 signatures with a PEM private key parsed only once, for
+// signing many messages with the same key
+class RsaSha256Signer {
+public:
+    RsaSha256Signer(const std::string &key);
+    ~RsaSha256Signer();
+
+    RsaSha256Signer(const RsaSha256Signer&) = delete;
+    RsaSha256Signer& operator=(const RsaSha256Signer&) = delete;
+
+    // empty if the key could not be parsed, or on signing failure
+    std::string sign(const std::string &data) const;
+
+private:
+    evp_pkey_st* _pkey;
+    rsa_st* _rsa;
+};
@@ -145,7 +145,8 @@ NEONSession::NEONSession(NEONSessionFactory &f, NeonHandlePtr sess, const Uri &
     _u(uri)
 {
         if(_sess)
-            configureSession(_sess, _u, p, &NEONSession::provide_login_passwd_fn, this, &NEONSession::authNeonCliCertMapper, this, reused);
+            configureSession(_sess, _u, p, &NEONSession::provide_login_passwd_fn, this, &NEONSession::authNeonCliCertMapper, this,
+                             _f.getTlsSessionCache(), reused);
 }
 
 NEONSession::~NEONSession(){
@@ -161,8 +162,21 @@ NEONSession::~NEONSession(){
 }
 
 
+// TLS sessions are only shared between sessions with the same certificate checks
+static std::string tlsSessionScope(const RequestParams &params){
+    if(params.getSSLCACheck() == false){
+        return "noverify";
+    }
+
+    std::string scope = "verify";
+    for(std::vector<std::string>::const_iterator it = params.listCertificateAuthorityPath().begin(); it < params.listCertificateAuthorityPath().end(); it++){
+        scope += ";" + *it;
+    }
+    return scope;
+}
+
 void configureSession(NeonHandlePtr &_sess, const Uri & _u, const RequestParams &params, ne_auth_creds lp_callback, void* lp_userdata,
-                      ne_ssl_provide_fn cred_callback,  void* cred_userdata, bool & reused){
+                      ne_ssl_provide_fn cred_callback,  void* cred_userdata, ne_ssl_session_cache* tls_sessions, bool & reused){
 
     void* state = ne_get_session_private(_sess->session, davix_neon_key);
     if(state != NULL){
@@ -212,6 +226,14 @@ void configureSession(NeonHandlePtr &_sess, const Uri & _u, const RequestParams
 
         ne_set_session_flag(_sess->session, NE_SESSFLAG_PERSIST, params.getKeepAlive());
 
+        // a resumed TLS session keeps the client certificate of the one which
+        // negotiated it, so sessions authenticating with one don't share theirs
+        if(params.getClientCertFunctionX509()){
+            ne_ssl_set_session_cache(_sess->session, NULL, NULL);
+        }else{
+            ne_ssl_set_session_cache(_sess->session, tls_sessions, tlsSessionScope(params).c_str());
+        }
+
         // setup sess key
         ne_set_session_private(_sess->session, davix_neon_key, params.getParmState());
     }
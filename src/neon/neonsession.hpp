@@ -81,7 +81,7 @@ private:
 
 
 void configureSession(NeonHandlePtr &_sess, const Uri & uri, const RequestParams &params, ne_auth_creds lp_callbac, void* lp_userdata,
-                      ne_ssl_provide_fn cred_callback,  void* cred_userdata, bool & reused);
+                      ne_ssl_provide_fn cred_callback,  void* cred_userdata, ne_ssl_session_cache* tls_sessions, bool & reused);
 
 
 }
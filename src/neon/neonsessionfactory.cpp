@@ -32,6 +32,58 @@
 
 namespace Davix {
 
+//------------------------------------------------------------------------------
+// Addresses given to a neon session, which must outlive it, and the
+// connection attempt in progress, reported to the address book once over.
+//------------------------------------------------------------------------------
+struct NeonAddresses {
+    NeonAddresses(AddressBook &b, const std::string &h, unsigned int p) : book(b), host(h), port(p) {}
+
+    ~NeonAddresses() {
+        attemptFailed();
+        for(size_t i = 0; i < list.size(); i++) {
+            ne_iaddr_free(list[i]);
+        }
+    }
+
+    // an attempt still in progress when a new one starts, or when the session
+    // goes away, did not connect
+    void attemptFailed() {
+        if(!connecting.empty()) {
+            book.reportFailure(host, port, connecting);
+            connecting.clear();
+        }
+    }
+
+    static void notify(void *userdata, ne_session_status status, const ne_session_status_info *info) {
+        NeonAddresses *self = static_cast<NeonAddresses*>(userdata);
+
+        if(status == ne_status_connecting) {
+            char buffer[64];
+            self->attemptFailed();
+            self->connecting = ne_iaddr_print(info->ci.address, buffer, sizeof(buffer));
+            self->since = std::chrono::steady_clock::now();
+        }
+        else if(status == ne_status_connected && !self->connecting.empty()) {
+            self->book.reportSuccess(self->host, self->port, self->connecting,
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - self->since));
+            self->connecting.clear();
+        }
+    }
+
+    AddressBook &book;
+    std::string host;
+    unsigned int port;
+    std::vector<ne_inet_addr*> list;
+
+    std::string connecting;
+    std::chrono::steady_clock::time_point since;
+};
+
+NeonHandle::NeonHandle() : session(NULL) {}
+
+NeonHandle::NeonHandle(const std::string &k, ne_session *s) : key(k), session(s) {}
+
 NeonHandle::~NeonHandle() {
     if(session) {
         ne_session_destroy(session);
@@ -52,13 +104,20 @@ static void init_neon(){
     ne_sock_init();
 }
 
-NEONSessionFactory::NEONSessionFactory() : _session_caching(!isSessionCachingDisabled()) {
+NEONSessionFactory::NEONSessionFactory() :
+    _session_pool(SessionPool<NeonHandlePtr>::getDefaultMaxIdlePerHost(), SessionPool<NeonHandlePtr>::getDefaultIdleTTL()),
+    _session_caching(!isSessionCachingDisabled()),
+    _addresses(AddressBook::isActiveByDefault(), AddressBook::getDefaultTTL()) {
     std::call_once(neon_once, &init_neon);
+    _tls_sessions = ne_ssl_session_cache_create();
     DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CORE, "HTTP/SSL Session caching {}", (_session_caching?"ENABLED":"DISABLED"));
 }
 
 NEONSessionFactory::~NEONSessionFactory(){
     _session_pool.clear();
+    if(_tls_sessions) {
+        ne_ssl_session_cache_destroy(_tls_sessions);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -114,7 +173,38 @@ NeonHandlePtr NEONSessionFactory::create_session(const RequestParams & params, c
     }
 
     //ne_ssl_trust_default_ca(se); not stable in neon on epel 5
-    return NeonHandlePtr(new NeonHandle(create_map_keys_from_URL(protocol, host, port), se));
+    NeonHandlePtr handle(new NeonHandle(create_map_keys_from_URL(protocol, host, port), se));
+
+    // addresses would replace the proxy
+    if(se != NULL && proxy == NULL){
+        configureAddresses(*handle, host, port);
+    }
+
+    return handle;
+}
+
+void NEONSessionFactory::configureAddresses(NeonHandle &handle, const std::string &host, unsigned int port){
+    const std::vector<std::string> addresses = _addresses.getAddresses(host, port);
+    if(addresses.empty()){
+        return;
+    }
+
+    std::unique_ptr<NeonAddresses> state(new NeonAddresses(_addresses, host, port));
+    for(std::vector<std::string>::const_iterator it = addresses.begin(); it != addresses.end(); ++it){
+        ne_inet_addr *ia = ne_iaddr_parse(it->c_str(), (it->find(':') != std::string::npos) ? ne_iaddr_ipv6 : ne_iaddr_ipv4);
+        if(ia != NULL){
+            state->list.push_back(ia);
+        }
+    }
+
+    if(state->list.empty()){
+        return;
+    }
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_HTTP, "connect to {} through {} first, out of {} addresses", host, addresses[0], addresses.size());
+    ne_set_addrlist(handle.session, const_cast<const ne_inet_addr**>(&state->list[0]), state->list.size());
+    ne_set_notifier(handle.session, &NeonAddresses::notify, state.get());
+    handle.addresses = std::move(state);
 }
 
 NeonHandlePtr NEONSessionFactory::create_recycled_session(const RequestParams & params, const std::string &protocol, const std::string &host, unsigned int port){
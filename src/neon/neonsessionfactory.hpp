@@ -26,19 +26,22 @@
 #include <mutex>
 #include <utils/davix_uri.hpp>
 #include <neon/neonrequest.hpp>
+#include <core/AddressBook.hpp>
 #include <core/SessionPool.hpp>
 
 namespace Davix {
 
 class HttpRequest;
+struct NeonAddresses;
 
 struct NeonHandle {
-    NeonHandle() : session(NULL) {}
-    NeonHandle(const std::string &k, ne_session *s) : key(k), session(s) {}
+    NeonHandle();
+    NeonHandle(const std::string &k, ne_session *s);
     ~NeonHandle();
 
     std::string key;
     ne_session *session;
+    std::unique_ptr<NeonAddresses> addresses; // set when balancing over several addresses
 };
 
 typedef std::shared_ptr<NeonHandle> NeonHandlePtr;
@@ -69,6 +72,27 @@ public:
     //--------------------------------------------------------------------------
     bool getSessionCaching() const;
 
+    //--------------------------------------------------------------------------
+    // Get session pool hit / miss / eviction counters
+    //--------------------------------------------------------------------------
+    SessionPoolStats getSessionPoolStats() const {
+        return _session_pool.getStats();
+    }
+
+    //--------------------------------------------------------------------------
+    // TLS sessions shared by all neon sessions of this factory
+    //--------------------------------------------------------------------------
+    ne_ssl_session_cache* getTlsSessionCache() const {
+        return _tls_sessions;
+    }
+
+    //--------------------------------------------------------------------------
+    // Addresses of the servers new sessions connect to
+    //--------------------------------------------------------------------------
+    AddressBook& getAddressBook() {
+        return _addresses;
+    }
+
 private:
     //--------------------------------------------------------------------------
     // Neon session pool
@@ -78,6 +102,12 @@ private:
     NeonHandlePtr create_session(const RequestParams & params, const std::string & protocol, const std::string &host, unsigned int port);
     NeonHandlePtr create_recycled_session(const RequestParams & params, const std::string & protocol, const std::string &host, unsigned int port);
 
+    //--------------------------------------------------------------------------
+    // Give a new session all the addresses of host, starting with the one
+    // the address book picks for it.
+    //--------------------------------------------------------------------------
+    void configureAddresses(NeonHandle &handle, const std::string &host, unsigned int port);
+
     //--------------------------------------------------------------------------
     // Create a brand new neon session object, internal use only.
     //--------------------------------------------------------------------------
@@ -89,6 +119,15 @@ private:
     mutable std::mutex _session_caching_mtx;
     bool _session_caching;
 
+    //--------------------------------------------------------------------------
+    // Shared TLS sessions, which must outlive the pooled neon sessions
+    //--------------------------------------------------------------------------
+    ne_ssl_session_cache *_tls_sessions;
+
+    //--------------------------------------------------------------------------
+    // Addresses of the servers, and how connecting to them goes
+    //--------------------------------------------------------------------------
+    AddressBook _addresses;
 };
 
 std::string create_map_keys_from_URL(const std::string & protocol, const std::string &host, unsigned int port);
@@ -91,6 +91,7 @@ struct RequestParamsInternal{
         _s3_listing_mode(S3ListingMode::Hierarchical),
         _swift_listing_mode(SwiftListingMode::Hierarchical),
         _s3_max_key_entries(10000),
+        _s3_listing_parallelism(1),
         _ca_path(),
         _x509_data(),
         _idlogpass(),
@@ -113,6 +114,7 @@ struct RequestParamsInternal{
         _customhdr(),
         _proxy_server(),
         _session_flag(SESSION_FLAG_KEEP_ALIVE),
+        _http2(false),
         _state_uid(get_requeste_uid()),
         _transferCb(),
         retry_number(default_retry_number),
@@ -120,7 +122,14 @@ struct RequestParamsInternal{
         _copy_mode(CopyMode::Push),
         _support_100continue(true),
         _accepted_retry(180), // wait for half an hour by default
-        _accepted_delay(10)
+        _accepted_delay(10),
+        _multipart_threshold(1024 * 1024 * 512),
+        _multipart_part_size(0),
+        _multipart_parallelism(4),
+        _download_streams(1),
+        _download_segment_size(1024 * 1024 * 64),
+        _read_ahead_inflight(8),
+        _read_ahead_block_size(2 * 1024 * 1024)
     {
         timespec_clear(&connexion_timeout);
         timespec_clear(&ops_timeout);
@@ -143,6 +152,7 @@ struct RequestParamsInternal{
         _s3_listing_mode(param_private._s3_listing_mode),
         _swift_listing_mode(param_private._swift_listing_mode),
         _s3_max_key_entries(param_private._s3_max_key_entries),
+        _s3_listing_parallelism(param_private._s3_listing_parallelism),
         _ca_path(param_private._ca_path),
         _x509_data(param_private._x509_data),
         _idlogpass(param_private._idlogpass),
@@ -165,6 +175,7 @@ struct RequestParamsInternal{
         _customhdr(param_private._customhdr),
         _proxy_server(param_private._proxy_server),
         _session_flag(param_private._session_flag),
+        _http2(param_private._http2),
         _state_uid(param_private._state_uid),
         _transferCb(param_private._transferCb),
         retry_number(param_private.retry_number),
@@ -172,7 +183,14 @@ struct RequestParamsInternal{
         _copy_mode(param_private._copy_mode),
         _support_100continue(param_private._support_100continue),
         _accepted_retry(param_private._accepted_retry),
-        _accepted_delay(param_private._accepted_delay) {
+        _accepted_delay(param_private._accepted_delay),
+        _multipart_threshold(param_private._multipart_threshold),
+        _multipart_part_size(param_private._multipart_part_size),
+        _multipart_parallelism(param_private._multipart_parallelism),
+        _download_streams(param_private._download_streams),
+        _download_segment_size(param_private._download_segment_size),
+        _read_ahead_inflight(param_private._read_ahead_inflight),
+        _read_ahead_block_size(param_private._read_ahead_block_size) {
 
         timespec_copy(&(connexion_timeout), &(param_private.connexion_timeout));
         timespec_copy(&(ops_timeout), &(param_private.ops_timeout));
@@ -190,6 +208,9 @@ struct RequestParamsInternal{
     // Max number of keys returned by a S3 list bucket request
     unsigned long _s3_max_key_entries;
 
+    // Number of concurrent requests of a flat S3 bucket listing
+    unsigned int _s3_listing_parallelism;
+
     // CA management
     std::vector<std::string> _ca_path;
 
@@ -229,6 +250,9 @@ struct RequestParamsInternal{
     // session flag
     int _session_flag;
 
+    // HTTP/2 with the libcurl backend
+    bool _http2;
+
     // ssl state value, a state uid is used to check if two copy of a requestParam struct are equal
     int _state_uid;
 
@@ -253,6 +277,27 @@ struct RequestParamsInternal{
     // delay in seconds between retries in case davix receives 202-Accepted
     int _accepted_delay;
 
+    // upload size above which multi-part uploads are used
+    dav_size_t _multipart_threshold;
+
+    // size of each part of a multi-part upload, 0 for the protocol default
+    dav_size_t _multipart_part_size;
+
+    // number of parts of a multi-part upload in flight at once
+    unsigned int _multipart_parallelism;
+
+    // number of concurrent segment streams for whole-object downloads
+    unsigned int _download_streams;
+
+    // size of each segment of a segmented download
+    dav_size_t _download_segment_size;
+
+    // read-ahead requests in flight, at most
+    unsigned int _read_ahead_inflight;
+
+    // read-ahead request size
+    dav_size_t _read_ahead_block_size;
+
     // method
     inline void regenerateStateUid(){
         _state_uid = get_requeste_uid();
@@ -465,6 +510,14 @@ unsigned long RequestParams::getS3MaxKey() const{
     return d_ptr->_s3_max_key_entries;
 }
 
+void RequestParams::setS3ListingParallelism(const unsigned int parallelism){
+    d_ptr->_s3_listing_parallelism = parallelism;
+}
+
+unsigned int RequestParams::getS3ListingParallelism() const{
+    return d_ptr->_s3_listing_parallelism;
+}
+
 void RequestParams::addCertificateAuthorityPath(const std::string &path){
     d_ptr->regenerateStateUid();
     d_ptr->_ca_path.push_back(path);
@@ -566,6 +619,17 @@ bool RequestParams::getKeepAlive() const{
 }
 
 
+void RequestParams::setHttp2(const bool http2_flag){
+    d_ptr->regenerateStateUid();
+    d_ptr->_http2 = http2_flag;
+}
+
+
+bool RequestParams::getHttp2() const{
+    return d_ptr->_http2;
+}
+
+
 
 void RequestParams::addHeader(const std::string &key, const std::string &val) {
 
@@ -625,6 +689,62 @@ void RequestParams::setAcceptedRetryDelay(int delay) {
   d_ptr->_accepted_delay = delay;
 }
 
+dav_size_t RequestParams::getMultipartUploadThreshold() const {
+  return d_ptr->_multipart_threshold;
+}
+
+void RequestParams::setMultipartUploadThreshold(dav_size_t threshold) {
+  d_ptr->_multipart_threshold = threshold;
+}
+
+dav_size_t RequestParams::getMultipartUploadPartSize() const {
+  return d_ptr->_multipart_part_size;
+}
+
+void RequestParams::setMultipartUploadPartSize(dav_size_t part_size) {
+  d_ptr->_multipart_part_size = part_size;
+}
+
+unsigned int RequestParams::getMultipartUploadParallelism() const {
+  return d_ptr->_multipart_parallelism;
+}
+
+void RequestParams::setMultipartUploadParallelism(unsigned int nparts) {
+  d_ptr->_multipart_parallelism = nparts;
+}
+
+unsigned int RequestParams::getSegmentedDownloadStreams() const {
+  return d_ptr->_download_streams;
+}
+
+void RequestParams::setSegmentedDownloadStreams(unsigned int nstreams) {
+  d_ptr->_download_streams = nstreams;
+}
+
+dav_size_t RequestParams::getSegmentedDownloadSegmentSize() const {
+  return d_ptr->_download_segment_size;
+}
+
+void RequestParams::setSegmentedDownloadSegmentSize(dav_size_t segment_size) {
+  d_ptr->_download_segment_size = segment_size;
+}
+
+unsigned int RequestParams::getReadAheadMaxInFlight() const {
+  return d_ptr->_read_ahead_inflight;
+}
+
+void RequestParams::setReadAheadMaxInFlight(unsigned int nrequests) {
+  d_ptr->_read_ahead_inflight = nrequests;
+}
+
+dav_size_t RequestParams::getReadAheadBlockSize() const {
+  return d_ptr->_read_ahead_block_size;
+}
+
+void RequestParams::setReadAheadBlockSize(dav_size_t block_size) {
+  d_ptr->_read_ahead_block_size = block_size;
+}
+
 // suppress useless warning
 #pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
 void* RequestParams::getParmState() const{
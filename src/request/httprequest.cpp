@@ -23,6 +23,7 @@
 
 #include <neon/neonrequest.hpp>
 #include <davix_context_internal.hpp>
+#include <core/Executor.hpp>
 #include <request/httprequest.hpp>
 
 namespace Davix {
@@ -148,6 +149,34 @@ int HttpRequest::executeRequest(DavixError **err){
     return -1;
 }
 
+void HttpRequest::executeRequestAsync(const RequestCompletionCallback & callback){
+    Executor & executor = ContextExplorer::ExecutorFromContext(d_ptr->get()->getContext());
+
+    executor.submit([this, callback]() {
+        DavixError* tmp_err = NULL;
+        executeRequest(&tmp_err);
+
+        callback(*this, tmp_err);
+        DavixError::clearError(&tmp_err);
+    });
+}
+
+std::future<int> HttpRequest::executeRequestAsync(){
+    std::shared_ptr<std::promise<int> > result(new std::promise<int>());
+
+    executeRequestAsync([result](HttpRequest & req, DavixError* err) {
+        if(err) {
+            DavixError* owned = err->clone();
+            result->set_exception(std::make_exception_ptr(DavixException(&owned)));
+            return;
+        }
+
+        result->set_value(req.getRequestCode());
+    });
+
+    return result->get_future();
+}
+
 int HttpRequest::beginRequest(DavixError **err){
     TRY_DAVIX{
         // triggers Hooks
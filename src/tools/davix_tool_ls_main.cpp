@@ -44,6 +44,7 @@ std::string  get_base_listing_options(){
            "\t--no-cap:                 Disable size cap on task queue for pending listing operations\n"
            "\t--s3-listing:             S3 bucket listing mode - flat, semi or hierarchical(default)\n"
            "\t--s3-maxkeys:             Maximum number of entries returns by S3 list bucket request. default: 10000\n"
+           "\t--s3-listing-parallel N:  Number of concurrent requests for a flat S3 bucket listing. default: 1\n"
            "\t--swift-listing:          Swift listing mode - semi or hierarchical(default)\n";
 }
 
@@ -67,6 +67,7 @@ const std::string scope_params = "Davix::Tools::Params";
 #define OS_PROJECT_ID          1029
 #define SWIFT_LISTING_MODE     1030
 #define SWIFT_ACCOUNT          1031
+#define S3_LISTING_PARALLEL    1032
 
 // LONG OPTS
 
@@ -112,6 +113,7 @@ const std::string scope_params = "Davix::Tools::Params";
 #define LISTING_LONG_OPTIONS \
 {"s3-listing", required_argument, 0,  S3_LISTING_MODE }, \
 {"s3-maxkeys", required_argument, 0,  S3_MAX_KEYS }, \
+{"s3-listing-parallel", required_argument, 0,  S3_LISTING_PARALLEL }, \
 {"no-cap", required_argument, 0, DISABLE_LISTING_CAP}, \
 {"long-list", no_argument, 0,  'l' }, \
 {"swift-listing", required_argument, 0, SWIFT_LISTING_MODE}
@@ -279,6 +281,9 @@ int parse_davix_options_generic(const std::string &opt_filter,
             case S3_MAX_KEYS:
                 p.params.setS3MaxKey(atoi(optarg));
                 break;
+            case S3_LISTING_PARALLEL:
+                p.params.setS3ListingParallelism(std::max(1, atoi(optarg)));
+                break;
             case SWIFT_LISTING_MODE:
                 {
                     if(std::string(optarg).compare("hierarchical")==0)
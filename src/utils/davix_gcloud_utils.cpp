@@ -175,13 +175,13 @@ Uri signURI(const Credentials& creds, const std::string &verb, const Uri &url, c
   return signURIFixedTimeout(creds, verb, url, headers, time(NULL) + signDuration);
 }
 
-Uri signURIFixedTimeout(const Credentials& creds, const std::string &verb, const Uri &url, const HeaderVec &headers, const time_t expirationTime) {
+static Uri signURIWith(const RsaSha256Signer &signer, const Credentials& creds, const std::string &verb, const Uri &url, const HeaderVec &headers, const time_t expirationTime) {
   // Reference: https://cloud.google.com/storage/docs/access-control/create-signed-urls-program
   // Construct string to sign..
   std::string stringToSign = getStringToSign(verb, url, headers, expirationTime);
 
   // Calculate signature..
-  std::string binarySignature = rsasha256(creds.getPrivateKey(), stringToSign);
+  std::string binarySignature = signer.sign(stringToSign);
 
   // Base64 encode signature..
   std::string signature = Base64::base64_encode( (unsigned char*) binarySignature.c_str(), binarySignature.size());
@@ -194,6 +194,27 @@ Uri signURIFixedTimeout(const Credentials& creds, const std::string &verb, const
   return signedUrl;
 }
 
+Uri signURIFixedTimeout(const Credentials& creds, const std::string &verb, const Uri &url, const HeaderVec &headers, const time_t expirationTime) {
+  RsaSha256Signer signer(creds.getPrivateKey());
+  return signURIWith(signer, creds, verb, url, headers, expirationTime);
+}
+
+std::vector<Uri> signURIs(const Credentials& creds, const std::string &verb, const std::vector<Uri> &urls, const HeaderVec &headers, const time_t signDuration) {
+  return signURIsFixedTimeout(creds, verb, urls, headers, time(NULL) + signDuration);
+}
+
+std::vector<Uri> signURIsFixedTimeout(const Credentials& creds, const std::string &verb, const std::vector<Uri> &urls, const HeaderVec &headers, const time_t expirationTime) {
+  // parsing the private key costs more than signing with it
+  RsaSha256Signer signer(creds.getPrivateKey());
+
+  std::vector<Uri> signedUrls;
+  signedUrls.reserve(urls.size());
+  for(std::vector<Uri>::const_iterator it = urls.begin(); it != urls.end(); it++) {
+    signedUrls.push_back(signURIWith(signer, creds, verb, *it, headers, expirationTime));
+  }
+  return signedUrls;
+}
+
 Uri getListingURI(const Uri & original_url, const RequestParams & params) {
     Uri newUri = original_url;
     newUri.setPath("/" + extract_bucket(original_url) );
@@ -24,6 +24,8 @@
 #include <iomanip>
 #include <ctime>
 #include <cstring>
+#include <mutex>
+#include <unordered_map>
 #include <davix_internal.hpp>
 #include <utils/stringutils.hpp>
 #include "libs/datetime/datetime_utils.hpp"
@@ -72,16 +74,65 @@ std::string getAwsAuthorizationField(const std::string & stringToSign, const std
     return ss.str();
 }
 
-std::string getAwsSignaturev4(const std::string & stringToSign, const std::string & private_key,
-                           const std::string & region, const std::string & service) {
-    const std::string date = current_time("%Y%m%d");
-    const std::string kDate = hmac_sha256("AWS4" + private_key, date);
-    const std::string kRegion = hmac_sha256(kDate, region);
-    const std::string kService = hmac_sha256(kRegion, service);
+static const char hexDigits[] = "0123456789abcdef";
 
-    const std::string c = "aws4_request";
-    const std::string kSigning = hmac_sha256(kService, c);
-    return hexEncode(hmac_sha256(kSigning, stringToSign));
+static void appendHex(std::string & out, const std::string & input) {
+    out.reserve(out.size() + input.size() * 2);
+    for(std::string::const_iterator it = input.begin(); it != input.end(); it++) {
+        const unsigned char c = *it;
+        out += hexDigits[c >> 4];
+        out += hexDigits[c & 0x0f];
+    }
+}
+
+namespace {
+
+// The four-step HMAC chain deriving a v4 signing key only depends on the
+// secret key, the date, the region and the service: derive it once a day,
+// not once per request.
+class SigningKeyCache {
+public:
+    std::string get(const std::string & private_key, const std::string & date,
+                    const std::string & region, const std::string & service) {
+        std::string key;
+        key.reserve(private_key.size() + date.size() + region.size() + service.size() + 3);
+        key.append(private_key).append(1, '\n').append(date).append(1, '\n')
+           .append(region).append(1, '\n').append(service);
+
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            std::unordered_map<std::string, std::string>::const_iterator it = _keys.find(key);
+            if(it != _keys.end()) {
+                return it->second;
+            }
+        }
+
+        const std::string kDate = hmac_sha256("AWS4" + private_key, date);
+        const std::string kRegion = hmac_sha256(kDate, region);
+        const std::string kService = hmac_sha256(kRegion, service);
+        const std::string kSigning = hmac_sha256(kService, "aws4_request");
+
+        std::lock_guard<std::mutex> lock(_mtx);
+        // keys of past days are never used again
+        if(_keys.size() >= kMaxKeys) {
+            _keys.clear();
+        }
+        _keys[key] = kSigning;
+        return kSigning;
+    }
+
+private:
+    static const size_t kMaxKeys = 256;
+
+    std::mutex _mtx;
+    std::unordered_map<std::string, std::string> _keys;
+};
+
+}
+
+static SigningKeyCache & getSigningKeyCache() {
+    static SigningKeyCache cache;
+    return cache;
 }
 
 namespace S3{
@@ -259,119 +310,112 @@ void signRequest(const RequestParams & params, const std::string & method, const
 #define SSTR(message) static_cast<std::ostringstream&>(std::ostringstream().flush() << message).str()
 
 Uri signURIv4(const RequestParams & params, const std::string & method, const Uri & url, const HeaderVec headers, const time_t expirationTime) {
+    return signURIv4(params, method, url, headers, expirationTime, time(NULL));
+}
+
+// amzdate is the signing time, as YYYYMMDDTHHMMSSZ
+static Uri signURIv4With(const RequestParams & params, const std::string & method, const Uri & url, const HeaderVec & headers,
+                         const time_t expirationTime, const std::string & amzdate, const std::string & signingKey) {
     // references
     // http://docs.aws.amazon.com/AmazonS3/latest/API/sig-v4-header-based-auth.html
     // http://docs.aws.amazon.com/general/latest/gr/sigv4-create-canonical-request.html
     DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_S3, "Using S3 v4 signature authentication");
 
+    const std::string date = amzdate.substr(0, 8);
+    const std::string & region = params.getAwsRegion();
+
     // using a non-default port?
     bool defaultPort;
-    std::string portPart;
+    std::string host = url.getHost();
 
     defaultPort = (url.getPort() == 0);
     defaultPort |= (url.getPort() == 80 && (url.getProtocol() == "http" || url.getProtocol() == "s3"));
     defaultPort |= (url.getPort() == 443 && (url.getProtocol() == "https" || url.getProtocol() == "s3s"));
 
-    if(!defaultPort) portPart = SSTR(":" << url.getPort());
+    if(!defaultPort) {
+        host += ':';
+        host += std::to_string(url.getPort());
+    }
 
     // calculate canonical headers
     HeaderVec can_headers = getAmzCanonHeaders_vec(headers);
-    can_headers.push_back(HeaderLine("Host", SSTR(url.getHost() << portPart)));
+    can_headers.push_back(HeaderLine("Host", host));
     std::sort(can_headers.begin(), can_headers.end());
-    std::ostringstream can_headers_str;
-    for(HeaderVec::iterator it = can_headers.begin(); it != can_headers.end(); it++) {
-        can_headers_str << StrUtil::toLower(it->first) << ":" << StrUtil::trim(it->second) << "\n";
-    }
 
-    std::ostringstream signed_headers;
+    std::string can_headers_str, signed_headers;
     for(HeaderVec::iterator it = can_headers.begin(); it != can_headers.end(); it++) {
-        signed_headers << StrUtil::toLower(it->first);
-        if(it+1 != can_headers.end()) {
-            signed_headers << ";";
+        const std::string name = StrUtil::toLower(it->first);
+        can_headers_str.append(name).append(1, ':').append(StrUtil::trim(it->second)).append(1, '\n');
+
+        if(!signed_headers.empty()) {
+            signed_headers += ';';
         }
+        signed_headers += name;
     }
 
     // calculate query parameters
+    std::string scope;
+    scope.reserve(date.size() + region.size() + 20);
+    scope.append(date).append(1, '/').append(region).append("/s3/aws4_request");
+
     ParamVec query_params;
+    query_params.reserve(7);
     query_params.push_back(HeaderLine("X-Amz-Algorithm", "AWS4-HMAC-SHA256"));
-
-    std::ostringstream credential;
-    credential << params.getAwsAutorizationKeys().second
-               << "/" << current_time("%Y%m%d")
-               << "/" << params.getAwsRegion()
-               << "/" << "s3"
-               << "/" << "aws4_request";
-
-    query_params.push_back(HeaderLine("X-Amz-Credential", credential.str()));
+    query_params.push_back(HeaderLine("X-Amz-Credential", params.getAwsAutorizationKeys().second + "/" + scope));
 
     if(params.getAwsToken().size() != 0) {
         query_params.push_back(HeaderLine("X-Amz-Security-Token", params.getAwsToken()));
     }
 
-    // calculate amz date
-    std::string amzdate = current_time("%Y%m%dT%H%M%SZ");
     query_params.push_back(HeaderLine("X-Amz-Date", amzdate));
-
-    // add timeout
-    std::string expiration = SSTR(expirationTime);
-    query_params.push_back(HeaderLine("X-Amz-Expires", expiration));
-
-    // add amz signed headers
-    query_params.push_back(HeaderLine("X-Amz-SignedHeaders", signed_headers.str()));
+    query_params.push_back(HeaderLine("X-Amz-Expires", std::to_string(expirationTime)));
+    query_params.push_back(HeaderLine("X-Amz-SignedHeaders", signed_headers));
 
     // calculate *canonical* query string
+    const ParamVec existing_params = url.getQueryVec();
+
     ParamVec can_query_params;
+    can_query_params.reserve(query_params.size() + existing_params.size());
     for(ParamVec::iterator it = query_params.begin(); it != query_params.end(); it++) {
         can_query_params.push_back(ParamLine(Uri::queryParamEscape(it->first), Uri::queryParamEscape(it->second)));
     }
 
-    const ParamVec existing_params = url.getQueryVec();
-    for(ParamVec::const_iterator it = existing_params.begin(); it != existing_params.end(); it++) {
-        can_query_params.push_back(ParamLine(it->first, it->second));
-    }
-
+    can_query_params.insert(can_query_params.end(), existing_params.begin(), existing_params.end());
     std::sort(can_query_params.begin(), can_query_params.end());
 
-    std::ostringstream can_query_str;
+    // calculate canonical request
+    std::string canonical_request;
+    canonical_request.reserve(512 + url.getPath().size() + can_headers_str.size());
+    canonical_request.append(method).append(1, '\n').append(url.getPath()).append(1, '\n');
+
     for(ParamVec::iterator it = can_query_params.begin(); it != can_query_params.end(); it++) {
-        can_query_str << it->first << "=" << it->second;
-        if(it+1 != can_query_params.end()) {
-            can_query_str << "&";
+        if(it != can_query_params.begin()) {
+            canonical_request += '&';
         }
+        canonical_request.append(it->first).append(1, '=').append(it->second);
     }
 
-    // calculate canonical request
-    std::ostringstream canonical_request;
-    canonical_request << method << "\n"
-                      << url.getPath() << "\n"
-                      << can_query_str.str() << "\n"
-                      << can_headers_str.str() << "\n"
-                      << signed_headers.str() << "\n"
-                      << "UNSIGNED-PAYLOAD";
-
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "Canonical request: {}", canonical_request.str());
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "Canonical request bytes: {}", hexEncode(canonical_request.str(), " "));
-
-    // calculate canonical request hash
-    std::string can_req_hash = sha256(canonical_request.str().c_str());
-    std::string encoded_hash = hexEncode(can_req_hash);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "Canonical request hash: {}", encoded_hash);
-
-    // calculate string to sign
-    std::ostringstream stringToSign;
-    stringToSign << "AWS4-HMAC-SHA256" << "\n"
-                 << amzdate << "\n"
-                 << current_time("%Y%m%d") << "/" << params.getAwsRegion() << "/s3/aws4_request" << "\n"
-                 << encoded_hash;
-
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "String to sign (aws-alternate={}): {}", params.getAwsAlternate(), StrUtil::stringReplace(stringToSign.str(), "\n", "\\n"));
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "String to sign bytes: {}", hexEncode(stringToSign.str(), " "));
+    canonical_request.append(1, '\n').append(can_headers_str)
+                     .append(1, '\n').append(signed_headers)
+                     .append(1, '\n').append("UNSIGNED-PAYLOAD");
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "Canonical request: {}", canonical_request);
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "Canonical request bytes: {}", hexEncode(canonical_request, " "));
+
+    // calculate string to sign, with the canonical request hash
+    std::string stringToSign;
+    stringToSign.reserve(128 + scope.size());
+    stringToSign.append("AWS4-HMAC-SHA256\n").append(amzdate).append(1, '\n').append(scope).append(1, '\n');
+    appendHex(stringToSign, sha256(canonical_request));
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "String to sign (aws-alternate={}): {}", params.getAwsAlternate(), StrUtil::stringReplace(stringToSign, "\n", "\\n"));
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_S3, "String to sign bytes: {}", hexEncode(stringToSign, " "));
 
     // whew.. now calculate the final signature
     Uri signedUrl = url;
 
-    std::string signature = getAwsSignaturev4(stringToSign.str(), params.getAwsAutorizationKeys().first,
-                                              params.getAwsRegion(), "s3");
+    std::string signature;
+    appendHex(signature, hmac_sha256(signingKey, stringToSign));
 
     DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_S3, "Signature: {}", signature);
     signedUrl.addQueryParam("X-Amz-Signature", signature);
@@ -386,6 +430,14 @@ Uri signURIv4(const RequestParams & params, const std::string & method, const Ur
     return signedUrl;
 }
 
+Uri signURIv4(const RequestParams & params, const std::string & method, const Uri & url, const HeaderVec headers, const time_t expirationTime, const time_t signingTime) {
+    // a single timestamp, so that the date can't change halfway through
+    const std::string amzdate = time_as_string(signingTime, "%Y%m%dT%H%M%SZ");
+    const std::string signingKey = getSigningKeyCache().get(params.getAwsAutorizationKeys().first, amzdate.substr(0, 8),
+                                                            params.getAwsRegion(), "s3");
+    return signURIv4With(params, method, url, headers, expirationTime, amzdate, signingKey);
+}
+
 // return a signed s3 URI, does not modify the headers
 Uri signURI(const RequestParams & params, const std::string & method, const Uri & url, HeaderVec headers, const time_t expirationTime) {
     if(params.getAwsRegion().empty()) {
@@ -397,6 +449,33 @@ Uri signURI(const RequestParams & params, const std::string & method, const Uri
 }
 
 
+std::vector<Uri> signURIs(const RequestParams & params, const std::string & method, const std::vector<Uri> & urls, const HeaderVec & headers, const time_t expirationTime) {
+    return signURIs(params, method, urls, headers, expirationTime, time(NULL));
+}
+
+std::vector<Uri> signURIs(const RequestParams & params, const std::string & method, const std::vector<Uri> & urls, const HeaderVec & headers, const time_t expirationTime, const time_t signingTime) {
+    std::vector<Uri> signedUrls;
+    signedUrls.reserve(urls.size());
+
+    if(params.getAwsRegion().empty()) {
+        for(std::vector<Uri>::const_iterator it = urls.begin(); it != urls.end(); it++) {
+            HeaderVec copy(headers);
+            signedUrls.push_back(tokenizeRequest(params, method, *it, copy, signingTime + expirationTime));
+        }
+        return signedUrls;
+    }
+
+    // same timestamp and signing key for the whole batch
+    const std::string amzdate = time_as_string(signingTime, "%Y%m%dT%H%M%SZ");
+    const std::string signingKey = getSigningKeyCache().get(params.getAwsAutorizationKeys().first, amzdate.substr(0, 8),
+                                                            params.getAwsRegion(), "s3");
+
+    for(std::vector<Uri>::const_iterator it = urls.begin(); it != urls.end(); it++) {
+        signedUrls.push_back(signURIv4With(params, method, *it, headers, expirationTime, amzdate, signingKey));
+    }
+    return signedUrls;
+}
+
 Uri tokenizeRequest(const RequestParams & params, const std::string & method, const Uri & url, HeaderVec & headers, time_t expirationTime){
     if(params.getAwsToken().size() != 0) {
         headers.push_back(HeaderLine("x-amz-security-token", params.getAwsToken()));
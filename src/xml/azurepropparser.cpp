@@ -201,6 +201,7 @@ struct AzurePropParser::Internal {
     std::deque<FileProperties> props;
     FileProperties property;
     bool inside_prefix;
+    std::string next_marker;
 
     int start_elem(const std::string &elem){
         // new tag, clean content;
@@ -226,6 +227,11 @@ struct AzurePropParser::Internal {
     }
 
     int end_elem(const std::string &elem){
+        // continuation token of a truncated answer, comes last
+        if(StrUtil::compare_ncase("NextMarker", elem) == 0) {
+            next_marker = current;
+        }
+
         // name
         if(StrUtil::compare_ncase("Name", elem) == 0) {
             property.filename = current.erase(0, prefix_to_remove.size());
@@ -319,5 +325,9 @@ std::deque<FileProperties> & AzurePropParser::getProperties(){
     return d_ptr->props;
 }
 
+std::string AzurePropParser::getNextMarker() const{
+    return d_ptr->next_marker;
+}
+
 
 }
@@ -31,22 +31,37 @@ using namespace StrUtil;
 
 namespace Davix {
 
-const Xml::XmlPTree prop_node(Xml::ElementStart, "propstat");
-const Xml::XmlPTree prop_collection(Xml::ElementStart, "collection");
-static std::unique_ptr<Xml::XmlPTree> webDavTree;
-
-static std::once_flag _l_init;
+// Elements of a multistatus answer we extract something from. Each one
+// is interned once when it opens, its id is handed back to neon as the
+// element state: the rest of the parsing only compares integers, and
+// everything else is declined, pruning the whole subtree.
+enum DavPropElement{
+    ElementRoot = NE_XML_STATEROOT,
+    ElementMultistatus,
+    ElementResponse,
+    ElementHref,
+    ElementPropstat,
+    ElementStatus,
+    ElementProp,
+    ElementGetLastModified,
+    ElementCreationDate,
+    ElementQuotaUsedBytes,
+    ElementQuotaAvailableBytes,
+    ElementGetContentLength,
+    ElementOwner,
+    ElementGroup,
+    ElementMode,
+    ElementResourceType,
+    ElementCollection,
+    ElementCount
+};
 
 struct DavPropXMLParser::DavxPropXmlIntern{
-    DavxPropXmlIntern() : _stack(),
+    DavxPropXmlIntern() :
         _props(), _current_props(), _last_response_status(500), _last_filename(){
-        _stack.reserve(10);
         char_buffer.reserve(1024);
     }
 
-    // node stack
-    std::vector<Xml::XmlPTree> _stack;
-
     // props
     std::deque<FileProperties> _props;
     FileProperties _current_props;
@@ -57,7 +72,7 @@ struct DavPropXMLParser::DavxPropXmlIntern{
     std::string char_buffer;
 
     inline void appendChars(const char *buff, size_t len){
-        char_buffer.append(std::string(buff, len));
+        char_buffer.append(buff, len);
     }
 
     inline void clear(){
@@ -68,6 +83,7 @@ struct DavPropXMLParser::DavxPropXmlIntern{
     inline void add_new_elem(){
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " properties detected ");
         _current_props.clear();
+        _current_props.quota = QuotaInfo::Internal();
         _current_props.filename = _last_filename; // setup the current filename
         _current_props.info.mode = 0777 | S_IFREG; // default : fake access to everything
     }
@@ -76,7 +92,9 @@ struct DavPropXMLParser::DavxPropXmlIntern{
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " end of properties... ");
         if( _last_response_status > 100
             && _last_response_status < 400){
-            _props.push_back(_current_props);
+            // the listing may consume entries before the end of the
+            // answer, only complete ones go to the queue
+            _props.push_back(std::move(_current_props));
         }else{
            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, "Bad status code ! properties dropped");
         }
@@ -165,41 +183,34 @@ static void check_mode_ext(DavPropXMLParser::DavxPropXmlIntern & par, const std:
     par._current_props.info.mode = (mode_t) mymode;
 }
 
-static bool startswith(const std::string &str, const std::string &prefix) {
-  if(prefix.size() > str.size()) return false;
-
-  for(size_t i = 0; i < prefix.size(); i++) {
-    if(str[i] != prefix[i]) return false;
-  }
-  return true;
+static bool startswith(const std::string &str, const char *prefix) {
+  return str.compare(0, strlen(prefix), prefix) == 0;
 }
 
 static void check_href(DavPropXMLParser::DavxPropXmlIntern & par,  const std::string & name){
-    std::string _href(name);
-    rtrim(_href, isSlash()); // remove trailing slash
-    std::string::reverse_iterator it = std::find(_href.rbegin(), _href.rend(), '/');
-    if( it == _href.rend()){
-        par._last_filename.assign(_href);
-    }else{
-        par._last_filename.assign(it.base(), _href.end());
-
-        if(startswith(name, "https://") || startswith(name, "http://") || startswith(name, "://") || startswith(name, "dav://") || startswith(name, "davs://")) {
-          par._last_filename = Uri::unescapeString(par._last_filename);
-        }
+    // last path segment, trailing slashes removed
+    std::string::const_iterator end = name.end();
+    while(end != name.begin() && *(end-1) == '/'){
+        --end;
+    }
+    std::string::const_iterator begin = end;
+    while(begin != name.begin() && *(begin-1) != '/'){
+        --begin;
+    }
+    par._last_filename.assign(begin, end);
+
+    if(begin != name.begin() && (startswith(name, "https://") || startswith(name, "http://") || startswith(name, "://") || startswith(name, "dav://") || startswith(name, "davs://"))) {
+        par._last_filename = Uri::unescapeString(par._last_filename);
     }
    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " href/filename parsed -> {} ", par._last_filename.c_str() );
 }
 
 static void check_status(DavPropXMLParser::DavxPropXmlIntern & par, const std::string & name){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " status found -> parse it");
-    std::string str_status(name);
-    ltrim(str_status, StrUtil::isSpace());
-    std::string::iterator it1, it2;
-    it1 = std::find(str_status.begin(), str_status.end(), ' ');
-    if( it1 != str_status.end()){
-        it2 = std::find(it1+1, str_status.end(), ' ');
-        std::string str_status_parsed(it1+1, it2);
-        unsigned long res = strtoul(str_status_parsed.c_str(), NULL, 10);
+    // "HTTP/1.1 200 OK", the value is trimmed already
+    const char* code = strchr(name.c_str(), ' ');
+    if( code != NULL){
+        unsigned long res = strtoul(code+1, NULL, 10);
         if(res != ULONG_MAX){
            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " status value : {}", res);
            par._last_response_status = res;
@@ -212,9 +223,7 @@ static void check_status(DavPropXMLParser::DavxPropXmlIntern & par, const std::s
 
 static void check_owner_uid(DavPropXMLParser::DavxPropXmlIntern & par, const std::string & value){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " owner found -> parse it");
-    std::string str_owner(value);
-    ltrim(str_owner, StrUtil::isSpace());
-    unsigned long res = strtoul(str_owner.c_str(), NULL, 10);
+    unsigned long res = strtoul(value.c_str(), NULL, 10);
     if(res != ULONG_MAX){
        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " owner value : {}", res);
        par._current_props.info.owner = res;
@@ -225,9 +234,7 @@ static void check_owner_uid(DavPropXMLParser::DavxPropXmlIntern & par, const std
 
 static void check_group_gid(DavPropXMLParser::DavxPropXmlIntern & par, const std::string & value){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " group found -> parse it");
-    std::string str_group(value);
-    ltrim(str_group, StrUtil::isSpace());
-    unsigned long res = strtoul(str_group.c_str(), NULL, 10);
+    unsigned long res = strtoul(value.c_str(), NULL, 10);
     if(res != ULONG_MAX){
        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " group value : {}", res);
        par._current_props.info.group = res;
@@ -236,38 +243,46 @@ static void check_group_gid(DavPropXMLParser::DavxPropXmlIntern & par, const std
     DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_XML, "Invalid group field value");
 }
 
-void init_webdavTree(){
-
-    // Nodes list
-    webDavTree.reset(new Xml::XmlPTree(Xml::ElementStart, "multistatus"));
-    webDavTree->addChild(Xml::XmlPTree(Xml::ElementStart, "response"));
-    Xml::XmlPTree::iterator it = webDavTree->beginChildren();
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "href", Xml::XmlPTree::ChildrenList(),  (void*) &check_href));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "propstat"));
-    it = (--it->endChildren());
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "status", Xml::XmlPTree::ChildrenList(), (void*) &check_status));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "prop"));
-    it = (--it->endChildren());
-
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "getlastmodified", Xml::XmlPTree::ChildrenList(),  (void*) &check_last_modified));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "creationdate", Xml::XmlPTree::ChildrenList(), (void*) &check_creation_date));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "quota-used-bytes", Xml::XmlPTree::ChildrenList(), (void*) &check_quota_used_bytes));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "quota-available-bytes", Xml::XmlPTree::ChildrenList(), (void*) &check_quota_free_space));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "getcontentlength", Xml::XmlPTree::ChildrenList(), (void*) &check_content_length));
-
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "owner", Xml::XmlPTree::ChildrenList(), (void*) &check_owner_uid));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "group", Xml::XmlPTree::ChildrenList(), (void*) &check_group_gid));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "mode", Xml::XmlPTree::ChildrenList(), (void*) &check_mode_ext));
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "resourcetype"));
-
-    it = (--it->endChildren());
-    it->addChild(Xml::XmlPTree(Xml::ElementStart, "collection", Xml::XmlPTree::ChildrenList(), (void*) &check_is_directory));
+struct DavPropElementSpec{
+    const char* name;
+    int parent;
+    properties_cb cb;
+};
+
+// indexed by DavPropElement
+static const DavPropElementSpec dav_prop_elements[ElementCount] = {
+    { "",                       -1,                 NULL },
+    { "multistatus",            ElementRoot,        NULL },
+    { "response",               ElementMultistatus, NULL },
+    { "href",                   ElementResponse,    &check_href },
+    { "propstat",               ElementResponse,    NULL },
+    { "status",                 ElementPropstat,    &check_status },
+    { "prop",                   ElementPropstat,    NULL },
+    { "getlastmodified",        ElementProp,        &check_last_modified },
+    { "creationdate",           ElementProp,        &check_creation_date },
+    { "quota-used-bytes",       ElementProp,        &check_quota_used_bytes },
+    { "quota-available-bytes",  ElementProp,        &check_quota_free_space },
+    { "getcontentlength",       ElementProp,        &check_content_length },
+    { "owner",                  ElementProp,        &check_owner_uid },
+    { "group",                  ElementProp,        &check_group_gid },
+    { "mode",                   ElementProp,        &check_mode_ext },
+    { "resourcetype",           ElementProp,        NULL },
+    { "collection",             ElementResourceType, &check_is_directory }
+};
+
+// id of the element, or NE_XML_DECLINE if it is of no interest here
+static int intern_element(int parent, const char* name){
+    for(int id = ElementMultistatus; id < ElementCount; ++id){
+        if(dav_prop_elements[id].parent == parent && match_element(name, dav_prop_elements[id].name)){
+            return id;
+        }
+    }
+    return NE_XML_DECLINE;
 }
 
 DavPropXMLParser::DavPropXMLParser() :
     d_ptr(new DavxPropXmlIntern())
 {
-    std::call_once(_l_init, init_webdavTree);
 }
 
 DavPropXMLParser::~DavPropXMLParser(){
@@ -281,56 +296,46 @@ std::deque<FileProperties> & DavPropXMLParser::getProperties(){
 
 
 int DavPropXMLParser::parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts){
-    (void) parent;
-    (void) name;
     (void) nspace;
     (void) atts;
-    // add elem to stack
-    Xml::XmlPTree node(Xml::ElementStart, name);
-    d_ptr->_stack.push_back(node);
+    const int id = intern_element(parent, name);
 
     // if beginning of prop, add new element
-    if(node.compareNode(prop_node)){
+    if(id == ElementPropstat){
         d_ptr->add_new_elem();
     }
-    return 1;
+
+    if(dav_prop_elements[id].cb){
+        d_ptr->clear();
+    }
+    return id;
 }
 
 
 int DavPropXMLParser::parserCdataCb(int state, const char *cdata, size_t len){
-    (void) state;
-    d_ptr->appendChars(cdata, len);
+    // whitespace between the containers is dropped right away
+    if(dav_prop_elements[state].cb){
+        d_ptr->appendChars(cdata, len);
+    }
     return 0;
 }
 
 
 int DavPropXMLParser::parserEndElemCb(int state, const char *nspace, const char *name){
-    (void) state;
     (void) nspace;
-    Xml::XmlPTree node(Xml::ElementStart, name);
-
-    // find potential interesting data
-    std::vector<Xml::XmlPTree::ptr_type> chain;
-    if(d_ptr->char_buffer.size() != 0 || node.compareNode(prop_collection)){
-        chain = webDavTree->findChain(d_ptr->_stack);
-        if(chain.size() > 0){
-            properties_cb cb = ((properties_cb) chain.at(chain.size()-1)->getMeta());
-            if(cb){
-                StrUtil::trim(d_ptr->char_buffer);
-                cb(*d_ptr, d_ptr->char_buffer);
-            }
-        }
+    (void) name;
+
+    properties_cb cb = dav_prop_elements[state].cb;
+    if(cb && (d_ptr->char_buffer.size() != 0 || state == ElementCollection)){
+        StrUtil::trim(d_ptr->char_buffer);
+        cb(*d_ptr, d_ptr->char_buffer);
     }
 
     // push props
-    if(node.compareNode(prop_node)){
+    if(state == ElementPropstat){
         d_ptr->store_new_elem();
     }
 
-    // cleaning work
-    if(d_ptr->_stack.size()  == 0)
-        throw DavixException(davix_scope_xml_parser(),StatusCode::ParsingError, "Corrupted Parser Stack, Invalid XML");
-    d_ptr->_stack.pop_back();
     d_ptr->clear();
     return 0;
 }
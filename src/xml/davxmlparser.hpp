@@ -112,6 +112,11 @@ public:
     XMLPropParser(){}
     virtual ~XMLPropParser(){}
 
+    ///
+    /// marker to request the next page of a paginated listing with,
+    /// empty as long as it is not known, or on the last page
+    virtual std::string getNextMarker() const { return std::string(); }
+
 };
 
 
@@ -37,6 +37,8 @@ const std::string prefix_prop = "Prefix";
 const std::string com_prefix_prop = "CommonPrefixes";
 const std::string listbucketresult_prop = "ListBucketResult";
 const std::string last_modified_prop = "LastModified";
+const std::string truncated_prop = "IsTruncated";
+const std::string next_marker_prop = "NextMarker";
 
 struct S3PropParser::Internal{
     std::string current;
@@ -50,6 +52,12 @@ struct S3PropParser::Internal{
     FileProperties property;
     S3ListingMode::S3ListingMode _s3_listing_mode;
 
+    // pagination state
+    bool truncated;
+    bool in_common_prefixes;
+    std::string next_marker;
+    std::string last_key;
+
     int start_elem(const std::string &elem){
         // new tag, clean content;
         current.clear();
@@ -80,6 +88,10 @@ struct S3PropParser::Internal{
             inside_com_prefix = true;
         }
 
+        if( StrUtil::compare_ncase(com_prefix_prop, elem) ==0){
+            in_common_prefixes = true;
+        }
+
         // check element, if prefix clear current entry
         if( (_s3_listing_mode == S3ListingMode::Hierarchical) && StrUtil::compare_ncase(prefix_prop, elem) ==0){
             DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_XML, "prefix found", elem.c_str());
@@ -97,6 +109,30 @@ struct S3PropParser::Internal{
     int end_elem(const std::string &elem){
         StrUtil::trim(current);
 
+        // truncated answer: NextMarker comes before the entries, but is only
+        // sent along with a delimiter, else the last key is the marker
+        if( StrUtil::compare_ncase(truncated_prop, elem) ==0){
+            truncated = (StrUtil::compare_ncase("true", current) ==0);
+        }
+
+        if( StrUtil::compare_ncase(next_marker_prop, elem) ==0){
+            next_marker = current;
+        }
+
+        if( (StrUtil::compare_ncase(name_prop, elem) ==0 ||
+                (in_common_prefixes && StrUtil::compare_ncase(prefix_prop, elem) ==0)) &&
+                current > last_key){
+            last_key = current;
+        }
+
+        if( StrUtil::compare_ncase(com_prefix_prop, elem) ==0){
+            in_common_prefixes = false;
+        }
+
+        if( StrUtil::compare_ncase(listbucketresult_prop, elem) ==0 && truncated && next_marker.empty()){
+            next_marker = last_key;
+        }
+
         // found prefix
         if( (_s3_listing_mode == S3ListingMode::Hierarchical) &&
                 StrUtil::compare_ncase(prefix_prop, elem) ==0 &&
@@ -252,5 +288,9 @@ std::deque<FileProperties> & S3PropParser::getProperties(){
     return d_ptr->props;
 }
 
+std::string S3PropParser::getNextMarker() const{
+    return (d_ptr->truncated) ? d_ptr->next_marker : std::string();
+}
+
 
 }
@@ -45,9 +45,16 @@ struct SwiftPropParser::Internal {
     std::deque<FileProperties> props;
     FileProperties property;
 
+    // pagination state
+    int depth;
+    bool finished;
+    size_t entries;
+    std::string last_name;
+
     int start_elem(const std::string &elem){
         // new tag, clean content;
         current.clear();
+        depth++;
 
         // if new entry (a directory), clear entry
         if(StrUtil::compare_ncase("subdir", elem) ==0){
@@ -73,8 +80,15 @@ struct SwiftPropParser::Internal {
     }
 
     int end_elem(const std::string &elem){
+        // back to the root element, the page is complete
+        if(--depth == 0) {
+            finished = true;
+        }
+
         // name
         if(StrUtil::compare_ncase("name", elem) == 0) {
+            last_name = current;
+            entries++;
             property.filename = current.erase(0, prefix_to_remove.size());
         }
 
@@ -182,4 +196,10 @@ int SwiftPropParser::parserEndElemCb(int state, const char *nspace, const char *
 std::deque<FileProperties> & SwiftPropParser::getProperties(){
     return d_ptr->props;
 }
+
+// The answer carries no marker, and the page limit of the server is not known:
+// any page but an empty one may have a next one, following its last name
+std::string SwiftPropParser::getNextMarker() const{
+    return (d_ptr->finished && d_ptr->entries > 0) ? d_ptr->last_name : std::string();
+}
 }
\ No newline at end of file
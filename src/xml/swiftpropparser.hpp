@@ -41,6 +41,8 @@ public:
 
     virtual std::deque<FileProperties> & getProperties();
 
+    virtual std::string getNextMarker() const;
+
 
 protected:
     virtual int parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts);
@@ -0,0 +1,83 @@
+// Micro-benchmark of the PROPFIND answer parser: parse a synthetic
+// multistatus listing of a large WebDAV directory, fed in chunks the way
+// the directory listing reads it from the network. Reports entries/s.
+//
+// usage: davix-propfind-parse-bench [nentries] [iterations] [chunksize]
+
+#include <davix.hpp>
+#include <xml/davpropxmlparser.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace Davix;
+
+// answer of a mod_dav-like server, with properties the parser skips
+// next to the ones it extracts
+static std::string makeMultistatus(size_t nentries) {
+    std::string body;
+    body.reserve(nentries * 900);
+    body += "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<D:multistatus xmlns:D=\"DAV:\" xmlns:lcgdm=\"LCGDM:\">\n";
+
+    for(size_t i = 0; i < nentries; i++) {
+        const std::string name = "file-" + std::to_string(i) + ((i % 3 == 0) ? "%20copy.root" : ".root");
+        const bool dir = (i == 0) || (i % 50 == 0);
+
+        body += "<D:response xmlns:lp1=\"DAV:\" xmlns:lp2=\"http://apache.org/dav/props/\">\n";
+        body += "<D:href>/eos/experiment/data/run2024/";
+        body += (i == 0) ? std::string() : name;
+        body += dir ? "/" : "";
+        body += "</D:href>\n<D:propstat>\n<D:prop>\n";
+        body += dir ? "<lp1:resourcetype><D:collection/></lp1:resourcetype>\n" : "<lp1:resourcetype/>\n";
+        body += "<lp1:creationdate>2024-03-0" + std::to_string(1 + i % 9) + "T10:21:44Z</lp1:creationdate>\n";
+        body += "<lp1:getcontentlength>" + std::to_string(1000 + i * 37) + "</lp1:getcontentlength>\n";
+        body += "<lp1:getlastmodified>Mon, 04 Mar 2024 10:21:44 GMT</lp1:getlastmodified>\n";
+        body += "<lp1:getetag>\"" + std::to_string(i * 7919) + "-5f1a8b3c\"</lp1:getetag>\n";
+        body += "<lp2:executable>F</lp2:executable>\n";
+        body += "<D:supportedlock>\n<D:lockentry>\n<D:lockscope><D:exclusive/></D:lockscope>\n"
+                "<D:locktype><D:write/></D:locktype>\n</D:lockentry>\n</D:supportedlock>\n";
+        body += "<D:lockdiscovery/>\n<lcgdm:mode>0" + std::string(dir ? "40755" : "100644") + "</lcgdm:mode>\n";
+        body += "<D:getcontenttype>application/octet-stream</D:getcontenttype>\n";
+        body += "</D:prop>\n<D:status>HTTP/1.1 200 OK</D:status>\n</D:propstat>\n</D:response>\n";
+    }
+
+    body += "</D:multistatus>\n";
+    return body;
+}
+
+int main(int argc, char **argv) {
+    size_t nentries = (argc > 1) ? atol(argv[1]) : 100000;
+    size_t iterations = (argc > 2) ? atol(argv[2]) : 5;
+    size_t chunksize = (argc > 3) ? atol(argv[3]) : 16384;
+
+    const std::string body = makeMultistatus(nentries);
+
+    double elapsed = 0;
+    for(size_t i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+
+        DavPropXMLParser parser;
+        for(size_t offset = 0; offset < body.size(); offset += chunksize) {
+            parser.parseChunk(body.c_str() + offset, std::min(chunksize, body.size() - offset));
+        }
+        parser.parseChunk(NULL, 0);
+
+        // the listing consumes the entries as they come
+        std::deque<FileProperties> &props = parser.getProperties();
+        if(props.size() != nentries || !S_ISDIR(props.front().info.mode) || props.back().info.size <= 0) {
+            std::cerr << "Wrong parsing result: " << props.size() << " entries" << std::endl;
+            return 1;
+        }
+        props.clear();
+
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const double total = (double) nentries * iterations;
+    std::cout << nentries << " entries, " << body.size() / (1024 * 1024) << " MB, " << iterations << " iterations" << std::endl;
+    std::cout << "DavPropXMLParser: " << (size_t) (total / elapsed) << " entries/s, "
+              << (size_t) (body.size() * iterations / elapsed / (1024 * 1024)) << " MB/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Micro-benchmark of the vectored read range index: build the index,
+// merge the ranges, and route a simulated multipart answer into the
+// output buffers, as preadVec does. Reports ranges/s, next to the
+// interval tree which was previously used for the same job.
+//
+// usage: davix-range-index-bench [nranges] [rangesize] [gap] [iterations]
+
+#include <davix.hpp>
+#include <fileops/RangeIndex.hpp>
+#include <libs/IntervalTree.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <vector>
+
+using namespace Davix;
+
+struct Workload {
+    std::vector<DavIOVecInput> in;
+    std::vector<DavIOVecOuput> out;
+    std::vector<char> buffers;
+    std::vector<char> source;
+    dav_size_t mergewindow;
+};
+
+static Workload makeWorkload(size_t nranges, size_t rangesize, size_t gap) {
+    Workload w;
+    w.in.resize(nranges);
+    w.out.resize(nranges);
+    w.buffers.resize(nranges * rangesize);
+    w.source.resize(nranges * (rangesize + gap));
+    w.mergewindow = gap / 2; // do not merge everything into one range
+
+    for(size_t i = 0; i < w.source.size(); i++) {
+        w.source[i] = (char) (i * 7);
+    }
+
+    for(size_t i = 0; i < nranges; i++) {
+        w.in[i].diov_offset = i * (rangesize + gap);
+        w.in[i].diov_size = rangesize;
+        w.in[i].diov_buffer = &w.buffers[i * rangesize];
+    }
+
+    // TTreeCache-like requests are not strictly sorted
+    for(size_t i = 0; i + 1 < nranges; i += 7) {
+        std::swap(w.in[i], w.in[i+1]);
+    }
+
+    return w;
+}
+
+// answer pieces as a multipart parser would deliver them, 4 KB at most
+template<typename Fill>
+static void replay(const SortedRanges &merged, const Workload &w, Fill fill) {
+    for(size_t i = 0; i < merged.size(); i++) {
+        for(dav_off_t off = merged[i].first; off <= (dav_off_t) merged[i].second; off += 4096) {
+            dav_size_t len = std::min<dav_off_t>(4096, (dav_off_t) merged[i].second - off + 1);
+            fill(&w.source[off], off, len);
+        }
+    }
+}
+
+static double benchRangeIndex(Workload &w) {
+    auto start = std::chrono::steady_clock::now();
+
+    RangeIndex index(w.in.data(), w.out.data(), w.in.size());
+    SortedRanges merged = index.merge(w.mergewindow);
+
+    RangeIndex::Cursor cursor(index);
+    replay(merged, w, [&cursor](const char *src, dav_off_t off, dav_size_t len) {
+        cursor.fill(src, off, len);
+    });
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct TreeElem {
+    const DavIOVecInput *in;
+    DavIOVecOuput *out;
+};
+
+static double benchIntervalTree(Workload &w) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Interval<TreeElem> > intervals;
+    for(size_t i = 0; i < w.in.size(); i++) {
+        w.out[i].diov_size = 0;
+        TreeElem elem = { &w.in[i], &w.out[i] };
+        intervals.push_back(Interval<TreeElem>(w.in[i].diov_offset, w.in[i].diov_offset + w.in[i].diov_size - 1, elem));
+    }
+    IntervalTree<TreeElem> tree(intervals);
+
+    // merge through a sorted multimap, as before
+    std::vector<Interval<TreeElem> > all;
+    tree.findContained(0, std::numeric_limits<dav_size_t>::max(), all);
+    std::multimap<dav_off_t, dav_off_t> sorted;
+    for(size_t i = 0; i < all.size(); i++) {
+        sorted.insert(std::make_pair(all[i].start, all[i].stop));
+    }
+
+    SortedRanges merged;
+    dav_off_t offset = sorted.begin()->first, end = sorted.begin()->second;
+    for(std::multimap<dav_off_t, dav_off_t>::iterator it = sorted.begin(); it != sorted.end(); it++) {
+        if(end + (dav_off_t) w.mergewindow >= it->first) {
+            end = std::max(end, it->second);
+        }
+        else {
+            merged.push_back(std::make_pair(offset, end));
+            offset = it->first;
+            end = it->second;
+        }
+    }
+    merged.push_back(std::make_pair(offset, end));
+
+    replay(merged, w, [&tree](const char *src, dav_off_t off, dav_size_t len) {
+        std::vector<Interval<TreeElem> > matches;
+        tree.findOverlapping(off, off + len - 1, matches);
+        for(size_t i = 0; i < matches.size(); i++) {
+            const DavIOVecInput *in = matches[i].value.in;
+            dav_off_t common = std::max<dav_off_t>(off, in->diov_offset);
+            dav_size_t dist = std::min<dav_off_t>(off + len - 1, in->diov_offset + in->diov_size - 1) - common + 1;
+            memcpy((char*) in->diov_buffer + (common - in->diov_offset), src + (common - off), dist);
+            matches[i].value.out->diov_size += dist;
+        }
+    });
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool verify(const Workload &w) {
+    for(size_t i = 0; i < w.in.size(); i++) {
+        if((dav_size_t) w.out[i].diov_size != w.in[i].diov_size ||
+           memcmp(w.in[i].diov_buffer, &w.source[w.in[i].diov_offset], w.in[i].diov_size) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    size_t nranges = (argc > 1) ? atol(argv[1]) : 10000;
+    size_t rangesize = (argc > 2) ? atol(argv[2]) : 300;
+    size_t gap = (argc > 3) ? atol(argv[3]) : 1000;
+    size_t iterations = (argc > 4) ? atol(argv[4]) : 20;
+
+    Workload w = makeWorkload(nranges, rangesize, gap);
+
+    double index_time = 0, tree_time = 0;
+    for(size_t i = 0; i < iterations; i++) {
+        index_time += benchRangeIndex(w);
+        if(!verify(w)) {
+            std::cerr << "RangeIndex produced wrong output" << std::endl;
+            return 1;
+        }
+
+        tree_time += benchIntervalTree(w);
+        if(!verify(w)) {
+            std::cerr << "IntervalTree produced wrong output" << std::endl;
+            return 1;
+        }
+    }
+
+    const double total = (double) nranges * iterations;
+    std::cout << nranges << " ranges of " << rangesize << " bytes, " << iterations << " iterations" << std::endl;
+    std::cout << "RangeIndex:   " << (size_t) (total / index_time) << " ranges/s" << std::endl;
+    std::cout << "IntervalTree: " << (size_t) (total / tree_time) << " ranges/s" << std::endl;
+    return 0;
+}
@@ -21,6 +21,8 @@
 
 #include "Interactors.hpp"
 #include "LineReader.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
 //------------------------------------------------------------------------------
@@ -109,3 +111,95 @@ void SingleShotInteractor::main(ThreadAssistant &assistant) {
   std::cout << "Response written successfully" << std::endl;
   _is_ok = true;
 }
+
+//------------------------------------------------------------------------------
+// Value of the given (lowercase) header, empty if absent
+//------------------------------------------------------------------------------
+std::string DrunkRequest::header(const std::string &name) const {
+  std::map<std::string, std::string>::const_iterator it = headers.find(name);
+  if(it == headers.end()) {
+    return std::string();
+  }
+  return it->second;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+KeepAliveInteractor::KeepAliveInteractor(const Handler &handler)
+: _handler(handler) {}
+
+//------------------------------------------------------------------------------
+// Destructor, closes the connection
+//------------------------------------------------------------------------------
+KeepAliveInteractor::~KeepAliveInteractor() {
+  _thread.join();
+}
+
+//------------------------------------------------------------------------------
+// Strip trailing CRLF and surrounding spaces
+//------------------------------------------------------------------------------
+static std::string trim(const std::string &str) {
+  size_t begin = str.find_first_not_of(" \t\r\n");
+  if(begin == std::string::npos) {
+    return std::string();
+  }
+  return str.substr(begin, str.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+//------------------------------------------------------------------------------
+// Run interacting thread
+//------------------------------------------------------------------------------
+void KeepAliveInteractor::main(ThreadAssistant &assistant) {
+  assistant.registerCallback([this]() { _conn->shutdown(); });
+  _is_ok = true;
+
+  while(!assistant.terminationRequested()) {
+    DrunkRequest request;
+    std::string line;
+    if(_reader->consumeLine(line) != 1) {
+      return;
+    }
+
+    std::vector<std::string> parts = split(trim(line), " ");
+    if(parts.size() < 2) {
+      _is_ok = false;
+      return;
+    }
+    request.method = parts[0];
+    request.path = parts[1];
+
+    while(true) {
+      if(_reader->consumeLine(line) != 1) {
+        return;
+      }
+
+      line = trim(line);
+      if(line.empty()) {
+        break;
+      }
+
+      size_t colon = line.find(':');
+      if(colon != std::string::npos) {
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        request.headers[name] = trim(line.substr(colon + 1));
+      }
+    }
+
+    size_t length = strtoull(request.header("content-length").c_str(), NULL, 10);
+    while(request.body.size() < length) {
+      std::string chunk;
+      if(_conn->read(chunk, length - request.body.size()) <= 0) {
+        return;
+      }
+      request.body += chunk;
+    }
+
+    std::string response = _handler(request);
+    if(response.empty() || _conn->write(response) != (ssize_t) response.size()) {
+      _conn->shutdown();
+      return;
+    }
+  }
+}
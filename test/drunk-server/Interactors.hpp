@@ -25,6 +25,10 @@
 #include "AssistedThread.hh"
 #include "DrunkServer.hpp"
 
+#include <functional>
+#include <map>
+#include <string>
+
 class LineReader;
 
 //------------------------------------------------------------------------------
@@ -93,4 +97,47 @@ protected:
   std::string _response;
 };
 
+//------------------------------------------------------------------------------
+// A request, as parsed by KeepAliveInteractor. Header names are lowercased.
+//------------------------------------------------------------------------------
+struct DrunkRequest {
+  std::string method;
+  std::string path;
+  std::map<std::string, std::string> headers;
+  std::string body;
+
+  //----------------------------------------------------------------------------
+  // Value of the given (lowercase) header, empty if absent
+  //----------------------------------------------------------------------------
+  std::string header(const std::string &name) const;
+};
+
+//------------------------------------------------------------------------------
+// Keep-alive interactor - answers any number of requests on the connection,
+// each one with the full response returned by the handler. An empty response
+// closes the connection.
+//------------------------------------------------------------------------------
+class KeepAliveInteractor : public BasicInteractor {
+public:
+  typedef std::function<std::string (const DrunkRequest &request)> Handler;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  KeepAliveInteractor(const Handler &handler);
+
+  //----------------------------------------------------------------------------
+  // Destructor, closes the connection
+  //----------------------------------------------------------------------------
+  virtual ~KeepAliveInteractor();
+
+  //----------------------------------------------------------------------------
+  // Run interacting thread
+  //----------------------------------------------------------------------------
+  void main(ThreadAssistant &assistant);
+
+protected:
+  Handler _handler;
+};
+
 #endif
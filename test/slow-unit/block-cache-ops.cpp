@@ -0,0 +1,294 @@
+#include "test-utils.hpp"
+#include <davix.hpp>
+#include <davix_context_internal.hpp>
+#include <core/BlockCache.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents;
+  for(size_t i = 0; i < size; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+class BlockCacheOpsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/davix-block-cache-ops-XXXXXX";
+    ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+    directory = tmpl;
+    uri = "http://localhost:22222/file";
+  }
+
+  void TearDown() override {
+    DIR* dir = opendir(directory.c_str());
+    struct dirent* entry;
+    while(dir != NULL && (entry = readdir(dir)) != NULL) {
+      unlink((directory + "/" + entry->d_name).c_str());
+    }
+    if(dir != NULL) {
+      closedir(dir);
+    }
+    rmdir(directory.c_str());
+  }
+
+  // open, read sequentially in small chunks, close
+  std::string readAll(Context &context) {
+    DavPosix posix(&context);
+    DavixError* err = NULL;
+
+    DAVIX_FD* fd = posix.open(NULL, uri, O_RDONLY, &err);
+    EXPECT_TRUE(fd != NULL) << (err ? err->getErrMsg() : "");
+    if(fd == NULL) {
+      DavixError::clearError(&err);
+      return std::string();
+    }
+
+    std::string result;
+    char buffer[4096];
+    ssize_t ret;
+    while((ret = posix.read(fd, buffer, sizeof(buffer), &err)) > 0) {
+      result.append(buffer, ret);
+    }
+    EXPECT_EQ(ret, 0);
+    EXPECT_EQ(posix.close(fd, &err), 0);
+    DavixError::clearError(&err);
+    return result;
+  }
+
+  std::string readPartial(Context &context, dav_size_t count, dav_off_t offset) {
+    DavFile file(context, Uri(uri));
+    DavixError* err = NULL;
+    std::string result(count, '\0');
+
+    dav_ssize_t ret = file.readPartial(NULL, &result[0], count, offset, &err);
+    EXPECT_GE(ret, 0) << (err ? err->getErrMsg() : "");
+    DavixError::clearError(&err);
+    result.resize(std::max<dav_ssize_t>(ret, 0));
+    return result;
+  }
+
+  std::string directory;
+  std::string uri;
+};
+
+TEST_F(BlockCacheOpsTest, SequentialReReadFromDiskCache) {
+  std::string contents = makeContents(600 * 1000);
+  KeepAliveServer server([&contents](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  Context context;
+  context.setDiskCache(directory, 64 * 1024 * 1024);
+
+  ASSERT_EQ(readAll(context), contents);
+  const size_t gets = server.count("GET");
+  ASSERT_GT(gets, 0u);
+
+  ASSERT_EQ(readAll(context), contents);
+  ASSERT_EQ(server.count("GET"), gets);
+
+  // a new context only shares the directory
+  Context other;
+  other.setDiskCache(directory, 64 * 1024 * 1024);
+  ASSERT_EQ(readAll(other), contents);
+  ASSERT_EQ(server.count("GET"), gets);
+}
+
+TEST_F(BlockCacheOpsTest, WholeFileReReadFromMemoryCache) {
+  std::string contents = makeContents(600 * 1000);
+  KeepAliveServer server([&contents](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  Context context;
+  context.setBlockCacheSize(16 * 1024 * 1024);
+
+  DavFile file(context, Uri(uri));
+  std::vector<char> buffer(3, 'x');
+  ASSERT_EQ(file.get(NULL, buffer), (dav_ssize_t) contents.size());
+  ASSERT_EQ(std::string(buffer.begin() + 3, buffer.end()), contents);
+  const size_t gets = server.count("GET");
+
+  buffer.clear();
+  ASSERT_EQ(file.get(NULL, buffer), (dav_ssize_t) contents.size());
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), contents);
+
+  DavixError* err = NULL;
+  char path[] = "/tmp/davix-block-cache-ops-fd-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  unlink(path);
+  ASSERT_EQ(file.getToFd(NULL, fd, &err), (dav_ssize_t) contents.size());
+  ASSERT_EQ(lseek(fd, 0, SEEK_CUR), (off_t) contents.size());
+  close(fd);
+
+  ASSERT_EQ(server.count("GET"), gets);
+}
+
+TEST_F(BlockCacheOpsTest, ValidatorLearnedThenChecked) {
+  std::string contents = makeContents(600 * 1000);
+  KeepAliveServer server([&contents](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  Context context;
+  context.setBlockCacheSize(16 * 1024 * 1024);
+
+  // nothing cached yet: the validator comes with the first block
+  ASSERT_EQ(readPartial(context, 100, 1000), contents.substr(1000, 100));
+  ASSERT_EQ(server.count("HEAD"), 0u);
+  ASSERT_EQ(server.count("GET"), 1u);
+
+  // cached blocks are only used after checking the validator
+  ASSERT_EQ(readPartial(context, 100, 2000), contents.substr(2000, 100));
+  ASSERT_EQ(server.count("HEAD"), 1u);
+  ASSERT_EQ(server.count("GET"), 1u);
+}
+
+TEST_F(BlockCacheOpsTest, InvalidateOnChange) {
+  std::mutex mtx;
+  std::string contents = makeContents(600 * 1000);
+  std::string etag = "\"v1\"";
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return serveContents(req, contents, etag);
+  });
+
+  Context context;
+  context.setBlockCacheSize(16 * 1024 * 1024);
+  DavPosix posix(&context);
+  DavixError* err = NULL;
+  DAVIX_FD* fd = posix.open(NULL, uri, O_RDONLY, &err);
+  ASSERT_TRUE(fd != NULL);
+
+  char buffer[100];
+  ASSERT_EQ(posix.pread(fd, buffer, 100, 0, &err), 100);
+  ASSERT_EQ(std::string(buffer, 100), contents.substr(0, 100));
+
+  // the file changes while being read
+  std::string changed = contents;
+  std::reverse(changed.begin(), changed.end());
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    contents = changed;
+    etag = "\"v2\"";
+  }
+
+  // the next block comes with the new validator, older blocks are dropped
+  ASSERT_EQ(posix.pread(fd, buffer, 100, 300 * 1000, &err), 100);
+  ASSERT_EQ(std::string(buffer, 100), changed.substr(300 * 1000, 100));
+  const size_t gets = server.count("GET");
+
+  ASSERT_EQ(posix.pread(fd, buffer, 100, 0, &err), 100);
+  ASSERT_EQ(std::string(buffer, 100), changed.substr(0, 100));
+  ASSERT_EQ(server.count("GET"), gets + 1);
+
+  // and blocks cached from now on are reused
+  ASSERT_EQ(posix.pread(fd, buffer, 100, 1000, &err), 100);
+  ASSERT_EQ(std::string(buffer, 100), changed.substr(1000, 100));
+  ASSERT_EQ(server.count("GET"), gets + 1);
+
+  ASSERT_EQ(posix.close(fd, &err), 0);
+}
+
+TEST_F(BlockCacheOpsTest, ChangeWithinRead) {
+  std::mutex mtx;
+  std::string contents = makeContents(600 * 1000);
+  std::string etag = "\"v1\"";
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return serveContents(req, contents, etag);
+  });
+
+  Context context;
+  context.setBlockCacheSize(16 * 1024 * 1024);
+  DavPosix posix(&context);
+  DavixError* err = NULL;
+  DAVIX_FD* fd = posix.open(NULL, uri, O_RDONLY, &err);
+  ASSERT_TRUE(fd != NULL);
+
+  std::string buffer(300 * 1000, '\0');
+  ASSERT_EQ(posix.pread(fd, &buffer[0], 100, 0, &err), 100);
+
+  std::string changed = contents;
+  std::reverse(changed.begin(), changed.end());
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    contents = changed;
+    etag = "\"v2\"";
+  }
+
+  // the first block is cached from the old version, the second one comes
+  // from the new one: nothing of the old version is returned
+  ASSERT_EQ(posix.pread(fd, &buffer[0], buffer.size(), 0, &err), (ssize_t) buffer.size());
+  ASSERT_TRUE(buffer == changed.substr(0, buffer.size()));
+
+  // nor cached
+  ASSERT_EQ(posix.pread(fd, &buffer[0], 100, 0, &err), 100);
+  ASSERT_EQ(buffer.substr(0, 100), changed.substr(0, 100));
+
+  ASSERT_EQ(posix.close(fd, &err), 0);
+}
+
+TEST_F(BlockCacheOpsTest, WrongContentRange) {
+  std::string contents = makeContents(600 * 1000);
+  KeepAliveServer server([&contents](const DrunkRequest &req) {
+    std::string answer = serveContents(req, contents, "\"v1\"");
+
+    // claims the block starts one byte later than asked
+    const std::string header = "Content-Range: bytes 0-";
+    const size_t pos = answer.find(header);
+    if(pos != std::string::npos) {
+      answer.replace(pos, header.size(), "Content-Range: bytes 1-");
+    }
+    return answer;
+  });
+
+  Context context;
+  context.setBlockCacheSize(16 * 1024 * 1024);
+  DavFile file(context, Uri(uri));
+  DavixError* err = NULL;
+  char buffer[100];
+
+  ASSERT_LT(file.readPartial(NULL, buffer, 100, 0, &err), 0);
+  ASSERT_TRUE(err != NULL);
+  ASSERT_EQ(err->getStatus(), StatusCode::InvalidServerResponse);
+  DavixError::clearError(&err);
+  ASSERT_EQ(ContextExplorer::BlockCacheFromContext(context).getUsage(), 0u);
+}
+
+TEST_F(BlockCacheOpsTest, NoRangeSupportBypass) {
+  std::string contents = makeContents(600 * 1000);
+  KeepAliveServer server([&contents](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"", false);
+  });
+
+  Context context;
+  context.setBlockCacheSize(16 * 1024 * 1024);
+  DavPosix posix(&context);
+  DavixError* err = NULL;
+  DAVIX_FD* fd = posix.open(NULL, uri, O_RDONLY, &err);
+  ASSERT_TRUE(fd != NULL);
+
+  char buffer[100];
+  ASSERT_EQ(posix.pread(fd, buffer, 100, 1000, &err), 100);
+  ASSERT_EQ(std::string(buffer, 100), contents.substr(1000, 100));
+  const size_t gets = server.count("GET");
+
+  // nothing cached, plain requests from now on
+  ASSERT_EQ(posix.pread(fd, buffer, 100, 2000, &err), 100);
+  ASSERT_EQ(std::string(buffer, 100), contents.substr(2000, 100));
+  ASSERT_EQ(server.count("GET"), gets + 1);
+  ASSERT_EQ(ContextExplorer::BlockCacheFromContext(context).getUsage(), 0u);
+
+  ASSERT_EQ(posix.close(fd, &err), 0);
+}
@@ -0,0 +1,41 @@
+#include "test-utils.hpp"
+#include <curl/CurlSessionFactory.hpp>
+
+using namespace Davix;
+
+// run a GET on a request of the curl backend, returns the status code
+static int runCurl(SessionFactory &factory, const RequestParams &params) {
+  BoundHooks hooks;
+  std::vector<HeaderLine> headers;
+  StandaloneCurlRequest request(factory.getCurl(), true, hooks, Uri("https://localhost:22222/file"), "GET",
+    params, headers, 0, NULL, Chrono::TimePoint());
+
+  Status st = request.startRequest();
+  if(!st.ok()) {
+    return -1;
+  }
+
+  char buffer[1024];
+  while(request.readBlock(buffer, sizeof(buffer), st) > 0) {}
+  if(!st.ok() || !request.endRequest().ok()) {
+    return -1;
+  }
+  return request.getStatusCode();
+}
+
+TEST(Http2, OfferedThroughAlpn) {
+  TlsServer server;
+  SessionFactory factory;
+
+  RequestParams params;
+  params.setSSLCAcheck(false);
+
+  // pinned to HTTP/1.1 by default
+  ASSERT_EQ(runCurl(factory, params), 200);
+  ASSERT_EQ(server.offeredProtocols(), "http/1.1");
+
+  // HTTP/2 is offered first, the server picks HTTP/1.1
+  params.setHttp2(true);
+  ASSERT_EQ(runCurl(factory, params), 200);
+  ASSERT_EQ(server.offeredProtocols(), "h2,http/1.1");
+}
@@ -0,0 +1,69 @@
+#include "test-utils.hpp"
+#include <davix.hpp>
+#include <davix_context_internal.hpp>
+#include <core/Executor.hpp>
+
+#include <future>
+#include <thread>
+
+using namespace Davix;
+
+class PrewarmTest : public ::testing::Test {
+protected:
+  PrewarmTest() : contents(1000, 'a'), uri("http://localhost:22222/file") {}
+
+  std::string contents;
+  Uri uri;
+};
+
+TEST_F(PrewarmTest, ConnectionsPooledAndReused) {
+  KeepAliveServer server([this](const DrunkRequest &req) {
+    // keep concurrent requests on distinct connections
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  Context context;
+  DavixError* err = NULL;
+  ASSERT_EQ(context.prewarm(uri, 4, NULL, &err), 4);
+  ASSERT_TRUE(err == NULL);
+  ASSERT_EQ(server.count("HEAD"), 4u);
+  ASSERT_EQ(server.connections(), 4u);
+
+  // as many parallel requests find a connection each in the pool
+  std::vector<std::unique_ptr<HttpRequest> > requests;
+  std::vector<std::future<int> > results;
+  for(int i = 0; i < 4; i++) {
+    requests.emplace_back(new HttpRequest(context, uri, NULL));
+    results.push_back(requests.back()->executeRequestAsync());
+  }
+
+  for(size_t i = 0; i < results.size(); i++) {
+    ASSERT_EQ(results[i].get(), 200);
+  }
+
+  ASSERT_EQ(server.count("GET"), 4u);
+  ASSERT_EQ(server.connections(), 4u);
+}
+
+TEST_F(PrewarmTest, FromBusyExecutor) {
+  KeepAliveServer server([this](const DrunkRequest &req) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  Context context;
+  ContextExplorer::SetExecutorThreads(context, 1);
+
+  // the only worker waits on the prewarm
+  std::promise<int> opened;
+  ContextExplorer::ExecutorFromContext(context).submit([&]() {
+    opened.set_value(context.prewarm(uri, 3, NULL, NULL));
+  });
+
+  std::future<int> result = opened.get_future();
+  ASSERT_EQ(result.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(result.get(), 3);
+  ASSERT_EQ(server.count("HEAD"), 3u);
+  ASSERT_EQ(server.connections(), 3u);
+}
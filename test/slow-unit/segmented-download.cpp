@@ -0,0 +1,162 @@
+#include "test-utils.hpp"
+#include <davix.hpp>
+
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents;
+  for(size_t i = 0; i < size; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+static size_t rangeStart(const DrunkRequest &req) {
+  const std::string range = req.header("range");
+  return (range.empty()) ? 0 : strtoull(range.c_str() + 6, NULL, 10);
+}
+
+class SegmentedDownloadTest : public ::testing::Test {
+protected:
+  SegmentedDownloadTest() : contents(makeContents(95000)), file(context, Uri("http://localhost:22222/file")) {
+    params.setSegmentedDownloadStreams(4);
+    params.setSegmentedDownloadSegmentSize(10000);
+    params.setOperationRetry(1);
+  }
+
+  // number of GETs carrying a Range header
+  size_t segments(KeepAliveServer &server) {
+    size_t total = 0;
+    std::vector<DrunkRequest> requests = server.requests();
+    for(size_t i = 0; i < requests.size(); i++) {
+      total += (requests[i].method == "GET" && !requests[i].header("range").empty());
+    }
+    return total;
+  }
+
+  std::string contents;
+  Context context;
+  DavFile file;
+  RequestParams params;
+};
+
+TEST_F(SegmentedDownloadTest, OutOfOrderCompletion) {
+  std::mutex mtx;
+  std::vector<size_t> completed;
+
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    // the first segments come back last
+    if(req.method == "GET" && rangeStart(req) < 20000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    completed.push_back(rangeStart(req));
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  std::vector<char> buffer;
+  ASSERT_EQ(file.get(&params, buffer), (dav_ssize_t) contents.size());
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), contents);
+  ASSERT_EQ(segments(server), 10u);
+
+  std::lock_guard<std::mutex> lock(mtx);
+  ASSERT_NE(completed.back(), 90000u);
+}
+
+TEST_F(SegmentedDownloadTest, ReadFullAppends) {
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  std::vector<char> buffer(3, 'x');
+  ASSERT_EQ(file.get(&params, buffer), (dav_ssize_t) contents.size());
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), "xxx" + contents);
+  ASSERT_EQ(segments(server), 10u);
+}
+
+TEST_F(SegmentedDownloadTest, FdOffset) {
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  char path[] = "/tmp/davix-segmented-download-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  unlink(path);
+  ASSERT_EQ(write(fd, "hdr", 3), 3);
+
+  DavixError* err = NULL;
+  ASSERT_EQ(file.getToFd(&params, fd, &err), (dav_ssize_t) contents.size());
+  ASSERT_TRUE(err == NULL);
+  ASSERT_EQ(segments(server), 10u);
+
+  // where a sequential download would have left it
+  ASSERT_EQ(lseek(fd, 0, SEEK_CUR), (off_t) contents.size() + 3);
+  ASSERT_EQ(write(fd, "end", 3), 3);
+
+  std::string written(contents.size() + 6, '\0');
+  ASSERT_EQ(pread(fd, &written[0], written.size(), 0), (ssize_t) written.size());
+  ASSERT_EQ(written, "hdr" + contents + "end");
+  close(fd);
+}
+
+TEST_F(SegmentedDownloadTest, NotPartialContent) {
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    // one segment answered with the whole file
+    if(req.method == "GET" && rangeStart(req) == 30000) {
+      return serveContents(req, contents, "\"v1\"", false);
+    }
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  std::vector<char> buffer(3, 'x');
+  DavixError* err = NULL;
+  ASSERT_LT(file.getFull(&params, buffer, &err), 0);
+  ASSERT_TRUE(err != NULL);
+  ASSERT_EQ(err->getStatus(), StatusCode::InvalidServerResponse);
+  DavixError::clearError(&err);
+
+  // the caller's buffer is left as it was
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), "xxx");
+}
+
+TEST_F(SegmentedDownloadTest, TruncatedSegment) {
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    // one segment cut short, consistently with its headers
+    if(req.method == "GET" && rangeStart(req) == 50000) {
+      return std::string("HTTP/1.1 206 Partial Content\r\n"
+                         "Content-Range: bytes 50000-54999/95000\r\n"
+                         "Content-Length: 5000\r\n\r\n") + contents.substr(50000, 5000);
+    }
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  char path[] = "/tmp/davix-segmented-download-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  unlink(path);
+
+  DavixError* err = NULL;
+  ASSERT_LT(file.getToFd(&params, fd, &err), 0);
+  ASSERT_TRUE(err != NULL);
+  ASSERT_EQ(err->getStatus(), StatusCode::InvalidServerResponse);
+  DavixError::clearError(&err);
+  close(fd);
+}
+
+TEST_F(SegmentedDownloadTest, SmallFileSingleStream) {
+  contents = makeContents(15000);
+  KeepAliveServer server([&](const DrunkRequest &req) {
+    return serveContents(req, contents, "\"v1\"");
+  });
+
+  std::vector<char> buffer;
+  ASSERT_EQ(file.get(&params, buffer), (dav_ssize_t) contents.size());
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), contents);
+  ASSERT_EQ(segments(server), 0u);
+}
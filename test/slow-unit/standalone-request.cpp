@@ -276,3 +276,91 @@ TEST_F(Standalone_Neon_Request, StopNoStart) {
   ASSERT_EQ(request->getState(), RequestState::kFinished);
   ASSERT_EQ(request->getStatusCode(), 0);
 }
+
+class Standalone_Curl_Event_Loop_Request : public DavixTestFixture {};
+
+TEST_F(Standalone_Curl_Event_Loop_Request, BasicSanity) {
+  _headers.push_back(HeaderLine("I like", "Turtles"));
+  _uri = Uri("http://localhost:22222/chickens");
+
+  SingleShotInteractor inter(
+    SSTR("GET /chickens HTTP/1.1\r\n"  <<
+          "Host: localhost:22222\r\n"  <<
+          "Accept: */*\r\n"            <<
+          "I like: Turtles\r\n"),
+
+    SSTR("HTTP/1.1 200 OK\r\n"                       <<
+         "Date: Mon, 07 Oct 2019 14:02:25 GMT\r\n"   <<
+         "Content-Type: ayy/lmao\r\n"                <<
+         "Content-Length: 19\r\n"                    <<
+         "\r\n"                                      <<
+         "I like turtles too.\r\n")
+  );
+
+  _drunk_server->autoAcceptNext(&inter);
+
+  std::unique_ptr<StandaloneRequest> request = makeEventLoopCurlReq();
+  ASSERT_EQ(request->getState(), RequestState::kNotStarted);
+
+  ASSERT_TRUE(request->startRequest().ok());
+  ASSERT_EQ(request->getState(), RequestState::kStarted);
+  ASSERT_EQ(request->getStatusCode(), 200);
+
+  std::string headerLine;
+  ASSERT_TRUE(request->getAnswerHeader("Content-Type", headerLine));
+  ASSERT_EQ(headerLine, "ayy/lmao");
+
+  char buffer[2048];
+  std::string body;
+
+  Status st;
+  dav_ssize_t ret;
+  while((ret = request->readBlock(buffer, 2048, st)) > 0) {
+    body.append(buffer, ret);
+  }
+
+  ASSERT_TRUE(st.ok());
+  ASSERT_EQ(ret, 0);
+  ASSERT_EQ(body, "I like turtles too.");
+
+  st = request->endRequest();
+  ASSERT_EQ(request->getState(), RequestState::kFinished);
+  ASSERT_TRUE(st.ok());
+  ASSERT_TRUE(inter.ok());
+  ASSERT_EQ(request->getStatusCode(), 200);
+}
+
+TEST_F(Standalone_Curl_Event_Loop_Request, NetworkError) {
+  setConnectionTimeout(std::chrono::seconds(1));
+
+  ConnectionShutdownInteractor inter;
+  _drunk_server->autoAcceptNext(&inter);
+
+  std::unique_ptr<StandaloneRequest> request = makeEventLoopCurlReq();
+  Status st = request->startRequest();
+  ASSERT_EQ(request->getState(), RequestState::kFinished);
+
+  ASSERT_FALSE(st.ok());
+  ASSERT_EQ(st.getCode(), StatusCode::ConnectionProblem);
+  ASSERT_EQ(st.getErrorMessage(), "curl error (52): Server returned nothing (no headers, no data)");
+  ASSERT_EQ(request->getSessionError(), "curl error (52): Server returned nothing (no headers, no data)");
+  ASSERT_EQ(request->getStatusCode(), 0);
+
+  _drunk_server.reset();
+}
+
+TEST_F(Standalone_Curl_Event_Loop_Request, Timeout) {
+  DrunkServer::Connection* idle = NULL;
+  setDeadlineFromNow(std::chrono::milliseconds(1000));
+
+  std::unique_ptr<StandaloneRequest> request = makeEventLoopCurlReq();
+  std::unique_ptr<DrunkServer::Connection> conn;
+  std::thread acceptor([&]() { conn = _drunk_server->accept(5); idle = conn.get(); });
+
+  Status st = request->startRequest();
+  acceptor.join();
+
+  ASSERT_FALSE(st.ok());
+  ASSERT_EQ(st.getCode(), StatusCode::OperationTimeout);
+  ASSERT_TRUE(idle != NULL);
+}
@@ -23,12 +23,27 @@
 #define DAVIX_TEST_UTILS_HPP
 
 #include "../drunk-server/DrunkServer.hpp"
+#include "../drunk-server/Interactors.hpp"
 
 #include <gtest/gtest.h>
 #include <backend/StandaloneNeonRequest.hpp>
 #include <backend/SessionFactory.hpp>
 #include <curl/StandaloneCurlRequest.hpp>
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
 
 #define SSTR(message) static_cast<std::ostringstream&>(std::ostringstream().flush() << message).str()
 
@@ -57,6 +72,22 @@ public:
     );
   }
 
+  //----------------------------------------------------------------------------
+  // Curl request driven by a shared event loop engine, owned by a separate
+  // session factory.
+  //----------------------------------------------------------------------------
+  std::unique_ptr<Davix::StandaloneCurlRequest> makeEventLoopCurlReq() {
+    if(!_engine_factory) {
+      setenv("DAVIX_CURL_EVENT_LOOP", "1", 1);
+      _engine_factory.reset(new Davix::SessionFactory());
+      unsetenv("DAVIX_CURL_EVENT_LOOP");
+    }
+
+    return std::unique_ptr<Davix::StandaloneCurlRequest>(
+      new Davix::StandaloneCurlRequest(_engine_factory->getCurl(), true, _boundHooks, _uri, _verb, _params, _headers, _flags, NULL, _deadline)
+    );
+  }
+
   void setConnectionTimeout(std::chrono::seconds dur) {
     struct timespec tm;
     tm.tv_sec = dur.count();
@@ -72,6 +103,7 @@ public:
 protected:
   std::unique_ptr<DrunkServer> _drunk_server;
   Davix::SessionFactory _factory;
+  std::unique_ptr<Davix::SessionFactory> _engine_factory;
   Davix::BoundHooks _boundHooks;
   Davix::Uri _uri;
   std::string _verb;
@@ -83,4 +115,244 @@ protected:
 
 };
 
+//------------------------------------------------------------------------------
+// Server on port 22222 answering every request of up to maxConnections
+// keep-alive connections through the given handler, and recording them.
+//------------------------------------------------------------------------------
+class KeepAliveServer {
+public:
+  KeepAliveServer(const KeepAliveInteractor::Handler &handler, size_t maxConnections = 32) : _handler(handler) {
+    for(size_t i = 0; i < maxConnections; i++) {
+      _interactors.emplace_back(new KeepAliveInteractor([this, i](const DrunkRequest &req) {
+        {
+          std::lock_guard<std::mutex> lock(_mtx);
+          _requests.push_back(req);
+          _connections.insert(i);
+        }
+        return _handler(req);
+      }));
+    }
+
+    _server.reset(new DrunkServer(22222));
+    for(size_t i = 0; i < maxConnections; i++) {
+      _server->autoAcceptNext(_interactors[i].get());
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of requests received with the given method
+  //----------------------------------------------------------------------------
+  size_t count(const std::string &method) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    size_t total = 0;
+    for(size_t i = 0; i < _requests.size(); i++) {
+      total += (_requests[i].method == method);
+    }
+    return total;
+  }
+
+  std::vector<DrunkRequest> requests() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _requests;
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of distinct connections which carried at least one request
+  //----------------------------------------------------------------------------
+  size_t connections() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _connections.size();
+  }
+
+private:
+  KeepAliveInteractor::Handler _handler;
+  std::mutex _mtx;
+  std::vector<DrunkRequest> _requests;
+  std::set<size_t> _connections;
+  std::vector<std::unique_ptr<KeepAliveInteractor> > _interactors;
+  std::unique_ptr<DrunkServer> _server; // goes first
+};
+
+//------------------------------------------------------------------------------
+// TLS server on port 22222 with a throwaway self-signed certificate, closing
+// every connection after one answer, and recording which handshakes resumed
+// a previous TLS session, and the protocols offered by clients through ALPN.
+// HTTP/1.1 is what it speaks.
+//------------------------------------------------------------------------------
+class TlsServer {
+public:
+  TlsServer() : _ctx(SSL_CTX_new(TLS_server_method())), _fd(-1), _stall_next(false) {
+    EVP_PKEY_CTX* kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+    EVP_PKEY* key = NULL;
+    EVP_PKEY_keygen_init(kctx);
+    EVP_PKEY_CTX_set_rsa_keygen_bits(kctx, 2048);
+    EVP_PKEY_keygen(kctx, &key);
+    EVP_PKEY_CTX_free(kctx);
+
+    X509* cert = X509_new();
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME_add_entry_by_txt(X509_get_subject_name(cert), "CN", MBSTRING_ASC, (const unsigned char*) "localhost", -1, -1, 0);
+    X509_set_issuer_name(cert, X509_get_subject_name(cert));
+    X509_sign(cert, key, EVP_sha256());
+
+    SSL_CTX_set_alpn_select_cb(_ctx, &TlsServer::selectProtocol, this);
+    SSL_CTX_use_certificate(_ctx, cert);
+    SSL_CTX_use_PrivateKey(_ctx, key);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(22222);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(bind(_fd, (struct sockaddr*) &addr, sizeof(addr)), 0);
+    EXPECT_EQ(listen(_fd, 16), 0);
+
+    _thread = std::thread([this]() { serve(); });
+  }
+
+  ~TlsServer() {
+    ::shutdown(_fd, SHUT_RDWR);
+    _thread.join();
+    ::close(_fd);
+    SSL_CTX_free(_ctx);
+  }
+
+  //----------------------------------------------------------------------------
+  // Whether each completed handshake resumed a TLS session, in order
+  //----------------------------------------------------------------------------
+  std::vector<bool> handshakes() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _handshakes;
+  }
+
+  //----------------------------------------------------------------------------
+  // Protocols offered through ALPN by the last client, comma separated
+  //----------------------------------------------------------------------------
+  std::string offeredProtocols() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _offered;
+  }
+
+  //----------------------------------------------------------------------------
+  // Leave the handshake of the next connection unanswered until the client
+  // gives up, which fails it without any TLS alert
+  //----------------------------------------------------------------------------
+  void stallNext() {
+    _stall_next = true;
+  }
+
+private:
+  static int selectProtocol(SSL*, const unsigned char **out, unsigned char *outlen,
+    const unsigned char *in, unsigned int inlen, void *arg) {
+    TlsServer* self = static_cast<TlsServer*>(arg);
+    std::string offered;
+    for(unsigned int i = 0; i < inlen; i += 1 + in[i]) {
+      offered += (offered.empty() ? "" : ",") + std::string((const char*) in + i + 1, in[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(self->_mtx);
+    self->_offered = offered;
+
+    static const unsigned char http11[] = "\x08http/1.1";
+    return (SSL_select_next_proto((unsigned char**) out, outlen, http11, 9, in, inlen) == OPENSSL_NPN_NEGOTIATED) ?
+      SSL_TLSEXT_ERR_OK : SSL_TLSEXT_ERR_NOACK;
+  }
+
+  void serve() {
+    int client;
+    while((client = accept(_fd, NULL, NULL)) >= 0) {
+      if(_stall_next.exchange(false)) {
+        char buffer[1024];
+        while(recv(client, buffer, sizeof(buffer), 0) > 0) {}
+        ::close(client);
+        continue;
+      }
+
+      SSL* ssl = SSL_new(_ctx);
+      SSL_set_fd(ssl, client);
+
+      if(SSL_accept(ssl) == 1) {
+        {
+          std::lock_guard<std::mutex> lock(_mtx);
+          _handshakes.push_back(SSL_session_reused(ssl) == 1);
+        }
+
+        std::string request;
+        char buffer[1024];
+        int ret;
+        while(request.find("\r\n\r\n") == std::string::npos && (ret = SSL_read(ssl, buffer, sizeof(buffer))) > 0) {
+          request.append(buffer, ret);
+        }
+
+        const std::string answer = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok";
+        SSL_write(ssl, answer.c_str(), answer.size());
+        SSL_shutdown(ssl);
+      }
+
+      SSL_free(ssl);
+      ::close(client);
+    }
+  }
+
+  SSL_CTX* _ctx;
+  int _fd;
+  std::atomic<bool> _stall_next;
+  std::mutex _mtx;
+  std::vector<bool> _handshakes;
+  std::string _offered;
+  std::thread _thread;
+};
+
+//------------------------------------------------------------------------------
+// Answer a GET or HEAD of the given contents, honouring single byte ranges
+// unless ranges is false. An empty etag sends no validator.
+//------------------------------------------------------------------------------
+inline std::string serveContents(const DrunkRequest &req, const std::string &contents, const std::string &etag, bool ranges = true) {
+  std::ostringstream ss;
+  std::string body = contents;
+  std::string range = req.header("range");
+
+  if(ranges && range.compare(0, 6, "bytes=") == 0 && range.find(',') == std::string::npos) {
+    size_t dash = range.find('-');
+    size_t first = strtoull(range.c_str() + 6, NULL, 10);
+    size_t last = (dash + 1 < range.size()) ? strtoull(range.c_str() + dash + 1, NULL, 10) : contents.size() - 1;
+
+    if(first >= contents.size()) {
+      ss << "HTTP/1.1 416 Range Not Satisfiable\r\n" << "Content-Range: bytes */" << contents.size() << "\r\n";
+      body.clear();
+    }
+    else {
+      last = std::min(last, contents.size() - 1);
+      body = contents.substr(first, last - first + 1);
+      ss << "HTTP/1.1 206 Partial Content\r\n" << "Content-Range: bytes " << first << "-" << last << "/" << contents.size() << "\r\n";
+    }
+  }
+  else {
+    ss << "HTTP/1.1 200 OK\r\n";
+  }
+
+  if(ranges) {
+    ss << "Accept-Ranges: bytes\r\n";
+  }
+  if(!etag.empty()) {
+    ss << "ETag: " << etag << "\r\n";
+  }
+  ss << "Content-Length: " << body.size() << "\r\n\r\n";
+
+  if(req.method != "HEAD") {
+    ss << body;
+  }
+  return ss.str();
+}
+
 #endif
@@ -0,0 +1,101 @@
+#include "test-utils.hpp"
+#include <neon/neonsessionfactory.hpp>
+#include <curl/CurlSessionFactory.hpp>
+
+using namespace Davix;
+
+class TlsSessionsTest : public ::testing::Test {
+protected:
+  TlsSessionsTest() : _uri("https://localhost:22222/file"), _verb("GET"), _flags(0) {
+    _params.setSSLCAcheck(false);
+
+    // connections are not kept: TLS sessions are only resumed through the
+    // cache shared by the sessions of a factory
+    _factory.getNeon().setSessionCaching(false);
+    _factory.getCurl().setSessionCaching(false);
+  }
+
+  Status run(StandaloneRequest &request) {
+    Status st = request.startRequest();
+    if(!st.ok()) {
+      return st;
+    }
+
+    char buffer[1024];
+    while(request.readBlock(buffer, sizeof(buffer), st) > 0) {}
+    if(!st.ok()) {
+      return st;
+    }
+    return request.endRequest();
+  }
+
+  Status runNeon() {
+    StandaloneNeonRequest request(_factory.getNeon(), true, _hooks, _uri, _verb, _params, _headers, _flags, NULL, _deadline);
+    return run(request);
+  }
+
+  Status runCurl() {
+    StandaloneCurlRequest request(_factory.getCurl(), true, _hooks, _uri, _verb, _params, _headers, _flags, NULL, _deadline);
+    return run(request);
+  }
+
+  SessionFactory _factory;
+  BoundHooks _hooks;
+  Uri _uri;
+  std::string _verb;
+  RequestParams _params;
+  std::vector<HeaderLine> _headers;
+  Chrono::TimePoint _deadline;
+  int _flags;
+};
+
+TEST_F(TlsSessionsTest, CurlResumes) {
+  TlsServer server;
+  ASSERT_TRUE(runCurl().ok());
+  ASSERT_TRUE(runCurl().ok());
+  ASSERT_EQ(server.handshakes(), std::vector<bool>({false, true}));
+
+  // nothing to resume for the handles of another factory
+  SessionFactory other;
+  other.getCurl().setSessionCaching(false);
+  StandaloneCurlRequest request(other.getCurl(), true, _hooks, _uri, _verb, _params, _headers, _flags, NULL, _deadline);
+  ASSERT_TRUE(run(request).ok());
+  ASSERT_EQ(server.handshakes(), std::vector<bool>({false, true, false}));
+}
+
+TEST_F(TlsSessionsTest, NeonResumes) {
+  TlsServer server;
+  ASSERT_TRUE(runNeon().ok());
+  ASSERT_TRUE(runNeon().ok());
+  ASSERT_TRUE(runNeon().ok());
+  ASSERT_EQ(server.handshakes(), std::vector<bool>({false, true, true}));
+}
+
+TEST_F(TlsSessionsTest, NeonFailedHandshakeDropsSession) {
+  TlsServer server;
+  ASSERT_TRUE(runNeon().ok());
+  ASSERT_EQ(server.handshakes().size(), 1u);
+
+  struct timespec timeout;
+  timeout.tv_sec = 1;
+  timeout.tv_nsec = 0;
+  _params.setConnectionTimeout(&timeout);
+
+  server.stallNext();
+  ASSERT_FALSE(runNeon().ok());
+
+  // the session of the first connection is not offered again
+  ASSERT_TRUE(runNeon().ok());
+  std::vector<bool> handshakes = server.handshakes();
+  ASSERT_GE(handshakes.size(), 2u);
+  ASSERT_FALSE(handshakes[1]);
+}
+
+TEST_F(TlsSessionsTest, NeonClientCertSessionsNotShared) {
+  TlsServer server;
+  _params.setClientCertFunctionX509([](const SessionInfo &, X509Credential &) { return -1; });
+
+  ASSERT_TRUE(runNeon().ok());
+  ASSERT_TRUE(runNeon().ok());
+  ASSERT_EQ(server.handshakes(), std::vector<bool>({false, false}));
+}
@@ -0,0 +1,125 @@
+#include "test-utils.hpp"
+#include <davix.hpp>
+#include <davix_context_internal.hpp>
+#include <core/HostCapabilities.hpp>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents;
+  for(size_t i = 0; i < size; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+static bool isMultirange(const DrunkRequest &req) {
+  return req.header("range").find(',') != std::string::npos;
+}
+
+class VectorReadTest : public ::testing::Test {
+protected:
+  VectorReadTest() : contents(makeContents(500 * 1000)), inputs(50), outputs(50), buffers(50, std::vector<char>(10)) {
+    for(size_t i = 0; i < inputs.size(); i++) {
+      inputs[i].diov_offset = i * 10000;
+      inputs[i].diov_size = 10;
+      inputs[i].diov_buffer = buffers[i].data();
+    }
+
+    params.setOperationRetry(1);
+  }
+
+  // multi-range requests sent, and the size of their Range headers
+  std::vector<size_t> multirangeHeaders(KeepAliveServer &server) {
+    std::vector<size_t> sizes;
+    std::vector<DrunkRequest> requests = server.requests();
+    for(size_t i = 0; i < requests.size(); i++) {
+      if(isMultirange(requests[i])) {
+        sizes.push_back(requests[i].header("range").size());
+      }
+    }
+    return sizes;
+  }
+
+  void checkBuffers() {
+    for(size_t i = 0; i < buffers.size(); i++) {
+      ASSERT_EQ(std::string(buffers[i].begin(), buffers[i].end()), contents.substr(i * 10000, 10));
+    }
+  }
+
+  std::string contents;
+  std::vector<DavIOVecInput> inputs;
+  std::vector<DavIOVecOuput> outputs;
+  std::vector<std::vector<char> > buffers;
+  RequestParams params;
+};
+
+TEST_F(VectorReadTest, UnrelatedBadRequest) {
+  KeepAliveServer server([this](const DrunkRequest &req) {
+    if(isMultirange(req)) {
+      return std::string("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n");
+    }
+    return serveContents(req, contents, "");
+  });
+
+  Context context;
+  DavFile file(context, Uri("http://localhost:22222/file"));
+  DavixError* err = NULL;
+  ASSERT_LT(file.readPartialBufferVec(&params, inputs.data(), outputs.data(), inputs.size(), &err), 0);
+  ASSERT_TRUE(err != NULL);
+  DavixError::clearError(&err);
+
+  // a single retry, with the smallest header
+  std::vector<size_t> sizes = multirangeHeaders(server);
+  ASSERT_EQ(sizes.size(), 2u);
+  ASSERT_GT(sizes[0], HostCapabilityCache::kMinHeaderSize);
+  ASSERT_LT(sizes[1], 2 * HostCapabilityCache::kMinHeaderSize);
+
+  // and nothing learned from it
+  HostCapabilityCache &capabilities = ContextExplorer::HostCapabilitiesFromContext(context);
+  ASSERT_EQ(capabilities.getMultirange(Uri("http://localhost:22222/file")).maxHeaderSize, HostCapabilityCache::kDefaultMaxHeaderSize);
+}
+
+TEST_F(VectorReadTest, HeaderTooLargeBadRequest) {
+  KeepAliveServer server([this](const DrunkRequest &req) {
+    if(req.header("range").size() > 2 * HostCapabilityCache::kMinHeaderSize) {
+      return std::string("HTTP/1.1 400 Request Header Or Cookie Too Large\r\nContent-Length: 0\r\n\r\n");
+    }
+    return serveContents(req, contents, "", false);
+  });
+
+  Context context;
+  DavFile file(context, Uri("http://localhost:22222/file"));
+  DavixError* err = NULL;
+  ASSERT_GE(file.readPartialBufferVec(&params, inputs.data(), outputs.data(), inputs.size(), &err), 0);
+  ASSERT_TRUE(err == NULL);
+  checkBuffers();
+
+  // the smaller size worked, it is remembered
+  HostCapabilityCache &capabilities = ContextExplorer::HostCapabilitiesFromContext(context);
+  ASSERT_EQ(capabilities.getMultirange(Uri("http://localhost:22222/file")).maxHeaderSize, HostCapabilityCache::kMinHeaderSize);
+}
+
+TEST_F(VectorReadTest, HeaderTooLarge) {
+  KeepAliveServer server([this](const DrunkRequest &req) {
+    if(req.header("range").size() > 600) {
+      return std::string("HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\n\r\n");
+    }
+    return serveContents(req, contents, "", false);
+  });
+
+  Context context;
+  DavFile file(context, Uri("http://localhost:22222/file"));
+  DavixError* err = NULL;
+  ASSERT_GE(file.readPartialBufferVec(&params, inputs.data(), outputs.data(), inputs.size(), &err), 0);
+  ASSERT_TRUE(err == NULL);
+  checkBuffers();
+
+  // halved until accepted
+  std::vector<size_t> sizes = multirangeHeaders(server);
+  ASSERT_GE(sizes.size(), 2u);
+  ASSERT_LE(sizes.back(), 600u);
+
+  HostCapabilityCache &capabilities = ContextExplorer::HostCapabilitiesFromContext(context);
+  ASSERT_LE(capabilities.getMultirange(Uri("http://localhost:22222/file")).maxHeaderSize, 600u);
+}
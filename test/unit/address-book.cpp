@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <core/AddressBook.hpp>
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace Davix;
+
+static AddressBook::Resolver fakeResolver(const std::map<std::string, std::vector<std::string> > &hosts) {
+  return [hosts](const std::string &host) {
+    std::map<std::string, std::vector<std::string> >::const_iterator it = hosts.find(host);
+    return (it == hosts.end()) ? std::vector<std::string>() : it->second;
+  };
+}
+
+static const std::vector<std::string> kFrontends = { "10.0.0.1", "10.0.0.2", "10.0.0.3" };
+
+TEST(AddressBook, SpreadOverAddresses) {
+  AddressBook book(true, std::chrono::seconds(60), fakeResolver({ {"eos.example.org", kFrontends} }));
+
+  std::map<std::string, int> first;
+  for(int i = 0; i < 30; i++) {
+    std::vector<std::string> addresses = book.getAddresses("eos.example.org", 443);
+    ASSERT_EQ(addresses.size(), 3u);
+    ASSERT_EQ(std::set<std::string>(addresses.begin(), addresses.end()).size(), 3u);
+    first[addresses[0]]++;
+  }
+
+  ASSERT_EQ(first.size(), 3u);
+  ASSERT_EQ(first["10.0.0.1"], 10);
+  ASSERT_EQ(first["10.0.0.2"], 10);
+  ASSERT_EQ(first["10.0.0.3"], 10);
+}
+
+TEST(AddressBook, NothingToBalance) {
+  AddressBook book(true, std::chrono::seconds(60), fakeResolver({ {"single.example.org", {"10.0.0.1"}} }));
+  ASSERT_TRUE(book.getAddresses("single.example.org", 443).empty());
+  ASSERT_TRUE(book.getAddresses("unknown.example.org", 443).empty());
+
+  AddressBook inactive(false, std::chrono::seconds(60), fakeResolver({ {"eos.example.org", kFrontends} }));
+  ASSERT_TRUE(inactive.getAddresses("eos.example.org", 443).empty());
+}
+
+TEST(AddressBook, FailedAddressGoesLast) {
+  AddressBook book(true, std::chrono::seconds(60), fakeResolver({ {"eos.example.org", kFrontends} }));
+  book.getAddresses("eos.example.org", 443);
+  book.reportFailure("eos.example.org", 443, "10.0.0.2");
+
+  for(int i = 0; i < 10; i++) {
+    std::vector<std::string> addresses = book.getAddresses("eos.example.org", 443);
+    ASSERT_EQ(addresses.size(), 3u);
+    ASSERT_EQ(addresses.back(), "10.0.0.2");
+  }
+
+  // other ports of the same host are other endpoints
+  ASSERT_EQ(book.getAddresses("eos.example.org", 80).size(), 3u);
+
+  // a successful connection brings it back
+  book.reportSuccess("eos.example.org", 443, "10.0.0.2", std::chrono::microseconds(500));
+  std::set<std::string> first;
+  for(int i = 0; i < 10; i++) {
+    first.insert(book.getAddresses("eos.example.org", 443)[0]);
+  }
+  ASSERT_EQ(first.count("10.0.0.2"), 1u);
+}
+
+TEST(AddressBook, SlowAddressOnlyForFailover) {
+  AddressBook book(true, std::chrono::seconds(60), fakeResolver({ {"eos.example.org", kFrontends} }));
+  book.getAddresses("eos.example.org", 443);
+  book.reportSuccess("eos.example.org", 443, "10.0.0.1", std::chrono::microseconds(2000));
+  book.reportSuccess("eos.example.org", 443, "10.0.0.2", std::chrono::microseconds(2500));
+  book.reportSuccess("eos.example.org", 443, "10.0.0.3", std::chrono::microseconds(80000));
+
+  for(int i = 0; i < 10; i++) {
+    std::vector<std::string> addresses = book.getAddresses("eos.example.org", 443);
+    ASSERT_EQ(addresses.size(), 3u);
+    ASSERT_NE(addresses[0], "10.0.0.3");
+    ASSERT_EQ(addresses[2], "10.0.0.3");
+  }
+}
+
+TEST(AddressBook, AlternateFamilies) {
+  AddressBook book(true, std::chrono::seconds(60), fakeResolver({ {"dual.example.org",
+    {"2001:db8::1", "2001:db8::2", "10.0.0.1", "10.0.0.2"}} }));
+
+  for(int i = 0; i < 4; i++) {
+    std::vector<std::string> addresses = book.getAddresses("dual.example.org", 443);
+    ASSERT_EQ(addresses.size(), 4u);
+
+    for(size_t j = 1; j < addresses.size(); j++) {
+      const bool ipv6 = (addresses[j].find(':') != std::string::npos);
+      const bool previous = (addresses[j-1].find(':') != std::string::npos);
+      ASSERT_NE(ipv6, previous);
+    }
+  }
+}
+
+TEST(AddressBook, Expiry) {
+  std::mutex mtx;
+  std::vector<std::string> records = kFrontends;
+  AddressBook book(true, std::chrono::seconds(0), [&](const std::string &) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return records;
+  });
+  ASSERT_EQ(book.getAddresses("eos.example.org", 443).size(), 3u);
+
+  // new records are picked up once the previous ones expired, with what is
+  // known about the addresses still there
+  book.reportFailure("eos.example.org", 443, "10.0.0.3");
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    records.push_back("10.0.0.4");
+  }
+
+  std::vector<std::string> addresses = book.getAddresses("eos.example.org", 443);
+  for(int i = 0; i < 500 && addresses.size() != 4u; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    addresses = book.getAddresses("eos.example.org", 443);
+  }
+
+  ASSERT_EQ(addresses.size(), 4u);
+  ASSERT_EQ(addresses.back(), "10.0.0.3");
+}
+
+TEST(AddressBook, RefreshInBackground) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> resolutions(0);
+
+  AddressBook book(true, std::chrono::seconds(0), [&](const std::string &) {
+    // every resolution after the first one hangs until released
+    if(resolutions++ > 0) {
+      released.wait_for(std::chrono::seconds(10));
+    }
+    return kFrontends;
+  });
+  ASSERT_EQ(book.getAddresses("eos.example.org", 443).size(), 3u);
+
+  // expired addresses are still handed out, a single refresh is underway
+  for(int i = 0; i < 10; i++) {
+    ASSERT_EQ(book.getAddresses("eos.example.org", 443).size(), 3u);
+  }
+  ASSERT_LE(resolutions, 2);
+
+  release.set_value();
+}
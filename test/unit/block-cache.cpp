@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <core/BlockCache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace Davix;
+
+static BlockCache::Loader makeLoader(size_t size, char fill, std::atomic<int> &calls) {
+  return [size, fill, &calls]() {
+    calls++;
+    return BlockCache::Block(new std::vector<char>(size, fill));
+  };
+}
+
+TEST(BlockCache, Hits) {
+  BlockCache cache(1024, 100);
+  std::atomic<int> calls(0);
+
+  BlockCache::Block a = cache.get("file\n0", makeLoader(100, 'a', calls));
+  BlockCache::Block b = cache.get("file\n0", makeLoader(100, 'b', calls));
+
+  ASSERT_EQ(calls, 1);
+  ASSERT_EQ(a, b);
+  ASSERT_EQ((*b)[0], 'a');
+  ASSERT_EQ(cache.getUsage(), 100u);
+  ASSERT_EQ(cache.getStats().hits, 1u);
+  ASSERT_EQ(cache.getStats().misses, 1u);
+}
+
+TEST(BlockCache, EvictLeastRecentlyUsed) {
+  BlockCache cache(300, 100);
+  std::atomic<int> calls(0);
+
+  cache.get("a", makeLoader(100, 'a', calls));
+  cache.get("b", makeLoader(100, 'b', calls));
+  cache.get("c", makeLoader(100, 'c', calls));
+  cache.get("a", makeLoader(100, 'a', calls)); // a is now the most recent
+  cache.get("d", makeLoader(100, 'd', calls)); // b goes away
+  ASSERT_EQ(calls, 4);
+  ASSERT_LE(cache.getUsage(), 300u);
+  ASSERT_EQ(cache.getStats().evictions, 1u);
+
+  cache.get("a", makeLoader(100, 'a', calls));
+  cache.get("c", makeLoader(100, 'c', calls));
+  ASSERT_EQ(calls, 4);
+
+  cache.get("b", makeLoader(100, 'b', calls));
+  ASSERT_EQ(calls, 5);
+
+  cache.setBudget(100);
+  ASSERT_LE(cache.getUsage(), 100u);
+}
+
+TEST(BlockCache, CoalesceMisses) {
+  BlockCache cache(1024, 100);
+  std::atomic<int> calls(0);
+
+  BlockCache::Loader slow = [&calls]() {
+    calls++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return BlockCache::Block(new std::vector<char>(100, 'x'));
+  };
+
+  std::vector<std::thread> threads;
+  std::vector<BlockCache::Block> results(8);
+  for(size_t i = 0; i < results.size(); i++) {
+    threads.emplace_back([&, i]() { results[i] = cache.get("key", slow); });
+  }
+  for(size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  ASSERT_EQ(calls, 1);
+  for(size_t i = 0; i < results.size(); i++) {
+    ASSERT_EQ(results[i], results[0]);
+  }
+  ASSERT_EQ(cache.getStats().misses, 1u);
+  ASSERT_EQ(cache.getStats().hits + cache.getStats().coalesced, 7u);
+}
+
+TEST(BlockCache, LoaderFailure) {
+  BlockCache cache(1024, 100);
+  std::atomic<int> calls(0);
+
+  ASSERT_THROW(cache.get("key", []() -> BlockCache::Block { throw std::runtime_error("no luck"); }), std::runtime_error);
+  ASSERT_EQ(cache.getUsage(), 0u);
+
+  // failures are not cached
+  cache.get("key", makeLoader(10, 'a', calls));
+  ASSERT_EQ(calls, 1);
+}
+
+TEST(BlockCache, InvalidatePrefix) {
+  BlockCache cache(1024, 100);
+  std::atomic<int> calls(0);
+
+  cache.get("http://a/f1\netag\n0", makeLoader(100, 'a', calls));
+  cache.get("http://a/f1\netag\n1", makeLoader(100, 'a', calls));
+  cache.get("http://a/f2\netag\n0", makeLoader(100, 'a', calls));
+
+  ASSERT_TRUE(cache.containsPrefix("http://a/f1\n"));
+  cache.invalidatePrefix("http://a/f1\n");
+  ASSERT_FALSE(cache.containsPrefix("http://a/f1\n"));
+  ASSERT_TRUE(cache.containsPrefix("http://a/f2\n"));
+  ASSERT_EQ(cache.getUsage(), 100u);
+
+  cache.invalidatePrefix("");
+  ASSERT_EQ(cache.getUsage(), 0u);
+}
+
+TEST(BlockCache, Disabled) {
+  BlockCache cache(0, 100);
+  std::atomic<int> calls(0);
+  ASSERT_FALSE(cache.isEnabled());
+
+  cache.get("key", makeLoader(100, 'a', calls));
+  cache.get("key", makeLoader(100, 'a', calls));
+  ASSERT_EQ(calls, 2);
+  ASSERT_EQ(cache.getUsage(), 0u);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <core/ContentProvider.hpp>
+#include <core/Executor.hpp>
+#include <fileops/ChunkedUpload.hpp>
+#include <davix.hpp>
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents;
+  for(size_t i = 0; i < size; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+class ChunkRecorder {
+public:
+  ChunkRecorder() : inflight(0), maxInflight(0) {}
+
+  void write(const char* buff, dav_size_t size, size_t index) {
+    size_t now = ++inflight;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      maxInflight = std::max(maxInflight, now);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      chunks[index] = std::string(buff, size);
+    }
+    inflight--;
+  }
+
+  std::string reassemble() {
+    std::string retval;
+    size_t expected = 0;
+    for(auto it = chunks.begin(); it != chunks.end(); it++) {
+      EXPECT_EQ(it->first, expected++);
+      retval += it->second;
+    }
+    return retval;
+  }
+
+  std::mutex mtx;
+  std::map<size_t, std::string> chunks;
+  std::atomic<size_t> inflight;
+  size_t maxInflight;
+};
+
+TEST(ChunkedUploader, BasicSanity) {
+  Executor executor(4);
+  std::string contents = makeContents(1000);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  ChunkRecorder recorder;
+  ChunkedUploader uploader(executor, 64, 4);
+  size_t nchunks = uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    recorder.write(buff, size, index);
+  });
+
+  ASSERT_EQ(nchunks, 16u);
+  ASSERT_EQ(recorder.chunks.size(), 16u);
+  ASSERT_EQ(recorder.chunks[15].size(), 1000u - 15 * 64);
+  ASSERT_EQ(recorder.reassemble(), contents);
+  ASSERT_LE(recorder.maxInflight, 4u);
+  ASSERT_GT(recorder.maxInflight, 1u);
+}
+
+TEST(ChunkedUploader, ExactMultipleAndEmpty) {
+  Executor executor(2);
+  std::string contents = makeContents(256);
+
+  BufferContentProvider provider(contents.c_str(), contents.size());
+  ChunkRecorder recorder;
+  ChunkedUploader uploader(executor, 64, 2);
+  ASSERT_EQ(uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    recorder.write(buff, size, index);
+  }), 4u);
+  ASSERT_EQ(recorder.reassemble(), contents);
+
+  BufferContentProvider empty(contents.c_str(), 0);
+  ASSERT_EQ(uploader.run(empty, [&](const char*, dav_size_t, size_t) {
+    FAIL();
+  }), 0u);
+}
+
+TEST(ChunkedUploader, Sequential) {
+  Executor executor(4);
+  std::string contents = makeContents(500);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  ChunkRecorder recorder;
+  ChunkedUploader uploader(executor, 100, 1);
+  ASSERT_EQ(uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    recorder.write(buff, size, index);
+  }), 5u);
+
+  ASSERT_EQ(recorder.reassemble(), contents);
+  ASSERT_EQ(recorder.maxInflight, 1u);
+}
+
+TEST(ChunkedUploader, BusyExecutor) {
+  // a saturated executor must not prevent the upload from completing
+  Executor executor(1);
+  std::promise<void> release;
+  std::shared_future<void> released(release.get_future());
+  executor.submit([released]() { released.wait(); });
+
+  std::string contents = makeContents(1000);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  ChunkRecorder recorder;
+  ChunkedUploader uploader(executor, 100, 4);
+  ASSERT_EQ(uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    recorder.write(buff, size, index);
+  }), 10u);
+
+  ASSERT_EQ(recorder.reassemble(), contents);
+  release.set_value();
+}
+
+TEST(ChunkedUploader, Failure) {
+  Executor executor(4);
+  std::string contents = makeContents(1000);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  std::atomic<size_t> attempts(0);
+  ChunkedUploader uploader(executor, 10, 4);
+
+  try {
+    uploader.run(provider, [&](const char*, dav_size_t, size_t index) {
+      attempts++;
+      if(index == 3) {
+        throw DavixException("test", StatusCode::ConnectionProblem, "chunk failed");
+      }
+    });
+    FAIL();
+  }
+  catch(DavixException &e) {
+    ASSERT_EQ(e.code(), StatusCode::ConnectionProblem);
+  }
+
+  // uploads stop shortly after the failure
+  ASSERT_LT(attempts, 100u);
+}
+
+TEST(ChunkedUploader, RetryChunk) {
+  Executor executor(4);
+  std::string contents = makeContents(1000);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  std::mutex mtx;
+  std::map<size_t, size_t> attempts;
+
+  ChunkRecorder recorder;
+  ChunkedUploader uploader(executor, 100, 4);
+  uploader.setRetryPolicy(3, 0);
+
+  // every other chunk fails twice, then goes through from the same buffer
+  ASSERT_EQ(uploader.run(provider, [&](const char* buff, dav_size_t size, size_t index) {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if(index % 2 == 0 && ++attempts[index] < 3) {
+        throw DavixException("test", StatusCode::ConnectionProblem, "transient failure");
+      }
+    }
+    recorder.write(buff, size, index);
+  }), 10u);
+
+  ASSERT_EQ(recorder.reassemble(), contents);
+  ASSERT_EQ(attempts.size(), 5u);
+  ASSERT_EQ(attempts[4], 3u);
+}
+
+TEST(ChunkedUploader, RetryExhausted) {
+  Executor executor(4);
+  std::string contents = makeContents(1000);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  std::atomic<size_t> attempts(0);
+  ChunkedUploader uploader(executor, 1000, 4);
+  uploader.setRetryPolicy(3, 0);
+
+  ASSERT_THROW(uploader.run(provider, [&](const char*, dav_size_t, size_t) {
+    attempts++;
+    throw DavixException("test", StatusCode::ConnectionProblem, "persistent failure");
+  }), DavixException);
+  ASSERT_EQ(attempts, 3u);
+
+  // permission errors are final
+  provider.rewind();
+  attempts = 0;
+  ASSERT_THROW(uploader.run(provider, [&](const char*, dav_size_t, size_t) {
+    attempts++;
+    throw DavixException("test", StatusCode::PermissionRefused, "denied");
+  }), DavixException);
+  ASSERT_EQ(attempts, 1u);
+}
@@ -17,6 +17,26 @@ TEST(ContextTest, CreateDelete){
 
 }
 
+TEST(ContextTest, Prewarm){
+    Davix::Context c;
+    Davix::Uri uri("http://127.0.0.1:1/file");
+    Davix::DavixError* err = NULL;
+
+    ASSERT_EQ(c.prewarm(uri, 0, NULL, &err), 0);
+    ASSERT_TRUE(err == NULL);
+
+    // nothing listens there
+    ASSERT_EQ(c.prewarm(uri, 4, NULL, &err), -1);
+    ASSERT_TRUE(err != NULL);
+    Davix::DavixError::clearError(&err);
+
+    Davix::RequestParams params;
+    params.setKeepAlive(false);
+    ASSERT_EQ(c.prewarm(uri, 4, &params, &err), -1);
+    ASSERT_EQ(err->getStatus(), Davix::StatusCode::InvalidArgument);
+    Davix::DavixError::clearError(&err);
+}
+
 
 
 
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <core/DiskCache.hpp>
+
+#include <cstdlib>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace Davix;
+
+class DiskCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/davix-disk-cache-XXXXXX";
+    ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+    directory = tmpl;
+  }
+
+  void TearDown() override {
+    DIR* dir = opendir(directory.c_str());
+    struct dirent* entry;
+    while(dir != NULL && (entry = readdir(dir)) != NULL) {
+      unlink((directory + "/" + entry->d_name).c_str());
+    }
+    if(dir != NULL) {
+      closedir(dir);
+    }
+    rmdir(directory.c_str());
+  }
+
+  std::string directory;
+};
+
+static std::vector<char> makeBlock(size_t size, char fill) {
+  return std::vector<char>(size, fill);
+}
+
+TEST_F(DiskCacheTest, StoreLoad) {
+  DiskCache cache(directory, 1024 * 1024);
+  ASSERT_TRUE(cache.isEnabled());
+  ASSERT_FALSE(cache.load("key"));
+
+  cache.store("key", makeBlock(1000, 'a'));
+  BlockCache::Block block = cache.load("key");
+  ASSERT_TRUE(block.get() != NULL);
+  ASSERT_EQ(*block, makeBlock(1000, 'a'));
+  ASSERT_GE(cache.getUsage(), 1000u);
+
+  // overwrite
+  cache.store("key", makeBlock(10, 'b'));
+  ASSERT_EQ(*cache.load("key"), makeBlock(10, 'b'));
+  ASSERT_LT(cache.getUsage(), 1000u);
+
+  ASSERT_FALSE(cache.load("other"));
+}
+
+TEST_F(DiskCacheTest, SharedDirectory) {
+  DiskCache first(directory, 1024 * 1024);
+  DiskCache second(directory, 1024 * 1024);
+
+  first.store("key", makeBlock(100, 'a'));
+  ASSERT_EQ(*second.load("key"), makeBlock(100, 'a'));
+  ASSERT_EQ(first.getUsage(), second.getUsage());
+}
+
+TEST_F(DiskCacheTest, SharedAcrossProcesses) {
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if(pid == 0) {
+    DiskCache cache(directory, 1024 * 1024);
+    cache.store("key", makeBlock(100, 'c'));
+    _exit(0);
+  }
+
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+
+  DiskCache cache(directory, 1024 * 1024);
+  BlockCache::Block block = cache.load("key");
+  ASSERT_TRUE(block.get() != NULL);
+  ASSERT_EQ(*block, makeBlock(100, 'c'));
+}
+
+TEST_F(DiskCacheTest, EvictLeastRecentlyUsed) {
+  DiskCache cache(directory, 10 * 1100);
+
+  for(int i = 0; i < 10; i++) {
+    cache.store("key" + std::to_string(i), makeBlock(1000, 'a' + i));
+  }
+  ASSERT_TRUE(cache.load("key0").get() != NULL); // now the most recent
+
+  for(int i = 10; i < 30; i++) {
+    cache.store("key" + std::to_string(i), makeBlock(1000, 'a'));
+    ASSERT_LE(cache.getUsage(), 10u * 1100);
+  }
+
+  ASSERT_FALSE(cache.load("key1"));
+  ASSERT_TRUE(cache.load("key29").get() != NULL);
+}
+
+TEST_F(DiskCacheTest, Disabled) {
+  DiskCache cache("", 1024 * 1024);
+  ASSERT_FALSE(cache.isEnabled());
+  cache.store("key", makeBlock(100, 'a'));
+  ASSERT_FALSE(cache.load("key"));
+
+  cache.configure(directory, 1024 * 1024);
+  ASSERT_TRUE(cache.isEnabled());
+  cache.store("key", makeBlock(100, 'a'));
+  ASSERT_TRUE(cache.load("key").get() != NULL);
+}
+
+TEST_F(DiskCacheTest, PrivateFiles) {
+  chmod(directory.c_str(), 0755);
+  rmdir(directory.c_str());
+
+  DiskCache cache(directory, 1024 * 1024);
+  ASSERT_TRUE(cache.isEnabled());
+  cache.store("key", makeBlock(100, 'a'));
+
+  struct stat st;
+  ASSERT_EQ(stat(directory.c_str(), &st), 0);
+  ASSERT_EQ(st.st_mode & 0777, 0700u);
+
+  DIR* dir = opendir(directory.c_str());
+  ASSERT_TRUE(dir != NULL);
+  int files = 0;
+  struct dirent* entry;
+  while((entry = readdir(dir)) != NULL) {
+    if(entry->d_name[0] == '.') {
+      continue;
+    }
+    ASSERT_EQ(stat((directory + "/" + entry->d_name).c_str(), &st), 0);
+    ASSERT_EQ(st.st_mode & 0777, 0600u) << entry->d_name;
+    files++;
+  }
+  closedir(dir);
+  ASSERT_EQ(files, 2);
+}
+
+TEST_F(DiskCacheTest, RefuseWritableByOthers) {
+  ASSERT_EQ(chmod(directory.c_str(), 0777), 0);
+  DiskCache cache(directory, 1024 * 1024);
+  ASSERT_FALSE(cache.isEnabled());
+
+  ASSERT_EQ(chmod(directory.c_str(), 0700), 0);
+  cache.configure(directory, 1024 * 1024);
+  ASSERT_TRUE(cache.isEnabled());
+}
+
+TEST_F(DiskCacheTest, RemoveStaleTemporaryFiles) {
+  {
+    DiskCache cache(directory, 1024 * 1024);
+    cache.store("key", makeBlock(100, 'a'));
+  }
+
+  // left behind by stores which never completed, a long time ago or just now
+  const std::string stale = directory + "/0000000000000001.blk.tmp.1.0";
+  const std::string recent = directory + "/0000000000000002.blk.tmp.1.1";
+  ASSERT_EQ(close(open(stale.c_str(), O_WRONLY | O_CREAT, 0600)), 0);
+  ASSERT_EQ(close(open(recent.c_str(), O_WRONLY | O_CREAT, 0600)), 0);
+
+  struct timeval old[2] = { {time(NULL) - 7200, 0}, {time(NULL) - 7200, 0} };
+  ASSERT_EQ(utimes(stale.c_str(), old), 0);
+
+  DiskCache cache(directory, 1024 * 1024);
+  ASSERT_TRUE(cache.isEnabled());
+  ASSERT_NE(access(stale.c_str(), F_OK), 0);
+  ASSERT_EQ(access(recent.c_str(), F_OK), 0);
+  ASSERT_EQ(*cache.load("key"), makeBlock(100, 'a'));
+}
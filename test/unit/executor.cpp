@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <core/Executor.hpp>
+#include <davix.hpp>
+#include <davix_context_internal.hpp>
+
+#include <atomic>
+#include <future>
+
+using namespace Davix;
+
+TEST(Executor, RunsEverything) {
+  std::atomic<int> counter(0);
+
+  {
+    Executor executor(4);
+    ASSERT_EQ(executor.getThreadCount(), 0u);
+
+    for(int i = 0; i < 1000; i++) {
+      executor.submit([&counter]() { counter++; });
+    }
+
+    ASSERT_LE(executor.getThreadCount(), 4u);
+  }
+
+  ASSERT_EQ(counter, 1000);
+}
+
+TEST(Executor, ConcurrentTasks) {
+  // outlive the executor, whose workers use them until joined
+  std::promise<void> first;
+  std::promise<void> second;
+  std::shared_future<void> firstDone = first.get_future().share();
+  std::shared_future<void> secondDone = second.get_future().share();
+
+  Executor executor(2);
+
+  // both tasks must run at the same time to finish in time
+  executor.submit([&]() { first.set_value(); secondDone.wait_for(std::chrono::seconds(10)); });
+  executor.submit([&]() { firstDone.wait_for(std::chrono::seconds(10)); second.set_value(); });
+
+  ASSERT_EQ(firstDone.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(secondDone.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
+
+TEST(Executor, AsyncRequestFailure) {
+  Context context;
+  DavixError* err = NULL;
+
+  HttpRequest req(context, "http://localhost:1/nothing-here", &err);
+  ASSERT_TRUE(err == NULL);
+
+  std::future<int> result = req.executeRequestAsync();
+  ASSERT_THROW(result.get(), DavixException);
+  ASSERT_EQ(ContextExplorer::ExecutorFromContext(context).getThreadCount(), 1u);
+}
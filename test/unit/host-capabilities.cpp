@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <core/HostCapabilities.hpp>
+
+#include <sstream>
+#include <thread>
+
+using namespace Davix;
+
+TEST(HostCapabilities, Defaults) {
+  HostCapabilityCache cache(std::chrono::seconds(60));
+
+  MultirangeCapabilities caps = cache.getMultirange(Uri("https://example.org/file"));
+  ASSERT_EQ(caps.multirange, MultirangeCapabilities::Unknown);
+  ASSERT_EQ(caps.maxHeaderSize, HostCapabilityCache::kDefaultMaxHeaderSize);
+  ASSERT_EQ(caps.mergeWindow, HostCapabilityCache::kMultirangeMergeWindow);
+  ASSERT_EQ(cache.size(), 0u);
+}
+
+TEST(HostCapabilities, PerHost) {
+  HostCapabilityCache cache(std::chrono::seconds(60));
+
+  cache.setMultirangeSupport(Uri("https://s3.example.org/bucket/a"), false);
+  cache.setMultirangeSupport(Uri("https://dav.example.org/b"), true);
+
+  // same host, different path
+  MultirangeCapabilities caps = cache.getMultirange(Uri("https://s3.example.org/bucket/c"));
+  ASSERT_EQ(caps.multirange, MultirangeCapabilities::Unsupported);
+  ASSERT_EQ(caps.mergeWindow, HostCapabilityCache::kSingleRangeMergeWindow);
+
+  caps = cache.getMultirange(Uri("https://dav.example.org/d"));
+  ASSERT_EQ(caps.multirange, MultirangeCapabilities::Supported);
+  ASSERT_EQ(caps.mergeWindow, HostCapabilityCache::kMultirangeMergeWindow);
+
+  // different port or scheme is a different server
+  caps = cache.getMultirange(Uri("https://s3.example.org:8443/bucket/a"));
+  ASSERT_EQ(caps.multirange, MultirangeCapabilities::Unknown);
+  caps = cache.getMultirange(Uri("http://s3.example.org/bucket/a"));
+  ASSERT_EQ(caps.multirange, MultirangeCapabilities::Unknown);
+
+  ASSERT_EQ(cache.size(), 2u);
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0u);
+}
+
+TEST(HostCapabilities, MaxHeaderSize) {
+  HostCapabilityCache cache(std::chrono::seconds(60));
+  Uri uri("https://example.org/file");
+
+  cache.setMaxHeaderSize(uri, 1000);
+  ASSERT_EQ(cache.getMultirange(uri).maxHeaderSize, 1000u);
+
+  // never raised again, never below the minimum
+  cache.setMaxHeaderSize(uri, 2000);
+  ASSERT_EQ(cache.getMultirange(uri).maxHeaderSize, 1000u);
+  cache.setMaxHeaderSize(uri, 1);
+  ASSERT_EQ(cache.getMultirange(uri).maxHeaderSize, HostCapabilityCache::kMinHeaderSize);
+
+  // learning about multi-range support keeps the header size
+  cache.setMultirangeSupport(uri, true);
+  ASSERT_EQ(cache.getMultirange(uri).maxHeaderSize, HostCapabilityCache::kMinHeaderSize);
+}
+
+TEST(HostCapabilities, Expiry) {
+  HostCapabilityCache cache(std::chrono::seconds(1));
+  Uri uri("https://example.org/file");
+
+  cache.setMultirangeSupport(uri, false);
+  ASSERT_EQ(cache.getMultirange(uri).multirange, MultirangeCapabilities::Unsupported);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_EQ(cache.getMultirange(uri).multirange, MultirangeCapabilities::Unknown);
+}
+
+TEST(HostCapabilities, Disabled) {
+  HostCapabilityCache cache(std::chrono::seconds(0));
+  Uri uri("https://example.org/file");
+
+  cache.setMultirangeSupport(uri, false);
+  cache.setMaxHeaderSize(uri, 1000);
+  ASSERT_EQ(cache.size(), 0u);
+  ASSERT_EQ(cache.getMultirange(uri).multirange, MultirangeCapabilities::Unknown);
+}
+
+TEST(HostCapabilities, Bounded) {
+  HostCapabilityCache cache(std::chrono::seconds(60), 4);
+
+  for(int i = 0; i < 10; i++) {
+    cache.setMultirangeSupport(Uri("https://host" + std::to_string(i) + ".example.org/"), false);
+  }
+
+  ASSERT_EQ(cache.size(), 4u);
+  ASSERT_EQ(cache.getMultirange(Uri("https://host9.example.org/")).multirange, MultirangeCapabilities::Unsupported);
+}
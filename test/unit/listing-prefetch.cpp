@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <core/Executor.hpp>
+#include <fileops/ListingPrefetch.hpp>
+#include <davix.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace Davix;
+
+// listing of npages pages of 3 entries, markers are the page numbers
+static ListingPrefetcher::PageFetcher makeFetcher(int npages, std::atomic<int> &fetches) {
+  return [npages, &fetches](const std::string &marker, ListingPage &page) {
+    fetches++;
+    const int index = atoi(marker.c_str());
+    for(int i = 0; i < 3; i++) {
+      FileProperties prop;
+      prop.filename = "page" + std::to_string(index) + "-" + std::to_string(i);
+      page.entries.push_back(prop);
+    }
+    if(index + 1 < npages) {
+      page.next_marker = std::to_string(index + 1);
+    }
+  };
+}
+
+TEST(ListingPrefetch, AllPages) {
+  Executor executor(2);
+  std::atomic<int> fetches(0);
+  ListingPrefetcher prefetcher(executor, makeFetcher(5, fetches));
+
+  // the first page came from the caller's own request
+  prefetcher.start("1");
+  prefetcher.start("ignored");
+
+  std::deque<FileProperties> entries;
+  for(int page = 1; page < 5; page++) {
+    ASSERT_TRUE(prefetcher.next(entries));
+    ASSERT_EQ(entries.size(), 3u);
+    ASSERT_EQ(entries.front().filename, "page" + std::to_string(page) + "-0");
+    entries.clear();
+  }
+
+  ASSERT_FALSE(prefetcher.next(entries));
+  ASSERT_FALSE(prefetcher.next(entries));
+  ASSERT_EQ(fetches, 4);
+  ASSERT_EQ(prefetcher.getPageCount(), 4u);
+}
+
+TEST(ListingPrefetch, SinglePage) {
+  Executor executor(2);
+  std::atomic<int> fetches(0);
+  ListingPrefetcher prefetcher(executor, makeFetcher(5, fetches));
+
+  std::deque<FileProperties> entries;
+  prefetcher.start("");
+  ASSERT_FALSE(prefetcher.next(entries));
+  ASSERT_EQ(fetches, 0);
+}
+
+// wait for the fetcher to have been called count times
+static void waitForFetches(const std::atomic<int> &fetches, int count) {
+  for(int i = 0; i < 500 && fetches < count; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+TEST(ListingPrefetch, FetchAhead) {
+  Executor executor(2);
+  std::atomic<int> fetches(0);
+  ListingPrefetcher prefetcher(executor, makeFetcher(6, fetches));
+
+  // the next page is requested without waiting for the reader
+  prefetcher.start("1");
+  waitForFetches(fetches, 1);
+  ASSERT_EQ(fetches, 1);
+
+  // each page handed out requests the one after it, one page ahead at most
+  std::deque<FileProperties> entries;
+  for(int page = 1; page < 6; page++) {
+    ASSERT_TRUE(prefetcher.next(entries));
+    ASSERT_EQ(entries.front().filename, "page" + std::to_string(page) + "-0");
+    entries.clear();
+
+    const int expected = std::min(page + 1, 5);
+    waitForFetches(fetches, expected);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(fetches, expected);
+  }
+
+  ASSERT_FALSE(prefetcher.next(entries));
+  ASSERT_EQ(fetches, 5);
+}
+
+TEST(ListingPrefetch, Failure) {
+  Executor executor(2);
+  ListingPrefetcher prefetcher(executor, [](const std::string &marker, ListingPage &page) {
+    (void) marker;
+    (void) page;
+    throw DavixException("test", StatusCode::ConnectionProblem, "connection lost");
+  });
+
+  prefetcher.start("1");
+
+  std::deque<FileProperties> entries;
+  try {
+    prefetcher.next(entries);
+    FAIL();
+  }
+  catch(DavixException &e) {
+    ASSERT_EQ(e.code(), StatusCode::ConnectionProblem);
+    ASSERT_EQ(std::string(e.what()), "connection lost");
+  }
+
+  ASSERT_FALSE(prefetcher.next(entries));
+}
+
+TEST(ListingPrefetch, Destroy) {
+  Executor executor(1);
+  std::atomic<int> fetches(0);
+
+  // keep the only worker busy, the prefetch stays queued
+  executor.submit([]() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+  {
+    ListingPrefetcher prefetcher(executor, makeFetcher(5, fetches));
+    prefetcher.start("1");
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ASSERT_EQ(fetches, 0);
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <fileops/ListingReader.hpp>
+
+using namespace Davix;
+
+TEST(ListingReader, GrowsWithFastAnswers) {
+  ListingReader reader;
+  ASSERT_EQ(reader.getChunkSize(), ListingReader::kMinChunk);
+  ASSERT_FALSE(reader.finished());
+
+  reader.adapt(std::chrono::microseconds(100));
+  ASSERT_EQ(reader.getChunkSize(), 2 * ListingReader::kMinChunk);
+
+  for(int i = 0; i < 20; i++) {
+    reader.adapt(std::chrono::microseconds(100));
+  }
+  ASSERT_EQ(reader.getChunkSize(), ListingReader::kMaxChunk);
+}
+
+TEST(ListingReader, ShrinksWithSlowAnswers) {
+  ListingReader reader;
+  for(int i = 0; i < 4; i++) {
+    reader.adapt(std::chrono::microseconds(100));
+  }
+  ASSERT_EQ(reader.getChunkSize(), 16 * ListingReader::kMinChunk);
+
+  // in between, keep the current size
+  reader.adapt(std::chrono::milliseconds(20));
+  ASSERT_EQ(reader.getChunkSize(), 16 * ListingReader::kMinChunk);
+
+  reader.adapt(std::chrono::milliseconds(200));
+  ASSERT_EQ(reader.getChunkSize(), 8 * ListingReader::kMinChunk);
+
+  for(int i = 0; i < 10; i++) {
+    reader.adapt(std::chrono::seconds(1));
+  }
+  ASSERT_EQ(reader.getChunkSize(), ListingReader::kMinChunk);
+}
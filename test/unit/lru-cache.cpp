@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <libs/alibxx/containers/lru_cache.hpp>
+#include <core/RedirectionResolver.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Davix;
+
+typedef LRUCache<std::string, int> IntCache;
+
+static std::shared_ptr<int> makeInt(int value) {
+  return std::shared_ptr<int>(new int(value));
+}
+
+TEST(LRUCache, InsertFind) {
+  IntCache cache(16);
+  ASSERT_TRUE(cache.find("a").get() == NULL);
+
+  ASSERT_EQ(*cache.insert("a", makeInt(1)), 1);
+  ASSERT_EQ(*cache.find("a"), 1);
+  ASSERT_EQ(cache.getSize(), 1u);
+
+  // replace
+  cache.insert("a", makeInt(2));
+  ASSERT_EQ(*cache.find("a"), 2);
+  ASSERT_EQ(cache.getSize(), 1u);
+
+  ASSERT_EQ(*cache.take("a"), 2);
+  ASSERT_EQ(cache.getSize(), 0u);
+  ASSERT_FALSE(cache.erase("a"));
+
+  cache.insert("b", makeInt(3));
+  ASSERT_TRUE(cache.erase("b"));
+  cache.insert("c", makeInt(4));
+  cache.clear();
+  ASSERT_EQ(cache.getSize(), 0u);
+
+  LRUCacheStats stats = cache.getStats();
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.misses, 1u);
+  ASSERT_EQ(stats.evictions, 0u);
+}
+
+TEST(LRUCache, EvictLeastRecentlyUsed) {
+  // a single shard gives an exact LRU order
+  IntCache cache(3, IntCache::Clock::duration::zero(), 1);
+  cache.insert("a", makeInt(1));
+  cache.insert("b", makeInt(2));
+  cache.insert("c", makeInt(3));
+
+  ASSERT_TRUE(cache.find("a").get() != NULL);
+  cache.insert("d", makeInt(4));
+
+  ASSERT_EQ(cache.getSize(), 3u);
+  ASSERT_TRUE(cache.find("b").get() == NULL);
+  ASSERT_TRUE(cache.find("a").get() != NULL);
+  ASSERT_TRUE(cache.find("c").get() != NULL);
+  ASSERT_TRUE(cache.find("d").get() != NULL);
+  ASSERT_EQ(cache.getStats().evictions, 1u);
+}
+
+TEST(LRUCache, Bounded) {
+  IntCache cache(100);
+  for(int i = 0; i < 10000; i++) {
+    cache.insert(std::to_string(i), makeInt(i));
+  }
+
+  ASSERT_LE(cache.getSize(), cache.getCapacity());
+  ASSERT_GE(cache.getCapacity(), 100u);
+  ASSERT_LT(cache.getCapacity(), 116u);
+  ASSERT_EQ(*cache.find("9999"), 9999);
+}
+
+TEST(LRUCache, Expiry) {
+  IntCache cache(16, std::chrono::milliseconds(50));
+  cache.insert("short", makeInt(1));
+  cache.insert("forever", makeInt(2), IntCache::Clock::duration::zero());
+  ASSERT_TRUE(cache.find("short").get() != NULL);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_TRUE(cache.find("short").get() == NULL);
+  ASSERT_EQ(*cache.find("forever"), 2);
+  ASSERT_EQ(cache.getSize(), 1u);
+  ASSERT_EQ(cache.getStats().expirations, 1u);
+}
+
+TEST(LRUCache, FindKeys) {
+  IntCache cache(16);
+  cache.insert("a1", makeInt(1));
+  cache.insert("a2", makeInt(2));
+  cache.insert("b1", makeInt(3));
+
+  std::vector<std::string> keys = cache.findKeys([](const std::string & key) {
+    return key[0] == 'a';
+  });
+  ASSERT_EQ(keys.size(), 2u);
+}
+
+TEST(LRUCache, Concurrency) {
+  IntCache cache(256);
+  std::vector<std::thread> threads;
+
+  for(int t = 0; t < 8; t++) {
+    threads.emplace_back([&cache, t]() {
+      for(int i = 0; i < 10000; i++) {
+        const std::string key = std::to_string((i * 7 + t) % 512);
+        if(cache.find(key).get() == NULL) {
+          cache.insert(key, makeInt(i));
+        }
+      }
+    });
+  }
+
+  for(size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  LRUCacheStats stats = cache.getStats();
+  ASSERT_EQ(stats.hits + stats.misses, 80000u);
+  ASSERT_LE(cache.getSize(), cache.getCapacity());
+}
+
+TEST(RedirectionResolver, ResolveAndClean) {
+  RedirectionResolver resolver(true, 16, std::chrono::seconds(0));
+  Uri origin("https://example.org/file");
+  Uri middle("https://redirector.example.org/file");
+
+  resolver.addRedirection("GET", origin, std::shared_ptr<Uri>(new Uri(middle)));
+  resolver.addRedirection("GET", middle, std::shared_ptr<Uri>(new Uri("https://disk.example.org/file")));
+  resolver.addRedirection("PUT", origin, std::shared_ptr<Uri>(new Uri("https://disk2.example.org/file")));
+
+  // HEAD and GET share their redirections, chains are followed
+  ASSERT_EQ(resolver.redirectionResolve("HEAD", origin)->getString(), "https://disk.example.org/file");
+  ASSERT_EQ(resolver.redirectionResolve("PUT", origin)->getString(), "https://disk2.example.org/file");
+
+  resolver.redirectionClean(origin);
+  ASSERT_TRUE(resolver.redirectionResolve("GET", origin).get() == NULL);
+  ASSERT_TRUE(resolver.redirectionResolve("GET", middle).get() == NULL);
+  ASSERT_TRUE(resolver.redirectionResolve("PUT", origin).get() == NULL);
+  ASSERT_GT(resolver.getStats().hits, 0u);
+}
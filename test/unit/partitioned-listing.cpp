@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <core/Executor.hpp>
+#include <fileops/PartitionedListing.hpp>
+#include <davix.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace Davix;
+
+// flat bucket answering pages of pageSize keys after the marker
+class FakeBucket {
+public:
+  FakeBucket(const std::set<std::string> &k, size_t p) : keys(k), pageSize(p), requests(0) {}
+
+  PartitionedListing::PageFetcher fetcher() {
+    return [this](const std::string &marker, ListingPage &page) {
+      requests++;
+      std::set<std::string>::const_iterator it = keys.upper_bound(marker);
+      for(size_t i = 0; i < pageSize && it != keys.end(); i++, it++) {
+        FileProperties prop;
+        prop.filename = *it;
+        page.entries.push_back(prop);
+      }
+      if(it != keys.end()) {
+        page.next_marker = page.entries.back().filename;
+      }
+    };
+  }
+
+  std::set<std::string> keys;
+  size_t pageSize;
+  std::atomic<size_t> requests;
+};
+
+static std::vector<std::string> listAll(PartitionedListing &listing) {
+  std::vector<std::string> result;
+  FileProperties entry;
+  while(listing.next(entry)) {
+    result.push_back(entry.filename);
+  }
+  return result;
+}
+
+static void checkListing(const std::set<std::string> &keys, size_t parallelism) {
+  Executor executor(8);
+  FakeBucket bucket(keys, 50);
+  PartitionedListing listing(executor, bucket.fetcher(), parallelism, 1000);
+  listing.waitFirstPage();
+
+  std::vector<std::string> result = listAll(listing);
+  ASSERT_EQ(result, std::vector<std::string>(keys.begin(), keys.end()));
+}
+
+TEST(PartitionedListing, SplitKey) {
+  std::string mid = PartitionedListing::splitKey("", "");
+  ASSERT_FALSE(mid.empty());
+
+  const char* bounds[][2] = {
+    { "", "" }, { "a", "" }, { "a", "b" }, { "data/0001", "data/9999" }, { "abc", "abd" },
+    { "x", "x0" }, { "}", "" }, { "photos/2019", "photos/2020/01" }
+  };
+
+  for(size_t i = 0; i < sizeof(bounds) / sizeof(bounds[0]); i++) {
+    const std::string start = bounds[i][0], end = bounds[i][1];
+    mid = PartitionedListing::splitKey(start, end);
+    ASSERT_FALSE(mid.empty()) << start << " " << end;
+    ASSERT_GT(mid, start);
+    if(!end.empty()) {
+      ASSERT_LT(mid, end);
+    }
+  }
+
+  // nothing in between
+  ASSERT_EQ(PartitionedListing::splitKey("a", "a"), "");
+  ASSERT_EQ(PartitionedListing::splitKey("b", "a"), "");
+  ASSERT_EQ(PartitionedListing::splitKey("\x7f\x7f", ""), "");
+}
+
+TEST(PartitionedListing, Uniform) {
+  std::set<std::string> keys;
+  for(int i = 0; i < 5000; i++) {
+    keys.insert(std::string(1, (char) ('!' + (i * 7919) % 90)) + std::to_string(i));
+  }
+  checkListing(keys, 8);
+}
+
+TEST(PartitionedListing, CommonPrefix) {
+  std::set<std::string> keys;
+  for(int i = 0; i < 5000; i++) {
+    keys.insert("data/run" + std::to_string(1000000 + i * 37) + ".root");
+  }
+  checkListing(keys, 8);
+}
+
+TEST(PartitionedListing, Skewed) {
+  std::set<std::string> keys;
+  for(int i = 0; i < 3000; i++) {
+    keys.insert("logs/2024/" + std::to_string(100000 + i));
+  }
+  for(int i = 0; i < 20; i++) {
+    keys.insert(std::string("a") + std::to_string(i));
+    keys.insert(std::string("z") + std::to_string(i));
+    keys.insert(std::string("\xc3\xa9t\xc3\xa9/") + std::to_string(i)); // UTF-8, beyond ASCII
+  }
+  checkListing(keys, 4);
+}
+
+TEST(PartitionedListing, Small) {
+  checkListing(std::set<std::string>(), 8);
+
+  std::set<std::string> keys;
+  keys.insert("single");
+  checkListing(keys, 8);
+  checkListing(keys, 1);
+}
+
+TEST(PartitionedListing, Concurrency) {
+  std::set<std::string> keys;
+  for(int i = 0; i < 20000; i++) {
+    keys.insert("k" + std::to_string(100000 + i));
+  }
+
+  Executor executor(8);
+  FakeBucket bucket(keys, 100);
+  PartitionedListing listing(executor, bucket.fetcher(), 8, 100000);
+  ASSERT_EQ(listAll(listing).size(), keys.size());
+
+  // the keyspace got split, without an excessive amount of probes
+  ASSERT_GT(listing.getRangeCount(), 1u);
+  ASSERT_EQ(listing.getRequestCount(), bucket.requests);
+  ASSERT_LT(bucket.requests, 2 * keys.size() / bucket.pageSize);
+}
+
+TEST(PartitionedListing, FromBusyExecutor) {
+  std::set<std::string> keys;
+  for(int i = 0; i < 2000; i++) {
+    keys.insert("k" + std::to_string(100000 + i));
+  }
+
+  // a single worker, which is the one listing: every fetch runs on it
+  Executor executor(1);
+  FakeBucket bucket(keys, 100);
+  std::promise<size_t> listed;
+
+  executor.submit([&]() {
+    PartitionedListing listing(executor, bucket.fetcher(), 4, 1000);
+    listing.waitFirstPage();
+    listed.set_value(listAll(listing).size());
+  });
+
+  std::future<size_t> result = listed.get_future();
+  ASSERT_EQ(result.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(result.get(), keys.size());
+}
+
+TEST(PartitionedListing, Failure) {
+  Executor executor(4);
+  PartitionedListing listing(executor, [](const std::string &marker, ListingPage &page) {
+    (void) marker;
+    (void) page;
+    throw DavixException("test", StatusCode::FileNotFound, "no such bucket");
+  }, 4, 1000);
+
+  try {
+    listing.waitFirstPage();
+    FAIL();
+  }
+  catch(DavixException &e) {
+    ASSERT_EQ(e.code(), StatusCode::FileNotFound);
+  }
+
+  FileProperties entry;
+  ASSERT_THROW(listing.next(entry), DavixException);
+}
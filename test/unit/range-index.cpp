@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <fileops/RangeIndex.hpp>
+#include <davix.hpp>
+
+#include <vector>
+
+using namespace Davix;
+
+class RangeVector {
+public:
+  void add(dav_off_t offset, dav_size_t size) {
+    DavIOVecInput elem;
+    elem.diov_offset = offset;
+    elem.diov_size = size;
+    elem.diov_buffer = NULL;
+    in.push_back(elem);
+  }
+
+  // allocate buffers once all ranges are known
+  void prepare() {
+    buffers.resize(in.size());
+    out.resize(in.size());
+    for(size_t i = 0; i < in.size(); i++) {
+      buffers[i].assign(in[i].diov_size, '\0');
+      in[i].diov_buffer = &buffers[i][0];
+    }
+  }
+
+  std::string contents(size_t i) {
+    return std::string(buffers[i].begin(), buffers[i].begin() + out[i].diov_size);
+  }
+
+  std::vector<DavIOVecInput> in;
+  std::vector<DavIOVecOuput> out;
+  std::vector<std::string> buffers;
+};
+
+static std::string makeSource(size_t size) {
+  std::string contents;
+  for(size_t i = 0; i < size; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+TEST(RangeIndex, MergeSorted) {
+  RangeVector v;
+  v.add(0, 10);
+  v.add(14, 6);
+  v.add(100, 10);
+  v.prepare();
+
+  RangeIndex index(v.in.data(), v.out.data(), v.in.size());
+  ASSERT_EQ(index.size(), 3u);
+
+  SortedRanges merged = index.merge(0);
+  ASSERT_EQ(merged.size(), 3u);
+
+  merged = index.merge(5);
+  ASSERT_EQ(merged.size(), 2u);
+  ASSERT_EQ(merged[0].first, 0);
+  ASSERT_EQ(merged[0].second, 19u);
+  ASSERT_EQ(merged[1].first, 100);
+  ASSERT_EQ(merged[1].second, 109u);
+}
+
+TEST(RangeIndex, MergeUnsorted) {
+  RangeVector v;
+  v.add(100, 10);
+  v.add(0, 10);
+  v.add(10, 10);
+  v.prepare();
+
+  // adjacent ranges are only coalesced with a non-zero window
+  RangeIndex index(v.in.data(), v.out.data(), v.in.size());
+  ASSERT_EQ(index.merge(0).size(), 3u);
+
+  SortedRanges merged = index.merge(1);
+  ASSERT_EQ(merged.size(), 2u);
+  ASSERT_EQ(merged[0].first, 0);
+  ASSERT_EQ(merged[0].second, 19u);
+  ASSERT_EQ(merged[1].first, 100);
+}
+
+TEST(RangeIndex, MergeContained) {
+  RangeVector v;
+  v.add(0, 100);
+  v.add(10, 5);
+  v.add(50, 10);
+  v.prepare();
+
+  // the merged range must not shrink to the end of the last contained range
+  RangeIndex index(v.in.data(), v.out.data(), v.in.size());
+  SortedRanges merged = index.merge(0);
+  ASSERT_EQ(merged.size(), 1u);
+  ASSERT_EQ(merged[0].first, 0);
+  ASSERT_EQ(merged[0].second, 99u);
+}
+
+TEST(RangeIndex, ZeroSize) {
+  RangeVector v;
+  v.add(0, 0);
+  v.add(10, 10);
+  v.add(50, 0);
+  v.prepare();
+
+  RangeIndex index(v.in.data(), v.out.data(), v.in.size());
+  ASSERT_EQ(index.size(), 1u);
+  ASSERT_EQ(index.merge(0).size(), 1u);
+
+  std::string source = makeSource(100);
+  RangeIndex::Cursor cursor(index);
+  ASSERT_EQ(cursor.fill(source.c_str(), 0, source.size()), 1u);
+  ASSERT_EQ(v.out[0].diov_size, 0u);
+  ASSERT_EQ(v.out[2].diov_size, 0u);
+  ASSERT_EQ(v.contents(1), source.substr(10, 10));
+}
+
+TEST(RangeIndex, FillPieces) {
+  RangeVector v;
+  v.add(200, 30);
+  v.add(5, 20);
+  v.add(10, 50);    // overlaps the previous one
+  v.add(12, 3);     // contained in both
+  v.add(100, 1);
+  v.prepare();
+
+  std::string source = makeSource(300);
+  RangeIndex index(v.in.data(), v.out.data(), v.in.size());
+  SortedRanges merged = index.merge(0);
+
+  // deliver every merged range in small, increasing pieces
+  RangeIndex::Cursor cursor(index);
+  for(size_t i = 0; i < merged.size(); i++) {
+    for(dav_off_t off = merged[i].first; off <= (dav_off_t) merged[i].second; off += 7) {
+      dav_size_t len = std::min<dav_off_t>(7, merged[i].second - off + 1);
+      ASSERT_GT(cursor.fill(source.c_str() + off, off, len), 0u);
+    }
+  }
+
+  for(size_t i = 0; i < v.in.size(); i++) {
+    ASSERT_EQ(v.out[i].diov_size, v.in[i].diov_size);
+    ASSERT_EQ(v.out[i].diov_buffer, v.in[i].diov_buffer);
+    ASSERT_EQ(v.contents(i), source.substr(v.in[i].diov_offset, v.in[i].diov_size));
+  }
+}
+
+TEST(RangeIndex, FillBackwards) {
+  RangeVector v;
+  v.add(0, 10);
+  v.add(20, 10);
+  v.add(40, 10);
+  v.prepare();
+
+  std::string source = makeSource(100);
+  RangeIndex index(v.in.data(), v.out.data(), v.in.size());
+  RangeIndex::Cursor cursor(index);
+
+  ASSERT_EQ(cursor.fill(source.c_str() + 40, 40, 10), 1u);
+  ASSERT_EQ(cursor.fill(source.c_str() + 20, 20, 10), 1u);
+  ASSERT_EQ(cursor.fill(source.c_str(), 0, 10), 1u);
+  ASSERT_EQ(cursor.fill(source.c_str() + 30, 30, 10), 0u);
+
+  for(size_t i = 0; i < v.in.size(); i++) {
+    ASSERT_EQ(v.contents(i), source.substr(v.in[i].diov_offset, v.in[i].diov_size));
+  }
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <core/Executor.hpp>
+#include <fileops/ReadAhead.hpp>
+#include <davix.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents;
+  for(size_t i = 0; i < size; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+static std::string readAll(ReadAheadWindow &window, dav_off_t start, size_t chunk) {
+  std::string result;
+  std::vector<char> buffer(chunk);
+
+  dav_ssize_t ret;
+  while((ret = window.read(start + result.size(), buffer.data(), chunk)) > 0) {
+    result.append(buffer.data(), ret);
+  }
+  EXPECT_EQ(ret, 0);
+  return result;
+}
+
+TEST(ReadAhead, Sequential) {
+  Executor executor(4);
+  std::string contents = makeContents(10000);
+  std::atomic<size_t> fetches(0);
+
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    fetches++;
+    memcpy(buffer, contents.data() + offset, size);
+  };
+
+  ReadAheadWindow window(executor, fetcher, 0, contents.size(), 999, 4);
+  ASSERT_EQ(readAll(window, 0, 77), contents);
+  ASSERT_EQ(fetches, 11u);
+
+  // past the end
+  char c;
+  ASSERT_EQ(window.read(contents.size(), &c, 1), 0);
+}
+
+TEST(ReadAhead, Offset) {
+  Executor executor(4);
+  std::string contents = makeContents(10000);
+
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    memcpy(buffer, contents.data() + offset, size);
+  };
+
+  ReadAheadWindow window(executor, fetcher, 1234, 9000, 1000, 2);
+  ASSERT_EQ(readAll(window, 1234, 4096), contents.substr(1234, 9000 - 1234));
+}
+
+TEST(ReadAhead, SkipAhead) {
+  Executor executor(2);
+  std::string contents = makeContents(10000);
+
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    memcpy(buffer, contents.data() + offset, size);
+  };
+
+  ReadAheadWindow window(executor, fetcher, 0, contents.size(), 100, 2);
+  std::vector<char> buffer(50);
+  ASSERT_EQ(window.read(0, buffer.data(), 50), 50);
+  ASSERT_EQ(window.read(5000, buffer.data(), 50), 50);
+  ASSERT_EQ(std::string(buffer.data(), 50), contents.substr(5000, 50));
+
+  // going back is not supported
+  ASSERT_EQ(window.read(0, buffer.data(), 50), -1);
+}
+
+TEST(ReadAhead, Failure) {
+  Executor executor(4);
+  std::string contents = makeContents(10000);
+
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    if(offset >= 5000) {
+      throw DavixException("test", StatusCode::InvalidServerResponse, "boom");
+    }
+    memcpy(buffer, contents.data() + offset, size);
+  };
+
+  ReadAheadWindow window(executor, fetcher, 0, contents.size(), 1000, 4);
+  std::vector<char> buffer(3000);
+  ASSERT_EQ(window.read(0, buffer.data(), 3000), 3000);
+
+  // short read up to the failed block, then an error
+  ASSERT_EQ(window.read(3000, buffer.data(), 3000), 2000);
+  ASSERT_EQ(std::string(buffer.data(), 2000), contents.substr(3000, 2000));
+  ASSERT_EQ(window.read(5000, buffer.data(), 3000), -1);
+}
+
+TEST(ReadAhead, GrowsWithLatency) {
+  Executor executor(16);
+  std::string contents = makeContents(64 * 100);
+
+  // latency bound: more requests in flight means more throughput
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    memcpy(buffer, contents.data() + offset, size);
+  };
+
+  ReadAheadWindow window(executor, fetcher, 0, contents.size(), 100, 8);
+  ASSERT_EQ(window.getWindow(), 2u);
+  ASSERT_EQ(readAll(window, 0, 100), contents);
+  ASSERT_EQ(window.getWindow(), 8u);
+  ASSERT_GT(window.getStalls(), 0u);
+}
+
+TEST(ReadAhead, StopsWhenSaturated) {
+  Executor executor(16);
+  std::string contents = makeContents(64 * 100);
+  std::mutex link;
+
+  // bandwidth bound: fetches are serialized, a larger window can't help
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    std::lock_guard<std::mutex> lock(link);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    memcpy(buffer, contents.data() + offset, size);
+  };
+
+  // a noisy first measurement may let it grow once before noticing
+  ReadAheadWindow window(executor, fetcher, 0, contents.size(), 100, 8);
+  ASSERT_EQ(readAll(window, 0, 100), contents);
+  ASSERT_LT(window.getWindow(), 8u);
+}
+
+TEST(ReadAhead, DestroyWaitsForFetches) {
+  Executor executor(4);
+  std::string contents = makeContents(10000);
+  std::atomic<size_t> running(0);
+
+  ReadAheadWindow::Fetcher fetcher = [&](dav_off_t offset, dav_size_t size, char* buffer) {
+    running++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    memcpy(buffer, contents.data() + offset, size);
+    running--;
+  };
+
+  {
+    ReadAheadWindow window(executor, fetcher, 0, contents.size(), 1000, 4);
+    char c;
+    ASSERT_EQ(window.read(0, &c, 1), 1);
+  }
+
+  ASSERT_EQ(running, 0u);
+}
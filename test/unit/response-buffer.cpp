@@ -167,3 +167,65 @@ TEST_P(Response_Buffer, SeparateFeedAndConsume) {
   ASSERT_EQ(contents.size(), consumed);
   ASSERT_EQ(contents, reconstructed);
 }
+
+TEST_P(Response_Buffer, DirectTarget) {
+  ResponseBuffer buffer(GetParam());
+
+  std::string target;
+  target.resize(5);
+
+  // nothing buffered: bytes go straight to the target, the rest is buffered
+  ASSERT_TRUE(buffer.setDirectTarget( (char*) target.c_str(), 5u));
+  buffer.feed("abc", 3);
+  ASSERT_EQ(buffer.directSize(), 3u);
+  ASSERT_EQ(buffer.size(), 0u);
+
+  buffer.feed("defgh", 5);
+  ASSERT_EQ(buffer.directSize(), 5u);
+  ASSERT_EQ(buffer.size(), 3u);
+  ASSERT_EQ(buffer.releaseDirectTarget(), 5u);
+  ASSERT_EQ(target, "abcde");
+
+  // something buffered: ordering requires going through the buffer
+  ASSERT_FALSE(buffer.setDirectTarget( (char*) target.c_str(), 5u));
+  buffer.feed("ij", 2);
+  ASSERT_EQ(buffer.releaseDirectTarget(), 0u);
+
+  target.resize(10);
+  ASSERT_EQ(buffer.consume( (char*) target.c_str(), 10u), 5u);
+  ASSERT_EQ(target.substr(0, 5), "fghij");
+
+  // released target is left alone
+  ASSERT_TRUE(buffer.setDirectTarget( (char*) target.c_str(), 10u));
+  ASSERT_EQ(buffer.releaseDirectTarget(), 0u);
+  buffer.feed("xyz", 3);
+  ASSERT_EQ(target.substr(0, 5), "fghij");
+  ASSERT_EQ(buffer.size(), 3u);
+}
+
+TEST(ChunkPool, Recycle) {
+  ChunkPool pool(16, 2);
+  ASSERT_EQ(pool.idle(), 0u);
+
+  std::vector<char> a, b, c;
+  pool.acquire(a);
+  pool.acquire(b);
+  pool.acquire(c);
+  ASSERT_EQ(a.size(), 16u);
+
+  pool.release(a);
+  pool.release(b);
+  pool.release(c);
+  ASSERT_EQ(pool.idle(), 2u);
+
+  std::vector<char> d;
+  pool.acquire(d);
+  pool.acquire(d);
+  ASSERT_EQ(pool.idle(), 0u);
+  ASSERT_EQ(d.size(), 16u);
+
+  // foreign chunks are not taken
+  std::vector<char> e(8);
+  pool.release(e);
+  ASSERT_EQ(pool.idle(), 0u);
+}
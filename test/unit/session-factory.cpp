@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <davix.hpp>
 #include <neon/neonsessionfactory.hpp>
+#include <curl/CurlSessionFactory.hpp>
 #include <core/RedirectionResolver.hpp>
 
 using namespace Davix;
@@ -88,3 +89,32 @@ TEST(testRedirectCache, test_GET_HEAD){
     ASSERT_TRUE(f.redirectionResolve("GET", u) == url1);
     ASSERT_TRUE(f.redirectionResolve("HEAD", u) == url1);
 }
+
+
+TEST(CurlSessionFactory, Http2Engine){
+    CurlSessionFactory factory;
+    RequestParams params;
+    ASSERT_FALSE(params.getHttp2());
+
+    RequestParams http2;
+    http2.setHttp2(true);
+    ASSERT_TRUE(RequestParams(http2).getHttp2());
+
+    // HTTP/2 requests share one engine, started on first use
+    CurlMultiEngine* engine = factory.getMultiEngine(http2);
+    ASSERT_TRUE(engine != NULL);
+    ASSERT_EQ(engine, factory.getMultiEngine(http2));
+
+    if(getenv("DAVIX_CURL_EVENT_LOOP") == NULL) {
+        ASSERT_TRUE(factory.getMultiEngine(params) == NULL);
+    }
+}
+
+TEST(CurlSessionFactory, ShareHandle){
+    CurlSessionFactory factory;
+    ASSERT_TRUE(factory.getShareHandle() != NULL);
+    ASSERT_EQ(factory.getShareHandle(), factory.getShareHandle());
+
+    CurlSessionFactory other;
+    ASSERT_NE(factory.getShareHandle(), other.getShareHandle());
+}
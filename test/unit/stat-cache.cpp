@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <core/StatCache.hpp>
+
+#include <thread>
+
+using namespace Davix;
+
+static StatInfo makeInfo(dav_size_t size) {
+  StatInfo info;
+  info.size = size;
+  info.mode = 0100644;
+  return info;
+}
+
+TEST(StatCache, PutGet) {
+  StatCache cache(std::chrono::seconds(60), std::chrono::seconds(60));
+  StatInfo info;
+  std::string error;
+
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/file"), info, error), StatCache::Miss);
+
+  cache.put(Uri("https://example.org/dir/file"), makeInfo(123));
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/file"), info, error), StatCache::Hit);
+  ASSERT_EQ(info.size, 123u);
+
+  // trailing slashes and fragments don't matter, the rest does
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/file/"), info, error), StatCache::Hit);
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/file#frag"), info, error), StatCache::Hit);
+  ASSERT_EQ(cache.get(Uri("https://example.org:8443/dir/file"), info, error), StatCache::Miss);
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/file?version=2"), info, error), StatCache::Miss);
+}
+
+TEST(StatCache, NotFound) {
+  StatCache cache(std::chrono::seconds(60), std::chrono::seconds(60));
+  StatInfo info;
+  std::string error;
+
+  cache.putNotFound(Uri("https://example.org/missing"), "no such file");
+  ASSERT_EQ(cache.get(Uri("https://example.org/missing"), info, error), StatCache::NotFound);
+  ASSERT_EQ(error, "no such file");
+
+  // negative caching can be disabled on its own
+  cache.setTTL(std::chrono::seconds(60), std::chrono::seconds(0));
+  cache.putNotFound(Uri("https://example.org/other"), "no such file");
+  ASSERT_EQ(cache.get(Uri("https://example.org/other"), info, error), StatCache::Miss);
+}
+
+TEST(StatCache, Expiry) {
+  StatCache cache(std::chrono::seconds(1), std::chrono::seconds(1));
+  StatInfo info;
+  std::string error;
+
+  cache.put(Uri("https://example.org/file"), makeInfo(1));
+  ASSERT_EQ(cache.get(Uri("https://example.org/file"), info, error), StatCache::Hit);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_EQ(cache.get(Uri("https://example.org/file"), info, error), StatCache::Miss);
+  ASSERT_EQ(cache.size(), 0u);
+}
+
+TEST(StatCache, Listing) {
+  StatCache cache(std::chrono::seconds(60), std::chrono::seconds(60));
+  StatInfo info;
+  std::string error;
+
+  cache.putChild(Uri("https://example.org/dir/"), "a", makeInfo(1));
+  cache.putChild(Uri("https://example.org/dir"), "sub/", makeInfo(2));
+
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/a"), info, error), StatCache::Hit);
+  ASSERT_EQ(info.size, 1u);
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/sub"), info, error), StatCache::Hit);
+  ASSERT_EQ(info.size, 2u);
+}
+
+TEST(StatCache, Invalidate) {
+  StatCache cache(std::chrono::seconds(60), std::chrono::seconds(60));
+  StatInfo info;
+  std::string error;
+
+  cache.put(Uri("https://example.org/dir"), makeInfo(0));
+  cache.put(Uri("https://example.org/dir/sub"), makeInfo(0));
+  cache.put(Uri("https://example.org/dir/sub/file"), makeInfo(1));
+  cache.put(Uri("https://example.org/dir/subway"), makeInfo(2));
+  cache.putNotFound(Uri("https://example.org/dir/new"), "no such file");
+
+  // the resource, its parent, and its children go away
+  cache.invalidate(Uri("https://example.org/dir/sub/"));
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/sub"), info, error), StatCache::Miss);
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/sub/file"), info, error), StatCache::Miss);
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir"), info, error), StatCache::Miss);
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/subway"), info, error), StatCache::Hit);
+
+  // creating a resource forgets it was missing
+  cache.invalidate(Uri("https://example.org/dir/new"));
+  ASSERT_EQ(cache.get(Uri("https://example.org/dir/new"), info, error), StatCache::Miss);
+}
+
+TEST(StatCache, Disabled) {
+  StatCache cache(std::chrono::seconds(0), std::chrono::seconds(60));
+  StatInfo info;
+  std::string error;
+  ASSERT_FALSE(cache.isEnabled());
+
+  cache.put(Uri("https://example.org/file"), makeInfo(1));
+  cache.putNotFound(Uri("https://example.org/missing"), "no such file");
+  ASSERT_EQ(cache.size(), 0u);
+}
+
+TEST(StatCache, MaxEntries) {
+  StatCache cache(std::chrono::seconds(60), std::chrono::seconds(60), 10);
+
+  for(int i = 0; i < 100; i++) {
+    cache.put(Uri("https://example.org/file" + std::to_string(i)), makeInfo(i));
+    ASSERT_LE(cache.size(), 10u);
+  }
+}
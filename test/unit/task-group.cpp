@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <core/Executor.hpp>
+#include <core/TaskGroup.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+using namespace Davix;
+
+TEST(TaskGroup, RunsEverything) {
+  Executor executor(4);
+  std::atomic<int> counter(0);
+
+  TaskGroup group(executor, 3);
+  for(int i = 0; i < 1000; i++) {
+    group.add([&counter]() { counter++; });
+  }
+
+  group.wait();
+  ASSERT_EQ(counter, 1000);
+  ASSERT_LE(executor.getThreadCount(), 3u);
+}
+
+TEST(TaskGroup, NoHelpers) {
+  Executor executor(4);
+  std::atomic<int> counter(0);
+  const std::thread::id caller = std::this_thread::get_id();
+
+  TaskGroup group(executor, 0);
+  for(int i = 0; i < 10; i++) {
+    group.add([&]() {
+      ASSERT_EQ(std::this_thread::get_id(), caller);
+      counter++;
+    });
+  }
+
+  group.wait();
+  ASSERT_EQ(counter, 10);
+  ASSERT_EQ(executor.getThreadCount(), 0u);
+}
+
+TEST(TaskGroup, TasksAddTasks) {
+  Executor executor(2);
+  std::atomic<int> counter(0);
+  TaskGroup group(executor, 2);
+
+  std::function<void (int)> spawn = [&](int depth) {
+    counter++;
+    if(depth > 0) {
+      group.add([&spawn, depth]() { spawn(depth - 1); });
+      group.add([&spawn, depth]() { spawn(depth - 1); });
+    }
+  };
+
+  group.add([&spawn]() { spawn(5); });
+  group.wait();
+  ASSERT_EQ(counter, 63);
+}
+
+TEST(TaskGroup, FailureDropsQueued) {
+  Executor executor(1);
+  std::atomic<int> counter(0);
+
+  TaskGroup group(executor, 0);
+  group.add([&counter]() { counter++; });
+  group.add([]() { throw std::runtime_error("boom"); });
+  group.add([&counter]() { counter++; });
+
+  ASSERT_THROW(group.wait(), std::runtime_error);
+  ASSERT_EQ(counter, 1);
+}
+
+TEST(TaskGroup, RunOrWait) {
+  Executor executor(1);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  // the only worker is busy
+  executor.submit([released]() { released.wait_for(std::chrono::seconds(10)); });
+
+  TaskGroup group(executor, 1);
+  std::thread::id ranOn;
+  TaskGroup::TaskId id = group.add([&ranOn]() { ranOn = std::this_thread::get_id(); });
+
+  group.runOrWait(id);
+  ASSERT_EQ(ranOn, std::this_thread::get_id());
+
+  // nothing left for the helper when it gets to run
+  release.set_value();
+  group.wait();
+}
+
+TEST(TaskGroup, FromBusyExecutor) {
+  Executor executor(1);
+  std::promise<int> result;
+
+  // the only worker waits on a group of its own
+  executor.submit([&executor, &result]() {
+    std::atomic<int> counter(0);
+    TaskGroup group(executor, 4);
+    for(int i = 0; i < 8; i++) {
+      group.add([&counter]() { counter++; });
+    }
+    group.wait();
+    result.set_value(counter);
+  });
+
+  std::future<int> done = result.get_future();
+  ASSERT_EQ(done.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(done.get(), 8);
+}
+
+TEST(TaskGroup, DestroyDropsQueued) {
+  Executor executor(1);
+  std::atomic<int> counter(0);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  executor.submit([released]() { released.wait_for(std::chrono::seconds(10)); });
+
+  {
+    TaskGroup group(executor, 1);
+    group.add([&counter]() { counter++; });
+  }
+
+  release.set_value();
+  ASSERT_EQ(counter, 0);
+}
+
+TEST(TaskGroup, DestroyWhileAdding) {
+  Executor executor(2);
+  std::atomic<int> counter(0);
+
+  {
+    TaskGroup group(executor, 1);
+    group.add([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      // too late, the group is being destroyed
+      group.add([&counter]() { counter++; });
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(counter, 0);
+}
@@ -9,10 +9,12 @@
 #include <xml/davpropxmlparser.hpp>
 #include <xml/metalinkparser.hpp>
 #include <xml/s3propparser.hpp>
+#include <xml/azurepropparser.hpp>
 #include <xml/S3MultiPartInitiationParser.hpp>
 #include <xml/swiftpropparser.hpp>
 #include <status/davixstatusrequest.hpp>
 #include <string.h>
+#include <sstream>
 #include <xml/davix_ptree.hpp>
 
 
@@ -439,6 +441,54 @@ TEST(XmlParserInstance,parserNonWebdav){
 }
 
 
+TEST(XMLParserInstance, ParseStreamed){
+    const std::string content =
+        "<?xml version=\"1.0\" encoding=\"utf-8\" ?>"
+        "<D:multistatus xmlns:D=\"DAV:\" xmlns:X=\"urn:x\">"
+        "<D:response><D:href>http://server/data/a%20b/</D:href>"
+        "<D:propstat><D:prop><D:resourcetype><D:collection/></D:resourcetype>"
+        "<X:extra><D:getcontentlength>999</D:getcontentlength></X:extra></D:prop>"
+        "<D:status>HTTP/1.1 200 OK</D:status></D:propstat></D:response>"
+        "<D:response><D:href>/data/file.root</D:href>"
+        "<D:propstat><D:prop><D:getcontentlength> 42 </D:getcontentlength>"
+        "<D:owner>1001</D:owner><D:quota-used-bytes>42</D:quota-used-bytes></D:prop>"
+        "<D:status>HTTP/1.1 200 OK</D:status></D:propstat>"
+        "<D:propstat><D:prop><D:getlastmodified/></D:prop>"
+        "<D:status>HTTP/1.1 404 Not Found</D:status></D:propstat></D:response>"
+        "<D:response><D:href>/data/other</D:href>"
+        "<D:propstat><D:prop><D:getcontentlength>7</D:getcontentlength></D:prop>"
+        "<D:status>HTTP/1.1 200 OK</D:status></D:propstat></D:response>"
+        "</D:multistatus>";
+
+    // one byte at a time, taking the entries as soon as they are complete
+    Davix::DavPropXMLParser parser;
+    std::vector<Davix::FileProperties> props;
+    for(size_t i = 0; i < content.size(); i++){
+        parser.parseChunk(content.c_str() + i, 1);
+        while(parser.getProperties().size() > 0){
+            props.push_back(parser.getProperties().front());
+            parser.getProperties().pop_front();
+        }
+    }
+    parser.parseChunk(NULL, 0);
+
+    ASSERT_EQ(3u, props.size());
+    ASSERT_EQ("a b", props[0].filename);
+    ASSERT_TRUE(S_ISDIR(props[0].info.mode));
+    ASSERT_EQ(0, props[0].info.size); // not a property of the resource
+
+    ASSERT_EQ("file.root", props[1].filename);
+    ASSERT_TRUE(S_ISREG(props[1].info.mode));
+    ASSERT_EQ(42, props[1].info.size);
+    ASSERT_EQ(1001u, props[1].info.owner);
+    ASSERT_EQ(42u, props[1].quota.used_bytes);
+
+    ASSERT_EQ("other", props[2].filename);
+    ASSERT_EQ(7, props[2].info.size);
+    ASSERT_EQ(0u, props[2].quota.used_bytes);
+}
+
+
 TEST(XmlPaserInstance, destroyPartial){
     davix_set_log_level(DAVIX_LOG_ALL);
     Davix::DavPropXMLParser* parser = new Davix::DavPropXMLParser();
@@ -594,6 +644,45 @@ TEST(XmlS3parsing, TestListingBucket){
     ASSERT_EQ(19558, parser.getProperties().at(2).info.size);
 }
 
+TEST(XmlS3parsing, TestNextMarker){
+    using namespace Davix;
+
+    S3PropParser complete;
+    ASSERT_EQ(0, complete.parseChunk(s3_xml_response));
+    ASSERT_EQ(std::string(), complete.getNextMarker());
+
+    // NextMarker is known before any entry
+    S3PropParser explicitMarker(S3ListingMode::Hierarchical, "/dir/");
+    ASSERT_EQ(0, explicitMarker.parseChunk("<?xml version=\"1.0\" encoding=\"UTF-8\"?><ListBucketResult><Name>bucket</Name>"
+        "<Prefix>dir/</Prefix><Marker></Marker><NextMarker>dir/b</NextMarker><IsTruncated>true</IsTruncated>"));
+    ASSERT_EQ(std::string("dir/b"), explicitMarker.getNextMarker());
+
+    // otherwise, the last key or common prefix once the page is complete
+    S3PropParser lastKey(S3ListingMode::Flat, "");
+    ASSERT_EQ(0, lastKey.parseChunk("<?xml version=\"1.0\" encoding=\"UTF-8\"?><ListBucketResult><Name>bucket</Name>"
+        "<IsTruncated>true</IsTruncated><Contents><Key>a</Key></Contents><Contents><Key>c</Key></Contents>"
+        "<CommonPrefixes><Prefix>b/</Prefix></CommonPrefixes>"));
+    ASSERT_EQ(std::string(), lastKey.getNextMarker());
+    ASSERT_EQ(0, lastKey.parseChunk("</ListBucketResult>"));
+    ASSERT_EQ(std::string("c"), lastKey.getNextMarker());
+}
+
+TEST(XmlAzureParsing, TestNextMarker){
+    using namespace Davix;
+
+    AzurePropParser parser("/");
+    ASSERT_EQ(0, parser.parseChunk("<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults ContainerName=\"c\">"
+        "<Blobs><Blob><Name>a</Name><Properties><Content-Length>12</Content-Length></Properties></Blob></Blobs>"
+        "<NextMarker>2!80!MDAwMDE1IWEvYiEwMDAwMjghOTk5OS0xMi0zMVQyMzo1OTo1OS45OTk5OTk5Wg--</NextMarker></EnumerationResults>"));
+    ASSERT_EQ(1u, parser.getProperties().size());
+    ASSERT_EQ(std::string("2!80!MDAwMDE1IWEvYiEwMDAwMjghOTk5OS0xMi0zMVQyMzo1OTo1OS45OTk5OTk5Wg--"), parser.getNextMarker());
+
+    AzurePropParser last("/");
+    ASSERT_EQ(0, last.parseChunk("<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults ContainerName=\"c\">"
+        "<Blobs><Blob><Name>a</Name></Blob></Blobs><NextMarker /></EnumerationResults>"));
+    ASSERT_EQ(std::string(), last.getNextMarker());
+}
+
 TEST(XmlMultiPartUploadInitiationResponse, BasicSanity) {
     using namespace Davix;
 
@@ -623,4 +712,31 @@ TEST(XmlSwiftParsing, TestListingDir) {
 
     // verify size
     ASSERT_EQ(2906, parser.getProperties().at(1).info.size);
-}
\ No newline at end of file
+}
+
+TEST(XmlSwiftParsing, TestNextMarker) {
+    using namespace Davix;
+
+    // any page but an empty one may have a next one, the server limit is not known
+    SwiftPropParser small;
+    ASSERT_EQ(0, small.parseChunk(swift_xml_response));
+    ASSERT_EQ(std::string("photos/plants/"), small.getNextMarker());
+
+    // the last name is the marker of the next page, once the page is complete
+    std::ostringstream ss;
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?><container name=\"c\">";
+    for(int i = 0; i < 1000; i++) {
+        ss << "<object><name>obj" << 10000 + i << "</name><bytes>1</bytes></object>";
+    }
+
+    SwiftPropParser page;
+    ASSERT_EQ(0, page.parseChunk(ss.str()));
+    ASSERT_EQ(std::string(), page.getNextMarker());
+    ASSERT_EQ(0, page.parseChunk("</container>"));
+    ASSERT_EQ(std::string("obj10999"), page.getNextMarker());
+
+    // an empty page ends the listing
+    SwiftPropParser empty;
+    ASSERT_EQ(0, empty.parseChunk("<?xml version=\"1.0\" encoding=\"UTF-8\"?><container name=\"c\"></container>"));
+    ASSERT_EQ(std::string(), empty.getNextMarker());
+}